@@ -101,6 +101,38 @@ static bool			is_log_enabled = false;
 struct flock			lk;
 #endif /* _WIN32 */
 
+/** stdio buffer for the input file when it is only being read.
+The default buffer of st_blksize bytes would issue a read() system call
+for every page or two; a bigger buffer lets the kernel serve the
+sequential scan with far fewer, larger requests. */
+static char			read_buffer[4 << 20];
+
+/** Number of threads that check the pages for corruption (--parallel) */
+static ulong			n_threads;
+/** Maximum value of --parallel */
+static const ulong		MAX_THREADS = 64;
+/** Size of a batch of pages in bytes */
+static const ulint		BATCH_SIZE = 16 << 20;
+
+/** Pages that were read ahead and checked for corruption in n_threads
+threads, when the file is only being verified (--parallel) */
+static struct {
+	/** the pages, aligned to UNIV_PAGE_SIZE_MAX */
+	byte*		pages;
+	/** whether is_page_corrupted() held for each page */
+	bool*		corrupted;
+	/** number of complete pages in the batch */
+	ulint		n_pages;
+	/** number of bytes of an incomplete page after them */
+	ulint		tail;
+	/** the next page to be processed */
+	ulint		next;
+	/** true if the tablespace is encrypted */
+	bool		is_encrypted;
+	/** tablespace flags */
+	ulint		flags;
+} batch;
+
 /* Strict check algorithm name. */
 static ulong			strict_check;
 /* Rewrite checksum algorithm name. */
@@ -387,6 +419,17 @@ open_file(
 		fil_in = fdopen(fd, "rb+");
 	} else {
 		fil_in = fdopen(fd, "rb");
+		/* When rewriting, every page is read and then written
+		back in place, so read ahead would only be discarded
+		by fsetpos(). A plain verification scans the file
+		from start to end. */
+		if (fil_in) {
+			setvbuf(fil_in, read_buffer, _IOFBF,
+				sizeof read_buffer);
+#ifdef POSIX_FADV_SEQUENTIAL
+			posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif /* POSIX_FADV_SEQUENTIAL */
+		}
 	}
 
 	return (fil_in);
@@ -1251,6 +1294,10 @@ static struct my_option innochecksum_options[] = {
     &do_leaf, &do_leaf, 0, GET_BOOL, NO_ARG, 0, 0, 0, 0, 0, 0},
   {"merge", 'm', "leaf page count if merge given number of consecutive pages",
    &n_merge, &n_merge, 0, GET_ULONG, REQUIRED_ARG, 0, 0, (longlong)10L, 0, 1, 0},
+  {"parallel", 'T', "Number of threads that verify the page checksums. "
+   "Ignored with --write or --log.",
+   &n_threads, &n_threads, 0, GET_ULONG, REQUIRED_ARG, 1, 1,
+   (longlong) MAX_THREADS, 0, 1, 0},
 
   {0, 0, 0, 0, 0, 0, GET_NO_ARG, NO_ARG, 0, 0, 0, 0, 0, 0}
 };
@@ -1277,7 +1324,7 @@ static void usage(void)
 	printf("Usage: %s [-c] [-s <start page>] [-e <end page>] "
 		"[-p <page>] [-i] [-v]  [-a <allow mismatches>] [-n] "
 		"[-C <strict-check>] [-w <write>] [-S] [-D <page type dump>] "
-		"[-l <log>] [-l] [-m <merge pages>] <filename or [-]>\n", my_progname);
+		"[-l <log>] [-l] [-m <merge pages>] [-T <threads>] <filename or [-]>\n", my_progname);
 	printf("See " REFMAN "innochecksum.html for usage hints.\n");
 	my_print_help(innochecksum_options);
 	my_print_variables(innochecksum_options);
@@ -1433,6 +1480,30 @@ static bool check_encryption(const char* filename, const byte* page)
 	return (type == CRYPT_SCHEME_1);
 }
 
+/** Report a page that failed the checksum verification.
+@param[in,out] mismatch_count	Number of pages failed in checksum verify
+@retval 0 if the mismatch is allowed or 1 if there are too many */
+static int count_mismatch(unsigned long long* mismatch_count)
+{
+	fprintf(stderr, "Fail: page::%llu invalid\n", cur_page_num);
+
+	(*mismatch_count)++;
+
+	if (*mismatch_count > allow_mismatches) {
+		fprintf(stderr,
+			"Exceeded the "
+			"maximum allowed "
+			"checksum mismatch "
+			"count::%llu current::%llu\n",
+			*mismatch_count,
+			allow_mismatches);
+
+		return (1);
+	}
+
+	return (0);
+}
+
 /** Verify page checksum.
 @param[in] buf			page to verify
 @param[in] zip_size		ROW_FORMAT=COMPRESSED page size, or 0
@@ -1446,27 +1517,183 @@ static int verify_checksum(
 	unsigned long long*	mismatch_count,
 	ulint			flags)
 {
-	int exit_status = 0;
-	if (is_page_corrupted(buf, is_encrypted, flags)) {
-		fprintf(stderr, "Fail: page::%llu invalid\n",
-			cur_page_num);
+	return(is_page_corrupted(buf, is_encrypted, flags)
+	       ? count_mismatch(mismatch_count) : 0);
+}
 
-		(*mismatch_count)++;
+/** Threads that check the pages of each batch for corruption,
+along with the thread that reads the batches */
+static struct {
+	/** protects the fields below */
+	pthread_mutex_t	mutex;
+	/** signalled when a batch has been read, or at shutdown */
+	pthread_cond_t	start;
+	/** signalled when the threads have checked the batch */
+	pthread_cond_t	done;
+	/** the threads */
+	pthread_t	threads[MAX_THREADS];
+	/** number of threads */
+	ulint		n;
+	/** number of batches that have been read */
+	ulint		generation;
+	/** number of threads that are checking the current batch */
+	ulint		n_busy;
+	/** whether the threads must exit */
+	bool		shutdown;
+} workers;
+
+/** Check a part of the batch for corruption.
+@param[in]	slice	the part: 0 for the reading thread,
+			or 1 to workers.n for the other threads */
+static void batch_verify(ulint slice)
+{
+	const ulint n_slices = workers.n + 1;
+	const ulint per_slice = (batch.n_pages + n_slices - 1) / n_slices;
+	const ulint end = std::min((slice + 1) * per_slice, batch.n_pages);
+
+	for (ulint i = slice * per_slice; i < end; i++) {
+		batch.corrupted[i] = is_page_corrupted(
+			batch.pages + i * physical_page_size,
+			batch.is_encrypted, batch.flags);
+	}
+}
 
-		if (*mismatch_count > allow_mismatches) {
-			fprintf(stderr,
-				"Exceeded the "
-				"maximum allowed "
-				"checksum mismatch "
-				"count::%llu current::%llu\n",
-				*mismatch_count,
-				allow_mismatches);
+/** Check each batch for corruption, until workers_stop() is called.
+@param[in]	arg	the part of the batches to check
+@return NULL */
+static void* batch_verify_thread(void* arg)
+{
+	const ulint	slice = ulint(reinterpret_cast<size_t>(arg));
+	ulint		generation = 0;
 
-			exit_status = 1;
+	pthread_mutex_lock(&workers.mutex);
+
+	for (;;) {
+		while (workers.generation == generation
+		       && !workers.shutdown) {
+			pthread_cond_wait(&workers.start, &workers.mutex);
+		}
+
+		if (workers.shutdown) {
+			break;
+		}
+
+		generation = workers.generation;
+		pthread_mutex_unlock(&workers.mutex);
+
+		batch_verify(slice);
+
+		pthread_mutex_lock(&workers.mutex);
+		if (!--workers.n_busy) {
+			pthread_cond_signal(&workers.done);
+		}
+	}
+
+	pthread_mutex_unlock(&workers.mutex);
+	return(NULL);
+}
+
+/** Start the n_threads - 1 threads that check the batches along with
+the reading thread. If fewer threads can be created, the batches are
+divided among those. */
+static void workers_start()
+{
+	pthread_mutex_init(&workers.mutex, NULL);
+	pthread_cond_init(&workers.start, NULL);
+	pthread_cond_init(&workers.done, NULL);
+
+	for (workers.n = 0; workers.n < n_threads - 1; workers.n++) {
+		if (pthread_create(&workers.threads[workers.n], NULL,
+				   batch_verify_thread,
+				   reinterpret_cast<void*>(
+					   size_t(workers.n + 1)))) {
+			break;
 		}
 	}
+}
+
+/** Stop the threads that were started by workers_start(). */
+static void workers_stop()
+{
+	pthread_mutex_lock(&workers.mutex);
+	workers.shutdown = true;
+	pthread_cond_broadcast(&workers.start);
+	pthread_mutex_unlock(&workers.mutex);
+
+	for (ulint i = 0; i < workers.n; i++) {
+		pthread_join(workers.threads[i], NULL);
+	}
 
-	return (exit_status);
+	pthread_cond_destroy(&workers.done);
+	pthread_cond_destroy(&workers.start);
+	pthread_mutex_destroy(&workers.mutex);
+}
+
+/** Read the next batch of pages and check them for corruption
+in this thread and the threads of workers_start().
+@param[in,out]	fil_in		input file
+@param[in]	max_pages	maximum number of pages to read */
+static void batch_read(FILE* fil_in, unsigned long long max_pages)
+{
+	ulint	n = BATCH_SIZE / physical_page_size;
+
+	if (n > max_pages) {
+		n = ulint(max_pages);
+	}
+
+	ulint bytes = ulint(fread(batch.pages, 1, n * physical_page_size,
+				  fil_in));
+
+	batch.n_pages = bytes / physical_page_size;
+	batch.tail = bytes % physical_page_size;
+	batch.next = 0;
+
+	pthread_mutex_lock(&workers.mutex);
+	workers.generation++;
+	workers.n_busy = workers.n;
+	pthread_cond_broadcast(&workers.start);
+	pthread_mutex_unlock(&workers.mutex);
+
+	batch_verify(0);
+
+	pthread_mutex_lock(&workers.mutex);
+	while (workers.n_busy) {
+		pthread_cond_wait(&workers.done, &workers.mutex);
+	}
+	pthread_mutex_unlock(&workers.mutex);
+}
+
+/** Get the next page of the batch, and read the next batch if needed.
+@param[in,out]	fil_in		input file
+@param[in]	max_pages	maximum number of pages to read
+@param[out]	page		the page
+@param[out]	corrupted	whether the page is corrupted
+@return number of bytes of the page that were read */
+static ulint batch_next(
+	FILE*			fil_in,
+	unsigned long long	max_pages,
+	byte**			page,
+	bool*			corrupted)
+{
+	if (batch.next == batch.n_pages) {
+		if (!batch.tail) {
+			batch_read(fil_in, max_pages);
+		}
+
+		if (batch.next == batch.n_pages) {
+			/* An incomplete page at the end of the file */
+			ulint	bytes = batch.tail;
+			*page = batch.pages + batch.n_pages
+				* physical_page_size;
+			*corrupted = false;
+			batch.tail = 0;
+			return(bytes);
+		}
+	}
+
+	*page = batch.pages + batch.next * physical_page_size;
+	*corrupted = batch.corrupted[batch.next++];
+	return(physical_page_size);
 }
 
 /** Rewrite page checksum if needed.
@@ -1506,6 +1733,7 @@ int main(
 	/* Buffer to store pages read. */
 	byte*		buf_ptr = NULL;
 	byte*		xdes_ptr = NULL;
+	byte*		batch_ptr = NULL;
 	byte*		buf = NULL;
 	byte*		xdes = NULL;
 	/* bytes read count */
@@ -1595,6 +1823,14 @@ int main(
 	buf = (byte *) ut_align(buf_ptr, UNIV_PAGE_SIZE_MAX);
 	xdes = (byte *) ut_align(xdes_ptr, UNIV_PAGE_SIZE_MAX);
 
+	if (n_threads > 1) {
+		batch_ptr = (byte*) malloc(BATCH_SIZE + UNIV_PAGE_SIZE_MAX);
+		batch.pages = (byte*) ut_align(batch_ptr, UNIV_PAGE_SIZE_MAX);
+		batch.corrupted = (bool*) malloc(BATCH_SIZE
+						 / UNIV_ZIP_SIZE_MIN);
+		workers_start();
+	}
+
 	/* The file name is not optional. */
 	for (int i = 0; i < argc; ++i) {
 
@@ -1603,6 +1839,7 @@ int main(
 		memset(&page_type, 0, sizeof(innodb_page_type));
 		partial_page_read = false;
 		skip_page = false;
+		batch.n_pages = batch.next = batch.tail = 0;
 
 		if (is_log_enabled) {
 			fprintf(log_file, "Filename = %s\n", filename);
@@ -1828,10 +2065,32 @@ int main(
 		cur_page_num = start_page ? start_page : cur_page_num + 1;
 
 		lastt = 0;
-		while (!feof(fil_in)) {
 
-			bytes = read_file(buf, partial_page_read,
-					  physical_page_size, fil_in);
+		/* When the pages are only being verified, read them in
+		batches and check each batch in n_threads threads. The
+		results are reported page by page in this thread, in
+		the same order as without --parallel. */
+		const bool parallel = n_threads > 1 && !do_write
+			&& !is_log_enabled && !partial_page_read;
+		batch.is_encrypted = is_encrypted;
+		batch.flags = flags;
+
+		while (!feof(fil_in) || batch.next < batch.n_pages
+		       || batch.tail) {
+			byte*	page = buf;
+			bool	corrupted = false;
+
+			if (parallel) {
+				bytes = batch_next(
+					fil_in,
+					!use_end_page ? ULLONG_MAX
+					: cur_page_num > end_page ? 1
+					: end_page - cur_page_num + 1,
+					&page, &corrupted);
+			} else {
+				bytes = read_file(buf, partial_page_read,
+						  physical_page_size, fil_in);
+			}
 			partial_page_read = false;
 
 			if (!bytes && feof(fil_in)) {
@@ -1857,12 +2116,12 @@ int main(
 
 			if (is_system_tablespace) {
 				/* enable when page is double write buffer.*/
-				skip_page = is_page_doublewritebuffer(buf);
+				skip_page = is_page_doublewritebuffer(page);
 			} else {
 				skip_page = false;
 			}
 
-			ulint cur_page_type = mach_read_from_2(buf+FIL_PAGE_TYPE);
+			ulint cur_page_type = mach_read_from_2(page+FIL_PAGE_TYPE);
 
 			/* FIXME: Page compressed or Page compressed and encrypted
 			pages do not contain checksum. */
@@ -1875,14 +2134,16 @@ int main(
 			checksum verification.*/
 			if (!no_check
 			    && !skip_page
-			    && (exit_status = verify_checksum(
-						buf, is_encrypted,
-						&mismatch_count, flags))) {
+			    && (parallel
+				? corrupted
+				: is_page_corrupted(page, is_encrypted, flags))
+			    && (exit_status = count_mismatch(
+						&mismatch_count))) {
 				goto my_exit;
 			}
 
 			if ((exit_status = rewrite_checksum(
-						filename, fil_in, buf,
+						filename, fil_in, page,
 						&pos, is_encrypted, flags))) {
 				goto my_exit;
 			}
@@ -1897,7 +2158,7 @@ int main(
 			}
 
 			if (page_type_summary || page_type_dump) {
-				parse_page(buf, xdes, fil_page_type, is_encrypted);
+				parse_page(page, xdes, fil_page_type, is_encrypted);
 			}
 
 			/* do counter increase and progress printing */
@@ -1944,6 +2205,12 @@ int main(
 
 	free(buf_ptr);
 	free(xdes_ptr);
+	if (batch_ptr) {
+		workers_stop();
+	}
+
+	free(batch_ptr);
+	free(batch.corrupted);
 
 	my_end(exit_status);
 	DBUG_RETURN(exit_status);
@@ -1957,6 +2224,13 @@ int main(
 		free(xdes_ptr);
 	}
 
+	if (batch_ptr) {
+		workers_stop();
+	}
+
+	free(batch_ptr);
+	free(batch.corrupted);
+
 	if (!read_from_stdin && fil_in) {
 		fclose(fil_in);
 	}
@@ -351,6 +351,7 @@ get_mysql_vars(MYSQL *connection)
 	char *innodb_page_size_var = NULL;
 	char *innodb_undo_tablespaces_var = NULL;
 	char *page_zip_level_var = NULL;
+	char *innodb_track_changed_pages_var = NULL;
 	char *endptr;
 	unsigned long server_version = mysql_get_server_version(connection);
 
@@ -379,6 +380,8 @@ get_mysql_vars(MYSQL *connection)
 		{"innodb_page_size", &innodb_page_size_var},
 		{"innodb_undo_tablespaces", &innodb_undo_tablespaces_var},
 		{"innodb_compression_level", &page_zip_level_var},
+		{"innodb_track_changed_pages",
+			&innodb_track_changed_pages_var},
 		{NULL, NULL}
 	};
 
@@ -436,6 +439,13 @@ get_mysql_vars(MYSQL *connection)
 		goto out;
 	}
 
+	/* MariaDB 10.4 and later write the changed page bitmaps
+	when innodb_track_changed_pages=ON */
+	if (xtrabackup_incremental && innodb_track_changed_pages_var
+	    && !strcmp(innodb_track_changed_pages_var, "ON")) {
+		have_changed_page_bitmaps = true;
+	}
+
 	/* make sure datadir value is the same in configuration file */
 	if (check_if_param_set("datadir")) {
 		if (!directory_exists(mysql_data_home, false)) {
@@ -1620,7 +1630,11 @@ flush_changed_page_bitmaps()
 	if (xtrabackup_incremental && have_changed_page_bitmaps &&
 	    !xtrabackup_incremental_force_scan) {
 		xb_mysql_query(mysql_connection,
-			"FLUSH NO_WRITE_TO_BINLOG CHANGED_PAGE_BITMAPS", false);
+			server_flavor == FLAVOR_MARIADB
+			&& mysql_server_version >= 100400
+			? "SET GLOBAL innodb_flush_changed_page_bitmaps=ON"
+			: "FLUSH NO_WRITE_TO_BINLOG CHANGED_PAGE_BITMAPS",
+			false);
 	}
 	return(true);
 }
@@ -246,14 +246,26 @@ log_online_is_bitmap_file(
 }
 
 /*********************************************************************//**
-List the bitmap files in srv_data_home and setup their range that contains the
-specified LSN interval.  This range, if non-empty, will start with a file that
-has the greatest LSN equal to or less than the start LSN and will include all
-the files up to the one with the greatest LSN less than the end LSN.  Caller
-must free bitmap_files->files when done if bitmap_files set to non-NULL and
-this function returned TRUE.  Field bitmap_files->count might be set to a
-larger value than the actual count of the files, and space for the unused array
-slots will be allocated but cleared to zeroes.
+The server writes the bitmap files to innodb_data_home_dir, or to the datadir
+(the current directory) if innodb_data_home_dir is empty.
+
+@return the directory of the bitmap files */
+static
+const char*
+log_online_bitmap_dir()
+{
+	return(*srv_data_home ? srv_data_home : ".");
+}
+
+/*********************************************************************//**
+List the bitmap files in log_online_bitmap_dir() and setup their range that
+contains the specified LSN interval.  This range, if non-empty, will start
+with a file that has the greatest LSN equal to or less than the start LSN and
+will include all the files up to the one with the greatest LSN less than the
+end LSN.  Caller must free bitmap_files->files when done if bitmap_files set
+to non-NULL and this function returned TRUE.  Field bitmap_files->count might
+be set to a larger value than the actual count of the files, and space for the
+unused array slots will be allocated but cleared to zeroes.
 
 @return TRUE if succeeded
 */
@@ -279,15 +291,15 @@ log_online_setup_bitmap_file_range(
 
 	/* 1st pass: size the info array */
 
-	bitmap_dir = os_file_opendir(srv_data_home, FALSE);
+	bitmap_dir = os_file_opendir(log_online_bitmap_dir(), FALSE);
 	if (UNIV_UNLIKELY(!bitmap_dir)) {
 
 		msg("InnoDB: Error: failed to open bitmap directory \'%s\'",
-		    srv_data_home);
+		    log_online_bitmap_dir());
 		return FALSE;
 	}
 
-	while (!os_file_readdir_next_file(srv_data_home, bitmap_dir,
+	while (!os_file_readdir_next_file(log_online_bitmap_dir(), bitmap_dir,
 					  &bitmap_dir_file_info)) {
 
 		ulong	file_seq_num;
@@ -332,7 +344,8 @@ log_online_setup_bitmap_file_range(
 	if (UNIV_UNLIKELY(os_file_closedir(bitmap_dir))) {
 
 		os_file_get_last_error(TRUE);
-		msg("InnoDB: Error: cannot close \'%s\'",srv_data_home);
+		msg("InnoDB: Error: cannot close \'%s\'",
+		    log_online_bitmap_dir());
 		return FALSE;
 	}
 
@@ -346,11 +359,11 @@ log_online_setup_bitmap_file_range(
 
 	/* 2nd pass: get the file names in the file_seq_num order */
 
-	bitmap_dir = os_file_opendir(srv_data_home, FALSE);
+	bitmap_dir = os_file_opendir(log_online_bitmap_dir(), FALSE);
 	if (UNIV_UNLIKELY(!bitmap_dir)) {
 
 		msg("InnoDB: Error: failed to open bitmap directory \'%s\'",
-		    srv_data_home);
+		    log_online_bitmap_dir());
 		return FALSE;
 	}
 
@@ -360,7 +373,7 @@ log_online_setup_bitmap_file_range(
 	memset(bitmap_files->files, 0,
 	       bitmap_files->count * sizeof(bitmap_files->files[0]));
 
-	while (!os_file_readdir_next_file(srv_data_home, bitmap_dir,
+	while (!os_file_readdir_next_file(log_online_bitmap_dir(), bitmap_dir,
 					  &bitmap_dir_file_info)) {
 
 		ulong	file_seq_num;
@@ -401,7 +414,8 @@ log_online_setup_bitmap_file_range(
 	if (UNIV_UNLIKELY(os_file_closedir(bitmap_dir))) {
 
 		os_file_get_last_error(TRUE);
-		msg("InnoDB: Error: cannot close \'%s\'", srv_data_home);
+		msg("InnoDB: Error: cannot close \'%s\'",
+		    log_online_bitmap_dir());
 		free(bitmap_files->files);
 		return FALSE;
 	}
@@ -435,7 +449,7 @@ log_online_open_bitmap_file_read_only(
 	const char*			name,		/*!<in: bitmap file
 							name without directory,
 							which is assumed to be
-							srv_data_home */
+							log_online_bitmap_dir() */
 	log_online_bitmap_file_t*	bitmap_file)	/*!<out: opened bitmap
 							file */
 {
@@ -443,7 +457,8 @@ log_online_open_bitmap_file_read_only(
 
 	xb_ad(name[0] != '\0');
 
-	snprintf(bitmap_file->name, FN_REFLEN, "%s%s", srv_data_home, name);
+	snprintf(bitmap_file->name, FN_REFLEN, "%s%c%s",
+		 log_online_bitmap_dir(), OS_PATH_SEPARATOR, name);
 	bitmap_file->file = os_file_create_simple_no_error_handling(
 		0, bitmap_file->name,
 		OS_FILE_OPEN, OS_FILE_READ_ONLY, true, &success);
@@ -812,6 +827,23 @@ xb_page_bitmap_init(void)
 			return NULL;
 		}
 
+		/* A run that starts after the end of the previous one means
+		that the server did not track the changes in between, for
+		example because it was killed before writing them out. */
+		if (UNIV_UNLIKELY(mach_read_from_8(page
+						   + MODIFIED_PAGE_START_LSN)
+				  > current_page_end_lsn)) {
+
+			xb_msg_missing_lsn_data(current_page_end_lsn,
+						mach_read_from_8(
+							page
+							+ MODIFIED_PAGE_START_LSN));
+			rbt_free(result);
+			free(bitmap_files.files);
+			os_file_close(bitmap_file.file);
+			return NULL;
+		}
+
 		/* Merge the current page with an existing page or insert a new
 		page into the tree */
 
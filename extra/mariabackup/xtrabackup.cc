@@ -4246,6 +4246,17 @@ static bool xtrabackup_backup_func()
 	if (!flush_changed_page_bitmaps()) {
 		goto fail;
 	}
+
+	if (have_changed_page_bitmaps && !xtrabackup_incremental_force_scan) {
+		changed_page_bitmap = xb_page_bitmap_init();
+		if (!changed_page_bitmap) {
+			msg("mariabackup: using the full scan for incremental "
+			    "backup");
+		} else {
+			msg("mariabackup: using the changed page bitmaps for "
+			    "incremental backup");
+		}
+	}
 	debug_sync_point("xtrabackup_suspend_at_start");
 
 
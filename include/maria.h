@@ -300,6 +300,8 @@ extern int maria_rrnd(MARIA_HA *file, uchar *buf,
                       MARIA_RECORD_POS pos);
 extern int maria_scan_init(MARIA_HA *file);
 extern int maria_scan(MARIA_HA *file, uchar *buf);
+extern int maria_scan_batch(MARIA_HA *file, uchar *buf, size_t reclength,
+                            uint max_rows, uint *rows);
 extern void maria_scan_end(MARIA_HA *file);
 extern int maria_rsame(MARIA_HA *file, uchar *record, int inx);
 extern int maria_rsame_with_pos(MARIA_HA *file, uchar *record,
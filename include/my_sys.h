@@ -71,6 +71,7 @@ typedef struct my_aio_result {
 #define MY_NOSYMLINKS  512U     /* my_open(): don't follow symlinks */
 #define MY_FULL_IO     512U     /* my_read(): loop until I/O is complete */
 #define MY_DONT_CHECK_FILESIZE 128U /* Option to init_io_cache() */
+#define MY_ASYNC_IO    1024U    /* Option to init_io_cache() */
 #define MY_LINK_WARNING 32U	/* my_redel() gives warning if links */
 #define MY_COPYTIME	64U	/* my_redel() copies time */
 #define MY_DELETE_OLD	256U	/* my_create_with_symlink() */
@@ -283,6 +284,7 @@ extern ulong	my_default_record_cache_size;
 extern my_bool  my_disable_locking, my_disable_async_io,
                 my_disable_flush_key_blocks, my_disable_symlinks;
 extern my_bool my_disable_sync, my_disable_copystat_in_redel;
+extern uint my_io_cache_async_threads;
 extern char	wild_many,wild_one,wild_prefix;
 extern const char *charsets_dir;
 extern my_bool timed_mutexes;
@@ -489,6 +491,11 @@ typedef struct st_io_cache		/* Used when caching files */
     somewhere else
   */
   my_bool alloced_buffer;
+  /*
+    Second buffer and pending request when the file is read ahead and
+    written behind by a background thread (MY_ASYNC_IO), otherwise NULL
+  */
+  struct st_io_cache_async *async;
 #ifdef HAVE_AIOWAIT
   /*
     As inidicated by ifdef, this is for async I/O, which is not currently
@@ -143,7 +143,10 @@ init_functions(IO_CACHE* info)
     use_async_io	Set to 1 of we should use async_io (if available)
     cache_myflags	Bitmap of different flags
 			MY_WME | MY_FAE | MY_NABP | MY_FNABP |
-			MY_DONT_CHECK_FILESIZE
+			MY_DONT_CHECK_FILESIZE | MY_ASYNC_IO
+			MY_ASYNC_IO reads a READ_CACHE ahead and
+			writes a WRITE_CACHE behind in a background
+			thread, see mf_iocache_async.c
 
   RETURN
     0  ok
@@ -157,6 +160,7 @@ int init_io_cache(IO_CACHE *info, File file, size_t cachesize,
   size_t min_cache;
   my_off_t pos;
   my_off_t end_of_file= ~(my_off_t) 0;
+  my_bool async_io= (cache_myflags & MY_ASYNC_IO) && !my_disable_async_io;
   DBUG_ENTER("init_io_cache");
   DBUG_PRINT("enter",("cache:%p  type: %d  pos: %llu",
 		      info, (int) type, (ulonglong) seek_offset));
@@ -168,6 +172,7 @@ int init_io_cache(IO_CACHE *info, File file, size_t cachesize,
   info->buffer=0;
   info->seek_not_done= 0;
   info->next_file_user= NULL;
+  info->async= NULL;
 
   if (file >= 0)
   {
@@ -217,10 +222,11 @@ int init_io_cache(IO_CACHE *info, File file, size_t cachesize,
       {
 	cachesize= (size_t) (end_of_file-seek_offset)+IO_SIZE*2-1;
 	use_async_io=0;				/* No need to use async */
+        async_io= 0;
       }
     }
   }
-  cache_myflags &= ~MY_DONT_CHECK_FILESIZE;
+  cache_myflags &= ~(MY_DONT_CHECK_FILESIZE | MY_ASYNC_IO);
   if (type != READ_NET)
   {
     /* Retry allocating memory in smaller blocks until we get one */
@@ -290,6 +296,9 @@ int init_io_cache(IO_CACHE *info, File file, size_t cachesize,
   info->error=0;
   info->type= type;
   init_functions(info);
+  if (async_io && (type == READ_CACHE || type == WRITE_CACHE) &&
+      !(cache_myflags & MY_ENCRYPT))
+    init_io_cache_async(info);
 #ifdef HAVE_AIOWAIT
   if (use_async_io && ! my_disable_async_io)
   {
@@ -330,6 +339,7 @@ int init_slave_io_cache(IO_CACHE *master, IO_CACHE *slave)
   }
   memcpy(slave, master, sizeof(IO_CACHE));
   slave->buffer= slave_buf;
+  slave->async= NULL;
 
   memcpy(slave->buffer, master->buffer, master->buffer_length);
   slave->read_pos= slave->buffer + (master->read_pos - master->buffer);
@@ -457,6 +467,10 @@ my_bool reinit_io_cache(IO_CACHE *info, enum cache_type type,
   DBUG_ASSERT(type == READ_CACHE || type == WRITE_CACHE);
   DBUG_ASSERT(info->type == READ_CACHE || info->type == WRITE_CACHE);
 
+  /* Finish the background I/O, the file is used at another position now */
+  if (info->async && io_cache_async_wait(info) && !clear_cache)
+    DBUG_RETURN(1);
+
   /* If the whole file is in memory, avoid flushing to disk */
   if (! clear_cache &&
       seek_offset >= info->pos_in_file &&
@@ -598,7 +612,7 @@ int _my_b_write(IO_CACHE *info, const uchar *Buffer, size_t Count)
   Count-=rest_length;
   info->write_pos+=rest_length;
 
-  if (my_b_flush_io_cache(info, 1))
+  if (info->async ? io_cache_async_write(info) : my_b_flush_io_cache(info, 1))
     return 1;
 
   if (Count)
@@ -785,9 +799,12 @@ int _my_b_cache_read(IO_CACHE *info, uchar *Buffer, size_t Count)
         c->seek_not_done= 1;
       }
     }
-    if ((length= mysql_file_read(info->file,info->buffer, max_length,
-                            info->myflags)) < Count ||
-	   length == (size_t) -1)
+    if (info->async && info->type == READ_CACHE)
+      length= io_cache_async_read(info, pos_in_file, max_length);
+    else
+      length= mysql_file_read(info->file, info->buffer, max_length,
+                              info->myflags);
+    if (length < Count || length == (size_t) -1)
     {
       /*
         We got an read error, or less than requested (end of file).
@@ -888,6 +905,8 @@ void init_io_cache_share(IO_CACHE *read_cache, IO_CACHE_SHARE *cshare,
                          IO_CACHE *write_cache, uint num_threads)
 {
   DBUG_ENTER("init_io_cache_share");
+  DBUG_ASSERT(!read_cache->async);
+  DBUG_ASSERT(!write_cache || !write_cache->async);
   DBUG_PRINT("io_cache_share", ("read_cache: %p  share: %p "
                                 "write_cache: %p  threads: %u",
                                  read_cache,  cshare,
@@ -1868,6 +1887,7 @@ int my_block_write(IO_CACHE *info, const uchar *Buffer, size_t Count,
   */
   DBUG_ASSERT(!info->share);
   DBUG_ASSERT(!(info->myflags & MY_ENCRYPT));
+  DBUG_ASSERT(!info->async);
 
   if (pos < info->pos_in_file)
   {
@@ -1932,6 +1952,9 @@ int my_b_flush_io_cache(IO_CACHE *info, int need_append_buffer_lock)
       if (real_open_cached_file(info))
 	DBUG_RETURN((info->error= -1));
     }
+    /* The write of the other buffer must be on disk too */
+    if (info->async && io_cache_async_wait(info))
+      DBUG_RETURN(-1);
     LOCK_APPEND_BUFFER;
 
     if ((length=(size_t) (info->write_pos - info->write_buffer)))
@@ -2010,6 +2033,8 @@ int end_io_cache(IO_CACHE *info)
     info->alloced_buffer=0;
     if (info->file != -1)			/* File doesn't exist */
       error= my_b_flush_io_cache(info,1);
+    if (info->async && end_io_cache_async(info))
+      error= -1;
     my_free(info->buffer);
     info->buffer=info->read_pos=(uchar*) 0;
   }
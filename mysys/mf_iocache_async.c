@@ -0,0 +1,410 @@
+/*
+   Copyright (c) 2019, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*
+  Read ahead and write behind for IO_CACHE.
+
+  A READ_CACHE or WRITE_CACHE that is initialized with MY_ASYNC_IO gets a
+  second buffer of the same size. When a WRITE_CACHE is full, its buffer
+  is handed to a background thread that writes it, and the cache goes on
+  in the second buffer. When a READ_CACHE is refilled, a background thread
+  reads the block after it into the second buffer, and the next refill
+  only swaps the buffers. The users of the cache see no difference, except
+  that the I/O of the file is done while they work on the data.
+
+  Every cache has at most one request at a time, for the buffer that it
+  does not use. The cache waits for it before it uses that buffer again,
+  when it is flushed, reinitialized or ended, so the file is up to date
+  whenever it would be without MY_ASYNC_IO. As the requests are done with
+  pread() and pwrite(), the file position is not known after them, and
+  the cache seeks before its next own read or write.
+
+  The background threads are shared by all caches. They are started when
+  there is a request and no idle thread, up to my_io_cache_async_threads,
+  and are stopped by my_end(). If no thread can be started, the requests
+  are done at once by the thread of the cache. As every cache has at most
+  one request, a cache never has more than one queued request before the
+  requests of other caches.
+*/
+
+#include "mysys_priv.h"
+#include "mysys_err.h"
+
+#define IO_CACHE_ASYNC_MAX_THREADS 64
+
+enum io_cache_async_state
+{
+  ASYNC_QUEUED,                         /* waits for a thread */
+  ASYNC_RUNNING,                        /* being read or written */
+  ASYNC_DONE
+};
+
+typedef struct st_io_cache_async
+{
+  uchar *buffer;                        /* the buffer the cache doesn't use */
+  mysql_cond_t cond;                    /* signalled when a request is done */
+  struct st_io_cache_async *next;       /* in the queue of requests */
+  /* The request, protected by LOCK_io_cache_async while it is pending */
+  File file;
+  my_off_t offset;
+  size_t length;
+  size_t result;                        /* bytes read, or MY_FILE_ERROR */
+  myf flags;
+  int error_no;
+  enum io_cache_async_state state;
+  /* Used only by the thread of the cache */
+  my_bool write;
+  my_bool pending;                      /* not yet waited for */
+  my_bool read_ahead;                   /* buffer is the block at offset */
+} IO_CACHE_ASYNC;
+
+static my_bool io_cache_async_inited= 0;
+static mysql_mutex_t LOCK_io_cache_async;
+static mysql_cond_t COND_io_cache_async;        /* new requests */
+static IO_CACHE_ASYNC *queue_first, **queue_last;
+static uint queue_length;
+static pthread_t async_threads[IO_CACHE_ASYNC_MAX_THREADS];
+static uint thread_count, idle_threads;
+static my_bool stop_threads;
+
+
+void init_io_cache_async_threads(void)
+{
+  mysql_mutex_init(key_LOCK_io_cache_async, &LOCK_io_cache_async,
+                   MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_COND_io_cache_async, &COND_io_cache_async, NULL);
+  queue_first= NULL;
+  queue_last= &queue_first;
+  queue_length= thread_count= idle_threads= 0;
+  stop_threads= 0;
+  io_cache_async_inited= 1;
+}
+
+
+/* Stop the threads after they have done all queued requests */
+
+void end_io_cache_async_threads(void)
+{
+  uint i;
+  if (!io_cache_async_inited)
+    return;
+  mysql_mutex_lock(&LOCK_io_cache_async);
+  stop_threads= 1;
+  mysql_cond_broadcast(&COND_io_cache_async);
+  mysql_mutex_unlock(&LOCK_io_cache_async);
+  for (i= 0; i < thread_count; i++)
+    pthread_join(async_threads[i], NULL);
+  io_cache_async_inited= 0;
+  mysql_mutex_destroy(&LOCK_io_cache_async);
+  mysql_cond_destroy(&COND_io_cache_async);
+}
+
+
+static void do_request(IO_CACHE_ASYNC *async)
+{
+  if (async->write)
+    async->result= mysql_file_pwrite(async->file, async->buffer,
+                                     async->length, async->offset,
+                                     async->flags | MY_NABP);
+  else
+    async->result= mysql_file_pread(async->file, async->buffer,
+                                    async->length, async->offset,
+                                    async->flags);
+  if (async->result == MY_FILE_ERROR)
+    async->error_no= my_errno;
+}
+
+
+static void *io_cache_async_handler(void *arg __attribute__((unused)))
+{
+  my_thread_init();
+  mysql_mutex_lock(&LOCK_io_cache_async);
+  for (;;)
+  {
+    IO_CACHE_ASYNC *async;
+    while (!(async= queue_first) && !stop_threads)
+    {
+      idle_threads++;
+      mysql_cond_wait(&COND_io_cache_async, &LOCK_io_cache_async);
+      idle_threads--;
+    }
+    if (!async)
+      break;
+    if (!(queue_first= async->next))
+      queue_last= &queue_first;
+    queue_length--;
+    async->state= ASYNC_RUNNING;
+    mysql_mutex_unlock(&LOCK_io_cache_async);
+
+    do_request(async);
+
+    mysql_mutex_lock(&LOCK_io_cache_async);
+    async->state= ASYNC_DONE;
+    mysql_cond_signal(&async->cond);
+  }
+  mysql_mutex_unlock(&LOCK_io_cache_async);
+  my_thread_end();
+  return NULL;
+}
+
+
+/* Hand the request of a cache over to the threads */
+
+static void submit_request(IO_CACHE_ASYNC *async)
+{
+  async->pending= 1;
+  if (io_cache_async_inited)
+  {
+    mysql_mutex_lock(&LOCK_io_cache_async);
+    if (queue_length >= idle_threads && !stop_threads &&
+        thread_count < MY_MIN(my_io_cache_async_threads,
+                              IO_CACHE_ASYNC_MAX_THREADS) &&
+        !mysql_thread_create(key_thread_io_cache_async,
+                             async_threads + thread_count, NULL,
+                             io_cache_async_handler, NULL))
+      thread_count++;
+    if (thread_count && !stop_threads)
+    {
+      async->state= ASYNC_QUEUED;
+      async->next= NULL;
+      *queue_last= async;
+      queue_last= &async->next;
+      queue_length++;
+      mysql_cond_signal(&COND_io_cache_async);
+      mysql_mutex_unlock(&LOCK_io_cache_async);
+      return;
+    }
+    mysql_mutex_unlock(&LOCK_io_cache_async);
+  }
+  do_request(async);
+  async->state= ASYNC_DONE;
+}
+
+
+static void wait_for_request(IO_CACHE_ASYNC *async)
+{
+  if (!async->pending)
+    return;
+  if (io_cache_async_inited)
+  {
+    mysql_mutex_lock(&LOCK_io_cache_async);
+    while (async->state != ASYNC_DONE)
+      mysql_cond_wait(&async->cond, &LOCK_io_cache_async);
+    mysql_mutex_unlock(&LOCK_io_cache_async);
+  }
+  async->pending= 0;
+}
+
+
+/*
+  Prepare a cache for read ahead and write behind
+
+  NOTES
+    The second buffer is allocated when it is first needed, as many
+    caches never go to the file. If there is no memory for the buffers,
+    the cache works without them.
+*/
+
+void init_io_cache_async(IO_CACHE *info)
+{
+  IO_CACHE_ASYNC *async;
+  if (!(async= (IO_CACHE_ASYNC*) my_malloc(sizeof(*async), MYF(0))))
+    return;
+  async->buffer= NULL;
+  async->state= ASYNC_DONE;
+  async->write= async->pending= async->read_ahead= 0;
+  mysql_cond_init(key_IO_CACHE_async_cond, &async->cond, NULL);
+  info->async= async;
+}
+
+
+int end_io_cache_async(IO_CACHE *info)
+{
+  IO_CACHE_ASYNC *async= info->async;
+  int error= io_cache_async_wait(info);
+  mysql_cond_destroy(&async->cond);
+  my_free(async->buffer);
+  my_free(async);
+  info->async= NULL;
+  return error;
+}
+
+
+/*
+  Wait until the request of a cache is done
+
+  DESCRIPTION
+    A block that was read ahead is dropped, as the cache may go to
+    another position of the file, or write it.
+
+    A background write is done without MY_WAIT_IF_FULL, as nobody could
+    abort its wait. If it failed because the disk is full, it is done
+    again here with the flags of the cache, so that a cache with
+    MY_WAIT_IF_FULL waits for free space as it would without MY_ASYNC_IO.
+
+  RETURN
+    0   ok
+    -1  the write failed; info->error is set
+*/
+
+int io_cache_async_wait(IO_CACHE *info)
+{
+  IO_CACHE_ASYNC *async= info->async;
+  my_bool was_pending= async->pending;
+
+  wait_for_request(async);
+  async->read_ahead= 0;
+  if (was_pending && async->write && async->result == MY_FILE_ERROR)
+  {
+    if ((info->myflags & MY_WAIT_IF_FULL) &&
+        (async->error_no == ENOSPC || async->error_no == EDQUOT))
+    {
+      if (mysql_file_pwrite(async->file, async->buffer, async->length,
+                            async->offset, info->myflags | MY_NABP))
+        return info->error= -1;                 /* Reported by my_pwrite() */
+      return 0;
+    }
+    my_errno= async->error_no;
+    if (info->myflags & MY_WME)
+      my_error(EE_WRITE, MYF(ME_BELL), my_filename(async->file),
+               async->error_no);
+    return info->error= -1;
+  }
+  return 0;
+}
+
+
+static my_bool alloc_second_buffer(IO_CACHE *info)
+{
+  IO_CACHE_ASYNC *async= info->async;
+  if (!async->buffer)
+    async->buffer= (uchar*) my_malloc(info->buffer_length, MYF(0));
+  return async->buffer == NULL;
+}
+
+
+static void set_request(IO_CACHE_ASYNC *async, IO_CACHE *info,
+                        my_off_t offset, size_t length)
+{
+  async->file= info->file;
+  async->offset= offset;
+  async->length= length;
+  /* The threads have no one to report the errors to */
+  async->flags= info->myflags & ~(MY_WME | MY_FAE | MY_WAIT_IF_FULL);
+}
+
+
+/*
+  Write the buffer of a full WRITE_CACHE in the background
+
+  DESCRIPTION
+    Used by _my_b_write() instead of my_b_flush_io_cache(). The cache
+    continues in the other buffer, once the write of that one is done.
+
+  RETURN
+    0   ok
+    #   error; info->error is set
+*/
+
+int io_cache_async_write(IO_CACHE *info)
+{
+  IO_CACHE_ASYNC *async= info->async;
+  size_t length= (size_t) (info->write_pos - info->write_buffer);
+  uchar *buffer;
+
+  if (alloc_second_buffer(info))
+    return my_b_flush_io_cache(info, 0);
+  if (info->file == -1 && real_open_cached_file(info))
+    return info->error= -1;
+  if (io_cache_async_wait(info))
+    return 1;
+  if (!length)
+    return 0;
+
+  buffer= async->buffer;
+  async->buffer= info->write_buffer;
+  async->write= 1;
+  set_request(async, info, info->pos_in_file, length);
+  submit_request(async);
+
+  info->buffer= info->write_buffer= info->request_pos= buffer;
+  info->write_pos= buffer;
+  info->pos_in_file+= length;
+  set_if_bigger(info->end_of_file, info->pos_in_file);
+  info->write_end= (buffer + info->buffer_length -
+                    (size_t) (info->pos_in_file & (IO_SIZE - 1)));
+  info->seek_not_done= 1;
+  ++info->disk_writes;
+  return 0;
+}
+
+
+/*
+  Fill the buffer of a READ_CACHE and read the next block ahead
+
+  SYNOPSIS
+    io_cache_async_read()
+      info      the cache
+      pos       position of the block in the file
+      length    length of the block
+
+  DESCRIPTION
+    Used by _my_b_cache_read() instead of reading the file. If the block
+    was read ahead, the buffers are swapped. Otherwise the block is read
+    from the current position of the file, as it would be without
+    MY_ASYNC_IO.
+
+  RETURN
+    the number of bytes in the buffer, or MY_FILE_ERROR
+*/
+
+size_t io_cache_async_read(IO_CACHE *info, my_off_t pos, size_t length)
+{
+  IO_CACHE_ASYNC *async= info->async;
+  size_t read_length;
+  my_off_t next_pos;
+
+  if (alloc_second_buffer(info))
+    return mysql_file_read(info->file, info->buffer, length, info->myflags);
+
+  wait_for_request(async);
+  if (async->read_ahead && async->offset == pos &&
+      async->length == length && async->result == length)
+  {
+    uchar *buffer= info->buffer;
+    info->buffer= info->write_buffer= info->request_pos= async->buffer;
+    async->buffer= buffer;
+    read_length= length;
+    info->seek_not_done= 1;
+  }
+  else
+    read_length= mysql_file_read(info->file, info->buffer, length,
+                                 info->myflags);
+  async->read_ahead= 0;
+
+  next_pos= pos + length;
+  if (read_length == length && next_pos < info->end_of_file)
+  {
+    size_t next_length= info->read_length - (size_t) (next_pos & (IO_SIZE-1));
+    if (next_length > info->end_of_file - next_pos)
+      next_length= (size_t) (info->end_of_file - next_pos);
+    async->write= 0;
+    async->read_ahead= 1;
+    set_request(async, info, next_pos, next_length);
+    submit_request(async);
+  }
+  return read_length;
+}
@@ -104,6 +104,7 @@ my_bool my_init(void)
 
   if (my_thread_global_init())
     return 1;
+  init_io_cache_async_threads();
 
 #if defined(SAFEMALLOC) && !defined(DBUG_OFF)
   dbug_sanity= sf_sanity;
@@ -229,6 +230,7 @@ Voluntary context switches %ld, Involuntary context switches %ld\n",
 #endif
   }
 
+  end_io_cache_async_threads();
   my_thread_end();
   my_thread_global_end();
 
@@ -483,7 +485,8 @@ PSI_mutex_key key_BITMAP_mutex, key_IO_CACHE_append_buffer_lock,
   key_THR_LOCK_lock, key_THR_LOCK_malloc,
   key_THR_LOCK_mutex, key_THR_LOCK_myisam, key_THR_LOCK_net,
   key_THR_LOCK_open, key_THR_LOCK_threads,
-  key_TMPDIR_mutex, key_THR_LOCK_myisam_mmap, key_LOCK_uuid_generator;
+  key_TMPDIR_mutex, key_THR_LOCK_myisam_mmap, key_LOCK_uuid_generator,
+  key_LOCK_io_cache_async;
 
 static PSI_mutex_info all_mysys_mutexes[]=
 {
@@ -511,12 +514,14 @@ static PSI_mutex_info all_mysys_mutexes[]=
   { &key_THR_LOCK_threads, "THR_LOCK_threads", PSI_FLAG_GLOBAL},
   { &key_TMPDIR_mutex, "TMPDIR_mutex", PSI_FLAG_GLOBAL},
   { &key_THR_LOCK_myisam_mmap, "THR_LOCK_myisam_mmap", PSI_FLAG_GLOBAL},
-  { &key_LOCK_uuid_generator, "LOCK_uuid_generator", PSI_FLAG_GLOBAL }
+  { &key_LOCK_uuid_generator, "LOCK_uuid_generator", PSI_FLAG_GLOBAL },
+  { &key_LOCK_io_cache_async, "LOCK_io_cache_async", PSI_FLAG_GLOBAL}
 };
 
 PSI_cond_key key_COND_alarm, key_COND_timer, key_IO_CACHE_SHARE_cond,
   key_IO_CACHE_SHARE_cond_writer, key_my_thread_var_suspend,
-  key_THR_COND_threads, key_WT_RESOURCE_cond;
+  key_THR_COND_threads, key_WT_RESOURCE_cond, key_COND_io_cache_async,
+  key_IO_CACHE_async_cond;
 
 static PSI_cond_info all_mysys_conds[]=
 {
@@ -526,7 +531,9 @@ static PSI_cond_info all_mysys_conds[]=
   { &key_IO_CACHE_SHARE_cond_writer, "IO_CACHE_SHARE::cond_writer", 0},
   { &key_my_thread_var_suspend, "my_thread_var::suspend", 0},
   { &key_THR_COND_threads, "THR_COND_threads", PSI_FLAG_GLOBAL},
-  { &key_WT_RESOURCE_cond, "WT_RESOURCE::cond", 0}
+  { &key_WT_RESOURCE_cond, "WT_RESOURCE::cond", 0},
+  { &key_COND_io_cache_async, "COND_io_cache_async", PSI_FLAG_GLOBAL},
+  { &key_IO_CACHE_async_cond, "IO_CACHE::async_cond", 0}
 };
 
 PSI_rwlock_key key_SAFEHASH_mutex;
@@ -539,14 +546,15 @@ static PSI_rwlock_info all_mysys_rwlocks[]=
 #ifdef USE_ALARM_THREAD
 PSI_thread_key key_thread_alarm;
 #endif
-PSI_thread_key key_thread_timer;
+PSI_thread_key key_thread_timer, key_thread_io_cache_async;
 
 static PSI_thread_info all_mysys_threads[]=
 {
 #ifdef USE_ALARM_THREAD
   { &key_thread_alarm, "alarm", PSI_FLAG_GLOBAL},
 #endif
-  { &key_thread_timer, "statement_timer", PSI_FLAG_GLOBAL}
+  { &key_thread_timer, "statement_timer", PSI_FLAG_GLOBAL},
+  { &key_thread_io_cache_async, "io_cache_async", 0}
 };
 
 
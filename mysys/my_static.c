@@ -100,6 +100,9 @@ my_bool my_disable_flush_key_blocks=0;
 my_bool my_disable_symlinks=0;
 my_bool my_disable_copystat_in_redel=0;
 
+	/* Background threads of IO_CACHE with MY_ASYNC_IO */
+uint my_io_cache_async_threads=4;
+
 /* Typelib by all clients */
 const char *sql_protocol_names_lib[] =
 { "TCP", "SOCKET", "PIPE", NullS };
@@ -48,16 +48,17 @@ extern PSI_mutex_key key_BITMAP_mutex, key_IO_CACHE_append_buffer_lock,
   key_THR_LOCK_lock, key_THR_LOCK_malloc,
   key_THR_LOCK_mutex, key_THR_LOCK_myisam, key_THR_LOCK_net,
   key_THR_LOCK_open, key_THR_LOCK_threads, key_LOCK_uuid_generator,
-  key_TMPDIR_mutex, key_THR_LOCK_myisam_mmap, key_LOCK_timer;
+  key_TMPDIR_mutex, key_THR_LOCK_myisam_mmap, key_LOCK_timer,
+  key_LOCK_io_cache_async;
 
 extern PSI_cond_key key_COND_alarm, key_COND_timer, key_IO_CACHE_SHARE_cond,
   key_IO_CACHE_SHARE_cond_writer, key_my_thread_var_suspend,
-  key_THR_COND_threads;
+  key_THR_COND_threads, key_COND_io_cache_async, key_IO_CACHE_async_cond;
 
 #ifdef USE_ALARM_THREAD
 extern PSI_thread_key key_thread_alarm;
 #endif /* USE_ALARM_THREAD */
-extern PSI_thread_key key_thread_timer;
+extern PSI_thread_key key_thread_timer, key_thread_io_cache_async;
 extern PSI_rwlock_key key_SAFEHASH_mutex;
 
 #endif /* HAVE_PSI_INTERFACE */
@@ -87,6 +88,15 @@ typedef struct {
 extern int (*_my_b_encr_read)(IO_CACHE *info,uchar *Buffer,size_t Count);
 extern int (*_my_b_encr_write)(IO_CACHE *info,const uchar *Buffer,size_t Count);
 
+/* mf_iocache_async.c */
+extern void init_io_cache_async_threads(void);
+extern void end_io_cache_async_threads(void);
+extern void init_io_cache_async(IO_CACHE *info);
+extern int end_io_cache_async(IO_CACHE *info);
+extern int io_cache_async_wait(IO_CACHE *info);
+extern int io_cache_async_write(IO_CACHE *info);
+extern size_t io_cache_async_read(IO_CACHE *info, my_off_t pos, size_t length);
+
 #ifdef SAFEMALLOC
 void *sf_malloc(size_t size, myf my_flags);
 void *sf_realloc(void *ptr, size_t size, myf my_flags);
@@ -33,6 +33,8 @@
 #include "opt_range.h"                          // SQL_SELECT
 #include "bounded_queue.h"
 #include "filesort_utils.h"
+#include "filesort_parallel.h"
+#include "loser_tree.h"
 #include "sql_select.h"
 #include "debug_sync.h"
 
@@ -45,13 +47,15 @@ static ha_rows find_all_keys(THD *thd, Sort_param *param, SQL_SELECT *select,
                              IO_CACHE *buffer_file,
                              IO_CACHE *tempfile,
                              Bounded_queue<uchar, uchar> *pq,
+                             Parallel_sort *psort,
                              ha_rows *found_rows);
 static bool write_keys(Sort_param *param, SORT_INFO *fs_info,
                       uint count, IO_CACHE *buffer_file, IO_CACHE *tempfile);
 static void make_sortkey(Sort_param *param, uchar *to, uchar *ref_pos);
+static uint make_packed_sortkey(Sort_param *param, uchar *to, uchar *ref_pos);
 static void register_used_fields(Sort_param *param);
 static bool save_index(Sort_param *param, uint count,
-                       SORT_INFO *table_sort);
+                       SORT_INFO *table_sort, Parallel_sort *psort);
 static uint suffix_length(ulong string_length);
 static uint sortlength(THD *thd, SORT_FIELD *sortorder, uint s_length,
 		       bool *multi_byte_charset);
@@ -59,6 +63,8 @@ static SORT_ADDON_FIELD *get_addon_fields(TABLE *table, uint sortlength,
                                           LEX_STRING *addon_buf);
 static void unpack_addon_fields(struct st_sort_addon_field *addon_field,
                                 uchar *buff, uchar *buff_end);
+static void unpack_packed_addon_fields(struct st_sort_addon_field *addon_field,
+                                       uchar *buff, uchar *buff_end);
 static bool check_if_pq_applicable(Sort_param *param, SORT_INFO *info,
                                    TABLE *table,
                                    ha_rows records, size_t memory_available);
@@ -95,6 +101,105 @@ void Sort_param::init_for_filesort(uint sortlen, TABLE *table,
   }
   rec_length= sort_length + (uint)addon_buf.length;
   max_rows= maxrows;
+  compare_length= sort_length;
+}
+
+
+/*
+  Decide whether the records of the sort are packed
+
+  SYNOPSIS
+    try_to_pack_records()
+      thd       the thread of the query
+
+  DESCRIPTION
+    A string key part is packed when its whole value is compared, that is
+    when it is not cut by max_sort_length. It is then stored with its
+    length rather than padded to its maximum length, and compared with
+    the collation of the string. As such a key part orders the records as
+    its fixed form does, the sort gives the same result either way.
+    Addon fields are packed if there is a CHAR or VARCHAR field among them.
+
+    sort_length, rec_length and res_length are set to the maximum lengths
+    of the packed records.
+
+  NOTE
+    Not called for a sort with a priority queue, which keeps records of
+    fixed length.
+*/
+
+void Sort_param::try_to_pack_records(THD *thd)
+{
+  uint max_sort_length= (uint) thd->variables.max_sort_length;
+  uint length= SORT_KEY_LENGTH_BYTES;
+  SORT_FIELD *sort_field;
+  SORT_ADDON_FIELD *addonf;
+
+  for (sort_field= local_sortorder; sort_field != end; sort_field++)
+  {
+    Field *field= sort_field->field;
+    Item *item= sort_field->item;
+    uint original_length= 0;
+
+    sort_field->maybe_null= field ? field->maybe_null() : item->maybe_null;
+    if (field)
+    {
+      switch (field->real_type()) {
+      case MYSQL_TYPE_VARCHAR:
+      case MYSQL_TYPE_STRING:
+        original_length= field->field_length;
+        break;
+      case MYSQL_TYPE_BLOB:
+        if (field->type() == MYSQL_TYPE_BLOB)
+          original_length= field->max_data_length();
+        break;
+      default:
+        break;
+      }
+      sort_field->cs= field->sort_charset();
+    }
+    else if (item->cmp_type() == STRING_RESULT)
+    {
+      original_length= item->max_length;
+      sort_field->cs= item->collation.collation;
+    }
+    /* A key part of max_sort_length may have been cut by sortlength() */
+    if (!original_length || original_length > max_sort_length ||
+        sort_field->length >= max_sort_length)
+    {
+      length+= sort_field->length + sort_field->maybe_null;
+      continue;
+    }
+    sort_field->original_length= original_length;
+    sort_field->length_bytes= original_length < 256 ? 1 :
+                              original_length < 65536 ? 2 : 4;
+    length+= sort_field->maybe_null + sort_field->length_bytes +
+             original_length;
+    using_packed_sortkeys= TRUE;
+  }
+
+  if (using_packed_sortkeys)
+    sort_length= length;
+
+  for (addonf= addon_field; addonf && addonf->field; addonf++)
+  {
+    if (addonf->field->real_type() == MYSQL_TYPE_VARCHAR ||
+        addonf->field->real_type() == MYSQL_TYPE_STRING)
+      using_packed_addons= TRUE;
+  }
+  if (using_packed_addons)
+  {
+    /* get_addon_fields() has allocated the space for the length */
+    addon_buf.length+= SORT_ADDON_LENGTH_BYTES;
+    res_length= (uint) addon_buf.length;
+  }
+
+  if (addon_field || using_packed_sortkeys)
+    rec_length= sort_length + res_length;
+  compare_length= sort_length;
+  DBUG_PRINT("info", ("packed sort keys: %d  packed addons: %d  "
+                      "rec_length: %u", using_packed_sortkeys,
+                      using_packed_addons, rec_length));
 }
 
 
@@ -140,6 +245,7 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
   Sort_param param;
   bool multi_byte_charset;
   Bounded_queue<uchar, uchar> pq;
+  Parallel_sort psort;
   SQL_SELECT *const select= filesort->select;
   ha_rows max_rows= filesort->limit;
   uint s_length= 0;
@@ -182,14 +288,12 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
   param.init_for_filesort(sortlength(thd, filesort->sortorder, s_length,
                                      &multi_byte_charset),
                           table, max_rows, filesort->sort_positions);
+  param.sort_form= table;
+  param.end=(param.local_sortorder=filesort->sortorder)+s_length;
 
   sort->addon_buf=    param.addon_buf;
   sort->addon_field=  param.addon_field;
   sort->unpack=       unpack_addon_fields;
-  if (multi_byte_charset &&
-      !(param.tmp_buffer= (char*) my_malloc(param.sort_length,
-                                            MYF(MY_WME | MY_THREAD_SPECIFIC))))
-    goto err;
 
   if (select && select->quick)
     thd->inc_status_sort_range();
@@ -230,6 +334,14 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
   {
     DBUG_PRINT("info", ("filesort PQ is not applicable"));
 
+    param.try_to_pack_records(thd);
+    if (param.using_packed_addons)
+    {
+      sort->addon_buf=    param.addon_buf;
+      sort->unpack=       unpack_packed_addon_fields;
+      sort->using_packed_addons= TRUE;
+    }
+
     size_t min_sort_memory= MY_MAX(MIN_SORT_MEMORY,
                                    param.sort_length*MERGEBUFF2);
     set_if_bigger(min_sort_memory, sizeof(BUFFPEK*)*MERGEBUFF2);
@@ -251,19 +363,25 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
       goto err;
     }
     tracker->report_sort_buffer_size(sort->sort_buffer_size());
+    psort.init(thd, &param, sort, num_rows);
   }
 
+  /* Allocated when sort_length is final */
+  if (multi_byte_charset &&
+      !(param.tmp_buffer= (char*) my_malloc(param.sort_length,
+                                            MYF(MY_WME | MY_THREAD_SPECIFIC))))
+    goto err;
+
   if (open_cached_file(&buffpek_pointers,mysql_tmpdir,TEMP_PREFIX,
 		       DISK_BUFFER_SIZE, MYF(MY_WME)))
     goto err;
 
-  param.sort_form= table;
-  param.end=(param.local_sortorder=filesort->sortorder)+s_length;
   num_rows= find_all_keys(thd, &param, select,
                           sort,
                           &buffpek_pointers,
                           &tempfile, 
                           pq.is_initialized() ? &pq : NULL,
+                          psort.is_used() ? &psort : NULL,
                           &sort->found_rows);
   if (num_rows == HA_POS_ERROR)
     goto err;
@@ -274,7 +392,7 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
 
   if (maxbuffer == 0)			// The whole set is in memory
   {
-    if (save_index(&param, (uint) num_rows, sort))
+    if (save_index(&param, (uint) num_rows, sort, &psort))
       goto err;
   }
   else
@@ -297,7 +415,7 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
 	/* Open cached file if it isn't open */
     if (! my_b_inited(outfile) &&
 	open_cached_file(outfile,mysql_tmpdir,TEMP_PREFIX,READ_RECORD_BUFFER,
-			  MYF(MY_WME)))
+			  MYF(MY_WME | MY_ASYNC_IO)))
       goto err;
     if (reinit_io_cache(outfile,WRITE_CACHE,0L,0,0))
       goto err;
@@ -318,12 +436,17 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
     if (flush_io_cache(&tempfile) ||
 	reinit_io_cache(&tempfile,READ_CACHE,0L,0,0))
       goto err;
-    if (merge_index(&param,
-                    (uchar*) sort->get_sort_keys(),
-                    buffpek,
-                    maxbuffer,
-                    &tempfile,
-		    outfile))
+    if (psort.can_merge_runs(buffpek, maxbuffer, &tempfile, outfile))
+    {
+      if (psort.merge_runs())
+        goto err;
+    }
+    else if (merge_index(&param,
+                         (uchar*) sort->get_sort_keys(),
+                         buffpek,
+                         maxbuffer,
+                         &tempfile,
+                         outfile))
       goto err;
   }
 
@@ -335,6 +458,8 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
   error= 0;
 
   err:
+  /* The sort threads may use the sort buffer and the temporary files */
+  psort.end();
   my_free(param.tmp_buffer);
   if (!subselect || !subselect->is_uncacheable())
   {
@@ -653,6 +778,9 @@ static void dbug_print_record(TABLE *table, bool print_rowid)
                            in tempfile.
   @param tempfile          File to write sorted sequences of sortkeys to.
   @param pq                If !NULL, use it for keeping top N elements
+  @param psort             If !NULL, the sort buffer is filled in segments
+                           that are sorted and written by other threads,
+                           see Parallel_sort
   @param [out] found_rows  The number of FOUND_ROWS().
                            For a query with LIMIT, this value will typically
                            be larger than the function return value.
@@ -692,22 +820,25 @@ static ha_rows find_all_keys(THD *thd, Sort_param *param, SQL_SELECT *select,
 			     IO_CACHE *buffpek_pointers,
                              IO_CACHE *tempfile,
                              Bounded_queue<uchar, uchar> *pq,
+                             Parallel_sort *psort,
                              ha_rows *found_rows)
 {
   int error, quick_select;
-  uint idx, indexpos;
+  uint idx, indexpos, idx_end;
   uchar *ref_pos, *next_pos, ref_buff[MAX_REFLENGTH];
   TABLE *sort_form;
   handler *file;
   MY_BITMAP *save_read_set, *save_write_set;
   Item *sort_cond;
   ha_rows retval;
+  const bool packed= param->using_packed_records();
   DBUG_ENTER("find_all_keys");
   DBUG_PRINT("info",("using: %s",
                      (select ? select->quick ? "ranges" : "where":
                       "every row")));
 
   idx=indexpos=0;
+  idx_end= psort ? psort->segment_end() : param->max_keys_per_buffer;
   error=quick_select=0;
   sort_form=param->sort_form;
   file=sort_form->file;
@@ -721,6 +852,10 @@ static ha_rows find_all_keys(THD *thd, Sort_param *param, SQL_SELECT *select,
                   dbug_serve_apcs(thd, 1);
                  );
 
+  /* The parallel sort sets up the area of its first segment */
+  if (packed && !psort)
+    fs_info->init_packed_area();
+
   if (!quick_select)
   {
     next_pos=(uchar*) 0;			/* Find records in sequence */
@@ -815,14 +950,46 @@ static ha_rows find_all_keys(THD *thd, Sort_param *param, SQL_SELECT *select,
         pq->push(ref_pos);
         idx= pq->num_elements();
       }
+      else if (packed)
+      {
+        /* idx is the number of keys in the area being filled */
+        if (fs_info->packed_area_full(param->rec_length))
+        {
+          if (psort)
+          {
+            if (psort->next_segment(&idx, buffpek_pointers, tempfile))
+              goto err;
+          }
+          else
+          {
+            if (write_keys(param, fs_info, idx, buffpek_pointers, tempfile))
+              goto err;
+            fs_info->init_packed_area();
+            idx= 0;
+            indexpos++;
+          }
+        }
+        uchar *to= fs_info->get_packed_record_buffer();
+        fs_info->add_packed_record(make_packed_sortkey(param, to, ref_pos));
+        idx++;
+      }
       else
       {
-        if (idx == param->max_keys_per_buffer)
+        if (idx == idx_end)
         {
-          if (write_keys(param, fs_info, idx, buffpek_pointers, tempfile))
-            goto err;
-	  idx= 0;
-	  indexpos++;
+          if (psort)
+          {
+            if (psort->next_segment(&idx, buffpek_pointers, tempfile))
+              goto err;
+            idx_end= psort->segment_end();
+          }
+          else
+          {
+            if (write_keys(param, fs_info, idx, buffpek_pointers, tempfile))
+              goto err;
+            idx= 0;
+            indexpos++;
+          }
         }
         make_sortkey(param, fs_info->get_record_buffer(idx++), ref_pos);
       }
@@ -858,12 +1025,15 @@ static ha_rows find_all_keys(THD *thd, Sort_param *param, SQL_SELECT *select,
     file->print_error(error,MYF(ME_ERROR_LOG));
     DBUG_RETURN(HA_POS_ERROR);
   }
-  if (indexpos && idx &&
-      write_keys(param, fs_info, idx, buffpek_pointers, tempfile))
+  if (psort)
+  {
+    if (psort->finish_segments(&idx))
+      DBUG_RETURN(HA_POS_ERROR);
+  }
+  else if (indexpos && idx &&
+           write_keys(param, fs_info, idx, buffpek_pointers, tempfile))
     DBUG_RETURN(HA_POS_ERROR);			/* purecov: inspected */
-  retval= (my_b_inited(tempfile) ?
-           (ha_rows) (my_b_tell(tempfile)/param->rec_length) :
-           idx);
+  retval= (my_b_inited(tempfile) ? param->written_rows : idx);
   DBUG_PRINT("info", ("find_all_keys return %llu", (ulonglong) retval));
   DBUG_RETURN(retval);
 
@@ -899,19 +1069,17 @@ static bool
 write_keys(Sort_param *param,  SORT_INFO *fs_info, uint count,
            IO_CACHE *buffpek_pointers, IO_CACHE *tempfile)
 {
-  size_t rec_length;
   uchar **end;
   BUFFPEK buffpek;
   DBUG_ENTER("write_keys");
 
-  rec_length= param->rec_length;
-  uchar **sort_keys= fs_info->get_sort_keys();
+  uchar **sort_keys= fs_info->get_sort_keys(param);
 
   fs_info->sort_buffer(param, count);
 
   if (!my_b_inited(tempfile) &&
       open_cached_file(tempfile, mysql_tmpdir, TEMP_PREFIX, DISK_BUFFER_SIZE,
-                       MYF(MY_WME)))
+                       MYF(MY_WME | MY_ASYNC_IO)))
     goto err;                                   /* purecov: inspected */
   /* check we won't have more buffpeks than we can possibly keep in memory */
   if (my_b_tell(buffpek_pointers) + sizeof(BUFFPEK) > (ulonglong)UINT_MAX)
@@ -922,10 +1090,12 @@ write_keys(Sort_param *param,  SORT_INFO *fs_info, uint count,
     count=(uint) param->max_rows;               /* purecov: inspected */
   buffpek.count=(ha_rows) count;
   for (end=sort_keys+count ; sort_keys != end ; sort_keys++)
-    if (my_b_write(tempfile, (uchar*) *sort_keys, (uint) rec_length))
+    if (my_b_write(tempfile, (uchar*) *sort_keys,
+                   param->get_record_length(*sort_keys)))
       goto err;
   if (my_b_write(buffpek_pointers, (uchar*) &buffpek, sizeof(buffpek)))
     goto err;
+  param->written_rows+= count;
   DBUG_RETURN(0);
 
 err:
@@ -1165,93 +1335,309 @@ Type_handler_real_result::make_sort_key(uchar *to, Item *item,
 }
 
 
-/** Make a sort-key from record. */
+/** Make a key part of a sort-key, return the position after it. */
 
-static void make_sortkey(Sort_param *param, uchar *to, uchar *ref_pos)
+static uchar *make_sortkey_part(Sort_param *param, SORT_FIELD *sort_field,
+                                uchar *to)
 {
   Field *field;
-  SORT_FIELD *sort_field;
   uint length;
+  bool maybe_null=0;
 
-  for (sort_field=param->local_sortorder ;
-       sort_field != param->end ;
-       sort_field++)
-  {
-    bool maybe_null=0;
-    if ((field=sort_field->field))
-    {						// Field
-      field->make_sort_key(to, sort_field->length);
-      if ((maybe_null = field->maybe_null()))
-        to++;
-    }
-    else
-    {						// Item
-      sort_field->item->type_handler()->make_sort_key(to, sort_field->item,
-                                                      sort_field, param);
-      if ((maybe_null= sort_field->item->maybe_null))
-        to++;
+  if ((field=sort_field->field))
+  {						// Field
+    field->make_sort_key(to, sort_field->length);
+    if ((maybe_null = field->maybe_null()))
+      to++;
+  }
+  else
+  {						// Item
+    sort_field->item->type_handler()->make_sort_key(to, sort_field->item,
+                                                    sort_field, param);
+    if ((maybe_null= sort_field->item->maybe_null))
+      to++;
+  }
+  if (sort_field->reverse)
+  {							/* Revers key */
+    if (maybe_null && (to[-1]= !to[-1]))
+      return to + sort_field->length; // don't waste the time reversing all 0's
+    length=sort_field->length;
+    while (length--)
+    {
+      *to = (uchar) (~ *to);
+      to++;
     }
-    if (sort_field->reverse)
-    {							/* Revers key */
-      if (maybe_null && (to[-1]= !to[-1]))
-      {
-        to+= sort_field->length; // don't waste the time reversing all 0's
-        continue;
-      }
-      length=sort_field->length;
-      while (length--)
-      {
-	*to = (uchar) (~ *to);
-	to++;
-      }
+    return to;
+  }
+  return to + sort_field->length;
+}
+
+
+/**
+  Make a packed string key part of a sort-key, see try_to_pack_records().
+  The value is stored as it is, the order is applied when comparing.
+*/
+
+static uchar *make_packed_sortkey_part(SORT_FIELD *sort_field, uchar *to)
+{
+  Field *field= sort_field->field;
+  uchar *value= to + sort_field->maybe_null + sort_field->length_bytes;
+  String tmp((char*) value, sort_field->original_length, sort_field->cs);
+  String *res;
+  uint length;
+
+  if (field)
+    res= field->is_null() ? NULL : field->val_str(&tmp);
+  else
+    res= sort_field->item->str_result(&tmp);
+  if (sort_field->maybe_null)
+  {
+    if (!res)
+    {
+      *to++= 0;
+      return to;
     }
-    else
-      to+= sort_field->length;
+    *to++= 1;
+  }
+  length= 0;
+  if (likely(res))
+  {
+    length= MY_MIN(res->length(), sort_field->original_length);
+    if (res->ptr() != (char*) value)
+      memmove(value, res->ptr(), length);
   }
+  else
+    DBUG_ASSERT(0);
+  switch (sort_field->length_bytes) {
+  case 1:
+    *to= (uchar) length;
+    break;
+  case 2:
+    int2store(to, length);
+    break;
+  default:
+    int4store(to, length);
+    break;
+  }
+  return value + length;
+}
 
-  if (param->addon_field)
+
+/** The length of the value of a packed string key part. */
+
+static inline uint read_packed_length(const uchar *from, uint length_bytes)
+{
+  switch (length_bytes) {
+  case 1:
+    return *from;
+  case 2:
+    return uint2korr(from);
+  default:
+    return uint4korr(from);
+  }
+}
+
+
+/**
+  Save the values of the addon fields after the sort key.
+  First null bit indicators are appended then field values follow.
+  In this implementation we use fixed layout for field values -
+  the same for all records.
+*/
+
+static void make_addon_fields(Sort_param *param, uchar *to)
+{
+  SORT_ADDON_FIELD *addonf= param->addon_field;
+  uchar *nulls= to;
+  Field *field;
+  DBUG_ASSERT(addonf != 0);
+  memset(nulls, 0, addonf->offset);
+  to+= addonf->offset;
+  for ( ; (field= addonf->field) ; addonf++)
   {
-    /* 
-      Save field values appended to sorted fields.
-      First null bit indicators are appended then field values follow.
-      In this implementation we use fixed layout for field values -
-      the same for all records.
-    */
-    SORT_ADDON_FIELD *addonf= param->addon_field;
-    uchar *nulls= to;
-    DBUG_ASSERT(addonf != 0);
-    memset(nulls, 0, addonf->offset);
-    to+= addonf->offset;
-    for ( ; (field= addonf->field) ; addonf++)
+    if (addonf->null_bit && field->is_null())
     {
-      if (addonf->null_bit && field->is_null())
-      {
-        nulls[addonf->null_offset]|= addonf->null_bit;
+      nulls[addonf->null_offset]|= addonf->null_bit;
 #ifdef HAVE_valgrind
-	bzero(to, addonf->length);
+      bzero(to, addonf->length);
 #endif
-      }
-      else
-      {
+    }
+    else
+    {
 #ifdef HAVE_valgrind
-        uchar *end= field->pack(to, field->ptr);
-	uint length= (uint) ((to + addonf->length) - end);
-	DBUG_ASSERT((int) length >= 0);
-	if (length)
-	  bzero(end, length);
+      uchar *end= field->pack(to, field->ptr);
+      uint length= (uint) ((to + addonf->length) - end);
+      DBUG_ASSERT((int) length >= 0);
+      if (length)
+        bzero(end, length);
 #else
-        (void) field->pack(to, field->ptr);
+      (void) field->pack(to, field->ptr);
 #endif
-      }
-      to+= addonf->length;
     }
+    to+= addonf->length;
+  }
+}
+
+
+/**
+  Save the values of the addon fields packed one after the other, after
+  their length and the null bit indicators. Return the position after them.
+*/
+
+static uchar *make_packed_addon_fields(Sort_param *param, uchar *to)
+{
+  SORT_ADDON_FIELD *addonf= param->addon_field;
+  uchar *start= to;
+  uchar *nulls= to + SORT_ADDON_LENGTH_BYTES;
+  Field *field;
+  memset(nulls, 0, addonf->offset);
+  to= nulls + addonf->offset;
+  for ( ; (field= addonf->field) ; addonf++)
+  {
+    if (addonf->null_bit && field->is_null())
+      nulls[addonf->null_offset]|= addonf->null_bit;
+    else
+      to= field->pack(to, field->ptr);
   }
+  int2store(start, (uint) (to - start));
+  return to;
+}
+
+
+/** Make a sort-key from record. */
+
+static void make_sortkey(Sort_param *param, uchar *to, uchar *ref_pos)
+{
+  SORT_FIELD *sort_field;
+
+  for (sort_field=param->local_sortorder ;
+       sort_field != param->end ;
+       sort_field++)
+    to= make_sortkey_part(param, sort_field, to);
+
+  if (param->addon_field)
+    make_addon_fields(param, to);
   else
   {
     /* Save filepos last */
     memcpy((uchar*) to, ref_pos, (size_t) param->ref_length);
   }
-  return;
+}
+
+
+/**
+  Make a sort-key from record when the records are packed, see
+  Sort_param::using_packed_records(). Return the length of the record.
+*/
+
+static uint make_packed_sortkey(Sort_param *param, uchar *to, uchar *ref_pos)
+{
+  SORT_FIELD *sort_field;
+  uchar *start= to;
+
+  if (param->using_packed_sortkeys)
+    to+= SORT_KEY_LENGTH_BYTES;
+  for (sort_field=param->local_sortorder ;
+       sort_field != param->end ;
+       sort_field++)
+  {
+    if (sort_field->length_bytes)
+      to= make_packed_sortkey_part(sort_field, to);
+    else
+      to= make_sortkey_part(param, sort_field, to);
+  }
+  if (param->using_packed_sortkeys)
+    int4store(start, (uint) (to - start));
+
+  if (param->using_packed_addons)
+    to= make_packed_addon_fields(param, to);
+  else if (param->addon_field)
+  {
+    make_addon_fields(param, to);
+    to+= param->res_length;
+  }
+  else
+  {
+    memcpy(to, ref_pos, (size_t) param->ref_length);
+    to+= param->ref_length;
+  }
+  return (uint) (to - start);
+}
+
+
+/**
+  Compare two packed sort keys, see make_packed_sortkey().
+  With record references the references are compared as well, as they
+  are a part of the key when it is not packed.
+*/
+
+int Sort_param::compare_packed_keys(const uchar *a, const uchar *b) const
+{
+  a+= SORT_KEY_LENGTH_BYTES;
+  b+= SORT_KEY_LENGTH_BYTES;
+  for (SORT_FIELD *sort_field= local_sortorder; sort_field != end;
+       sort_field++)
+  {
+    int res;
+    if (!sort_field->length_bytes)
+    {
+      uint length= sort_field->length + sort_field->maybe_null;
+      if ((res= memcmp(a, b, length)))
+        return res;
+      a+= length;
+      b+= length;
+      continue;
+    }
+    if (sort_field->maybe_null)
+    {
+      if (*a != *b)
+      {
+        res= *a < *b ? -1 : 1;
+        return sort_field->reverse ? -res : res;
+      }
+      if (!*a++)
+      {
+        b++;
+        continue;                               // Both are NULL
+      }
+      b++;
+    }
+    uint length_a= read_packed_length(a, sort_field->length_bytes);
+    uint length_b= read_packed_length(b, sort_field->length_bytes);
+    CHARSET_INFO *cs= sort_field->cs;
+    a+= sort_field->length_bytes;
+    b+= sort_field->length_bytes;
+    if ((res= cs->coll->strnncollsp(cs, a, length_a, b, length_b)))
+      return sort_field->reverse ? -res : res;
+    a+= length_a;
+    b+= length_b;
+  }
+  return addon_field ? 0 : memcmp(a, b, ref_length);
+}
+
+
+static int cmp_packed_sort_keys(const void *param, const void *a,
+                                const void *b)
+{
+  return ((const Sort_param *) param)->
+    compare_packed_keys(*(const uchar **) a, *(const uchar **) b);
+}
+
+
+/**
+  The function that compares pointers to two records of the sort, and
+  its first argument.
+*/
+
+qsort2_cmp Sort_param::get_compare_function(void **arg)
+{
+  if (using_packed_sortkeys)
+  {
+    *arg= (void*) this;
+    return cmp_packed_sort_keys;
+  }
+  *arg= (void*) &compare_length;
+  return get_ptr_compare(compare_length);
 }
 
 
@@ -1295,25 +1681,39 @@ static void register_used_fields(Sort_param *param)
 }
 
 
+/*
+  Packed addon fields are copied into slots of their maximum length, so
+  that the result is read as the result of fixed length, see records.cc.
+*/
+
 static bool save_index(Sort_param *param, uint count,
-                       SORT_INFO *table_sort)
+                       SORT_INFO *table_sort, Parallel_sort *psort)
 {
-  uint offset,res_length;
-  uchar *to;
+  uint res_length;
+  uchar *to, **sort_keys;
   DBUG_ENTER("save_index");
   DBUG_ASSERT(table_sort->record_pointers == 0);
 
-  table_sort->sort_buffer(param, count);
+  if (psort->has_sorted_segments())
+  {
+    if (psort->merge_segments(count))
+      DBUG_RETURN(1);
+    sort_keys= psort->get_merged_keys();
+  }
+  else
+  {
+    table_sort->sort_buffer(param, count);
+    sort_keys= table_sort->get_sort_keys(param);
+  }
   res_length= param->res_length;
-  offset= param->rec_length-res_length;
   if (!(to= table_sort->record_pointers= 
         (uchar*) my_malloc(res_length*count,
                            MYF(MY_WME | MY_THREAD_SPECIFIC))))
     DBUG_RETURN(1);                 /* purecov: inspected */
-  uchar **sort_keys= table_sort->get_sort_keys();
   for (uchar **end= sort_keys+count ; sort_keys != end ; sort_keys++)
   {
-    memcpy(to, *sort_keys+offset, res_length);
+    uchar *res= *sort_keys + param->get_result_offset(*sort_keys);
+    memcpy(to, res, param->get_result_length(res));
     to+= res_length;
   }
   DBUG_RETURN(0);
@@ -1455,7 +1855,30 @@ static bool check_if_pq_applicable(Sort_param *param,
 }
 
 
-/** Merge buffers to make < MERGEBUFF2 buffers. */
+/*
+  Number of runs that merge_many_buff() merges into one
+
+  DESCRIPTION
+    The runs share the merge buffer, so the more of them are merged at
+    once, the fewer merge passes are needed but the shorter are the reads
+    from every run. As many runs are merged as get MERGE_MIN_RUN_BUFFER
+    bytes of the buffer each when the final merge takes 2 * fan-in + 1
+    runs, but never less than MERGEBUFF.
+*/
+
+static uint merge_fan_in(Sort_param *param)
+{
+  ulonglong runs= ((ulonglong) param->max_keys_per_buffer * param->rec_length /
+                   MERGE_MIN_RUN_BUFFER);
+  if (runs <= MERGEBUFF2)
+    return MERGEBUFF;
+  /* Every run must get room for a key */
+  set_if_smaller(runs, param->max_keys_per_buffer);
+  return (uint) ((runs - 1) / 2);
+}
+
+
+/** Merge buffers to make < 2 * merge_fan_in() + 1 buffers. */
 
 int merge_many_buff(Sort_param *param, uchar *sort_buffer,
                     BUFFPEK *buffpek, uint *maxbuffer, IO_CACHE *t_file)
@@ -1463,27 +1886,29 @@ int merge_many_buff(Sort_param *param, uchar *sort_buffer,
   uint i;
   IO_CACHE t_file2,*from_file,*to_file,*temp;
   BUFFPEK *lastbuff;
+  uint fan_in= merge_fan_in(param);
+  uint max_runs= fan_in * 2 + 1;
   DBUG_ENTER("merge_many_buff");
 
-  if (*maxbuffer < MERGEBUFF2)
+  if (*maxbuffer < max_runs)
     DBUG_RETURN(0);				/* purecov: inspected */
   if (flush_io_cache(t_file) ||
       open_cached_file(&t_file2,mysql_tmpdir,TEMP_PREFIX,DISK_BUFFER_SIZE,
-			MYF(MY_WME)))
+			MYF(MY_WME | MY_ASYNC_IO)))
     DBUG_RETURN(1);				/* purecov: inspected */
 
   from_file= t_file ; to_file= &t_file2;
-  while (*maxbuffer >= MERGEBUFF2)
+  while (*maxbuffer >= max_runs)
   {
     if (reinit_io_cache(from_file,READ_CACHE,0L,0,0))
       goto cleanup;
     if (reinit_io_cache(to_file,WRITE_CACHE,0L,0,0))
       goto cleanup;
     lastbuff=buffpek;
-    for (i=0 ; i <= *maxbuffer-MERGEBUFF*3/2 ; i+=MERGEBUFF)
+    for (i=0 ; i <= *maxbuffer-fan_in*3/2 ; i+=fan_in)
     {
       if (merge_buffers(param,from_file,to_file,sort_buffer,lastbuff++,
-			buffpek+i,buffpek+i+MERGEBUFF-1,0))
+			buffpek+i,buffpek+i+fan_in-1,0))
       goto cleanup;
     }
     if (merge_buffers(param,from_file,to_file,sort_buffer,lastbuff++,
@@ -1501,10 +1926,32 @@ int merge_many_buff(Sort_param *param, uchar *sort_buffer,
     *t_file=t_file2;				// Copy result file
   }
 
-  DBUG_RETURN(*maxbuffer >= MERGEBUFF2);	/* Return 1 if interrupted */
+  DBUG_RETURN(*maxbuffer >= max_runs);	/* Return 1 if interrupted */
 } /* merge_many_buff */
 
 
+/*
+  Ask the OS to read the next block of a run in the background
+
+  DESCRIPTION
+    The reads of the runs that are merged are interleaved, so the OS does
+    not see them as sequential reads of the file and does not read ahead.
+    The next block of a run is therefore requested as soon as a block is
+    read, to be in the page cache when the run needs it.
+*/
+
+static inline void read_ahead_run(IO_CACHE *fromfile, BUFFPEK *buffpek,
+                                  size_t length)
+{
+#ifdef HAVE_POSIX_FADVISE
+  /* Encrypted files are not read at the positions of the runs */
+  if (buffpek->count && !(fromfile->myflags & MY_ENCRYPT))
+    (void) posix_fadvise(fromfile->file, (off_t) buffpek->file_pos,
+                         (off_t) length, POSIX_FADV_WILLNEED);
+#endif
+}
+
+
 /**
   Read data to buffer.
 
@@ -1528,11 +1975,95 @@ ulong read_to_buffer(IO_CACHE *fromfile, BUFFPEK *buffpek,
     buffpek->file_pos+= length;			/* New filepos */
     buffpek->count-=	count;
     buffpek->mem_count= count;
+    read_ahead_run(fromfile, buffpek, length);
   }
   return (length);
 } /* read_to_buffer */
 
 
+/**
+  Read packed records to buffer, see Sort_param::using_packed_records().
+
+  As the records have different lengths, as many bytes are read as
+  max_keys records of the maximum length take, and only the complete
+  records among them are kept.
+
+  @retval  Number of bytes of the records read
+           (ulong)-1 if something goes wrong
+*/
+
+static ulong read_packed_to_buffer(IO_CACHE *fromfile, BUFFPEK *buffpek,
+                                   Sort_param *param)
+{
+  ha_rows count= 0;
+  uchar *rec, *end;
+  my_off_t length;
+
+  if (!buffpek->count)
+    return 0;
+  length= MY_MIN((my_off_t) buffpek->max_keys * param->rec_length,
+                 fromfile->end_of_file - buffpek->file_pos);
+  if (unlikely(my_b_pread(fromfile, (uchar*) buffpek->base, (size_t) length,
+                          buffpek->file_pos)))
+    return ((ulong) -1);
+  for (rec= buffpek->base, end= rec + length; count < buffpek->count; count++)
+  {
+    size_t left= (size_t) (end - rec);
+    uint rec_length;
+    if (param->using_packed_sortkeys && left < SORT_KEY_LENGTH_BYTES)
+      break;
+    rec_length= param->get_result_offset(rec) +
+                (param->using_packed_addons ? SORT_ADDON_LENGTH_BYTES :
+                                              param->res_length);
+    if (left < rec_length || left < (rec_length= param->get_record_length(rec)))
+      break;
+    rec+= rec_length;
+  }
+  DBUG_ASSERT(count);
+  buffpek->key= buffpek->base;
+  buffpek->file_pos+= rec - buffpek->base;
+  buffpek->count-= count;
+  buffpek->mem_count= count;
+  read_ahead_run(fromfile, buffpek, (size_t) length);
+  return (ulong) (rec - buffpek->base);
+}
+
+
+/** Read records of the sort to buffer, packed or not */
+
+static inline ulong read_keys_to_buffer(IO_CACHE *fromfile, BUFFPEK *buffpek,
+                                        Sort_param *param)
+{
+  if (param->using_packed_records())
+    return read_packed_to_buffer(fromfile, buffpek, param);
+  return read_to_buffer(fromfile, buffpek, param->rec_length);
+}
+
+
+/**
+  Give the room of a freed buffer to a buffer adjacent to it.
+
+  @retval  TRUE if bp took the room of reuse
+*/
+
+static bool reuse_freed_buff(BUFFPEK *bp, BUFFPEK *reuse, uint key_length)
+{
+  uchar *reuse_end= reuse->base + reuse->max_keys * key_length;
+  if (bp->base + bp->max_keys * key_length == reuse->base)
+  {
+    bp->max_keys+= reuse->max_keys;
+    return TRUE;
+  }
+  if (bp->base == reuse_end)
+  {
+    bp->base= reuse->base;
+    bp->max_keys+= reuse->max_keys;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+
 /**
   Put all room used by freed buffer to use in adjacent buffer.
 
@@ -1546,23 +2077,34 @@ ulong read_to_buffer(IO_CACHE *fromfile, BUFFPEK *buffpek,
 
 void reuse_freed_buff(QUEUE *queue, BUFFPEK *reuse, uint key_length)
 {
-  uchar *reuse_end= reuse->base + reuse->max_keys * key_length;
   for (uint i= queue_first_element(queue);
        i <= queue_last_element(queue);
        i++)
   {
-    BUFFPEK *bp= (BUFFPEK *) queue_element(queue, i);
-    if (bp->base + bp->max_keys * key_length == reuse->base)
-    {
-      bp->max_keys+= reuse->max_keys;
+    if (reuse_freed_buff((BUFFPEK *) queue_element(queue, i), reuse,
+                         key_length))
       return;
-    }
-    else if (bp->base == reuse_end)
-    {
-      bp->base= reuse->base;
-      bp->max_keys+= reuse->max_keys;
+  }
+  DBUG_ASSERT(0);
+}
+
+
+/**
+  Put all room used by freed buffer to use in adjacent buffer.
+
+  @param[in] tree       the merge, whose top buffer was removed
+  @param[in] reuse      empty buffer
+  @param[in] key_length key length
+*/
+
+static void reuse_freed_buff(Loser_tree *tree, BUFFPEK *reuse,
+                             uint key_length)
+{
+  for (uint i= 0; i < tree->leaf_elements(); i++)
+  {
+    BUFFPEK *bp= (BUFFPEK *) tree->leaf(i);
+    if (bp && reuse_freed_buff(bp, reuse, key_length))
       return;
-    }
   }
   DBUG_ASSERT(0);
 }
@@ -1593,19 +2135,20 @@ bool merge_buffers(Sort_param *param, IO_CACHE *from_file,
 {
   bool error= 0;
   uint rec_length,res_length,offset;
-  size_t sort_length;
   ulong maxcount, bytes_read;
   ha_rows max_rows,org_max_rows;
   my_off_t to_start_filepos;
   uchar *strpos;
   BUFFPEK *buffpek;
-  QUEUE queue;
+  Loser_tree tree;
   qsort2_cmp cmp;
   void *first_cmp_arg;
+  uint prefix_length= 0;
   element_count dupl_count= 0;
   uchar *src;
   uchar *unique_buff= param->unique_buff;
   const bool killable= !param->not_killable;
+  const bool packed= param->using_packed_records();
   THD* const thd=current_thd;
   DBUG_ENTER("merge_buffers");
 
@@ -1614,7 +2157,6 @@ bool merge_buffers(Sort_param *param, IO_CACHE *from_file,
 
   rec_length= param->rec_length;
   res_length= param->res_length;
-  sort_length= param->sort_length;
   uint dupl_count_ofs= rec_length-sizeof(element_count);
   uint min_dupl_count= param->min_dupl_count;
   bool check_dupl_count= flag && min_dupl_count;
@@ -1636,23 +2178,27 @@ bool merge_buffers(Sort_param *param, IO_CACHE *from_file,
   }
   else
   {
-    cmp= get_ptr_compare(sort_length);
-    first_cmp_arg= (void*) &sort_length;
+    cmp= param->get_compare_function(&first_cmp_arg);
+    /* Fixed size keys are compared as byte strings */
+    if (!param->using_packed_sortkeys)
+      prefix_length= param->compare_length;
   }
-  if (unlikely(init_queue(&queue, (uint) (Tb-Fb)+1, offsetof(BUFFPEK,key), 0,
-                          (queue_compare) cmp, first_cmp_arg, 0, 0)))
+  if (unlikely(tree.init((uint) (Tb-Fb)+1, offsetof(BUFFPEK,key), 0,
+                          (Loser_tree::Compare) cmp, first_cmp_arg,
+                          prefix_length)))
     DBUG_RETURN(1);                                /* purecov: inspected */
   for (buffpek= Fb ; buffpek <= Tb ; buffpek++)
   {
     buffpek->base= strpos;
     buffpek->max_keys= maxcount;
-    bytes_read= read_to_buffer(from_file, buffpek, rec_length);
+    bytes_read= read_keys_to_buffer(from_file, buffpek, param);
     if (unlikely(bytes_read == (ulong) -1))
       goto err;					/* purecov: inspected */
 
-    strpos+= bytes_read;
-    buffpek->max_keys= buffpek->mem_count;	// If less data in buffers than expected
-    queue_insert(&queue, (uchar*) buffpek);
+    // If less data in buffers than expected
+    set_if_smaller(buffpek->max_keys, buffpek->mem_count);
+    strpos+= buffpek->max_keys * rec_length;
+    tree.insert((uchar*) buffpek);
   }
 
   if (unique_buff)
@@ -1662,36 +2208,36 @@ bool merge_buffers(Sort_param *param, IO_CACHE *from_file,
        Copy the first argument to unique_buff for unique removal.
        Store it also in 'to_file'.
     */
-    buffpek= (BUFFPEK*) queue_top(&queue);
+    buffpek= (BUFFPEK*) tree.top();
     memcpy(unique_buff, buffpek->key, rec_length);
     if (min_dupl_count)
       memcpy(&dupl_count, unique_buff+dupl_count_ofs, 
              sizeof(dupl_count));
     buffpek->key+= rec_length;
-    if (! --buffpek->mem_count)
+    if (--buffpek->mem_count)
+      tree.replace_top();            // Top element has been used
+    else if (unlikely(!(bytes_read= read_to_buffer(from_file, buffpek,
+                                                   rec_length))))
     {
-      if (unlikely(!(bytes_read= read_to_buffer(from_file, buffpek,
-                                                rec_length))))
-      {
-        (void) queue_remove_top(&queue);
-        reuse_freed_buff(&queue, buffpek, rec_length);
-      }
-      else if (unlikely(bytes_read == (ulong) -1))
-        goto err;                        /* purecov: inspected */ 
+      tree.remove_top();
+      reuse_freed_buff(&tree, buffpek, rec_length);
     }
-    queue_replace_top(&queue);            // Top element has been used
+    else if (unlikely(bytes_read == (ulong) -1))
+      goto err;                        /* purecov: inspected */ 
+    else
+      tree.replace_top();
   }
   else
     cmp= 0;                                        // Not unique
 
-  while (queue.elements > 1)
+  while (tree.elements() > 1)
   {
     if (killable && unlikely(thd->check_killed()))
       goto err;                               /* purecov: inspected */
 
     for (;;)
     {
-      buffpek= (BUFFPEK*) queue_top(&queue);
+      buffpek= (BUFFPEK*) tree.top();
       src= buffpek->key;
       if (cmp)                                        // Remove duplicates
       {
@@ -1722,6 +2268,12 @@ bool merge_buffers(Sort_param *param, IO_CACHE *from_file,
         then for any element:
         dupl_count >= N <=> the element is occurred in each of these N sets.
       */          
+      if (packed)
+      {
+        wr_offset= flag ? param->get_result_offset(src) : 0;
+        wr_len= flag ? param->get_result_length(src + wr_offset) :
+                       param->get_record_length(src);
+      }
       if (!check_dupl_count || dupl_count >= min_dupl_count)
       {
         if (my_b_write(to_file, src+wr_offset, wr_len))
@@ -1741,23 +2293,24 @@ bool merge_buffers(Sort_param *param, IO_CACHE *from_file,
       }
 
     skip_duplicate:
-      buffpek->key+= rec_length;
+      buffpek->key+= packed ? param->get_record_length(buffpek->key) :
+                              rec_length;
       if (! --buffpek->mem_count)
       {
-        if (unlikely(!(bytes_read= read_to_buffer(from_file, buffpek,
-                                                  rec_length))))
+        if (unlikely(!(bytes_read= read_keys_to_buffer(from_file, buffpek,
+                                                       param))))
         {
-          (void) queue_remove_top(&queue);
-          reuse_freed_buff(&queue, buffpek, rec_length);
+          tree.remove_top();
+          reuse_freed_buff(&tree, buffpek, rec_length);
           break;                        /* One buffer have been removed */
         }
         else if (unlikely(bytes_read == (ulong) -1))
           goto err;                        /* purecov: inspected */
       }
-      queue_replace_top(&queue);   	/* Top element has been replaced */
+      tree.replace_top();   	/* Top element has been replaced */
     }
   }
-  buffpek= (BUFFPEK*) queue_top(&queue);
+  buffpek= (BUFFPEK*) tree.top();
   buffpek->base= (uchar*) sort_buffer;
   buffpek->max_keys= param->max_keys_per_buffer;
 
@@ -1801,7 +2354,20 @@ bool merge_buffers(Sort_param *param, IO_CACHE *from_file,
       buffpek->count= 0;                        /* Don't read more */
     }
     max_rows-= buffpek->mem_count;
-    if (flag == 0)
+    if (packed)
+    {
+      uchar *key= buffpek->key;
+      for (ha_rows count= buffpek->mem_count; count--; )
+      {
+        uint length= param->get_record_length(key);
+        wr_offset= flag ? param->get_result_offset(key) : 0;
+        wr_len= flag ? param->get_result_length(key + wr_offset) : length;
+        if (my_b_write(to_file, key + wr_offset, wr_len))
+          goto err;
+        key+= length;
+      }
+    }
+    else if (flag == 0)
     {
       if (my_b_write(to_file, (uchar*) buffpek->key,
                      (size_t)(rec_length*buffpek->mem_count)))
@@ -1827,15 +2393,15 @@ bool merge_buffers(Sort_param *param, IO_CACHE *from_file,
     }
   }
   while (likely(!(error=
-                  (bytes_read= read_to_buffer(from_file, buffpek,
-                                              rec_length)) == (ulong) -1)) &&
+                  (bytes_read= read_keys_to_buffer(from_file, buffpek,
+                                                   param)) == (ulong) -1)) &&
          bytes_read != 0);
 
 end:
   lastbuff->count= MY_MIN(org_max_rows-max_rows, param->max_rows);
   lastbuff->file_pos= to_start_filepos;
 cleanup:
-  delete_queue(&queue);
+  tree.end();
   DBUG_RETURN(error);
 
 err:
@@ -1966,6 +2532,7 @@ sortlength(THD *thd, SORT_FIELD *sortorder, uint s_length,
   for (; s_length-- ; sortorder++)
   {
     sortorder->suffix_length= 0;
+    sortorder->length_bytes= 0;
     if (sortorder->field)
     {
       CHARSET_INFO *cs= sortorder->field->sort_charset();
@@ -2076,10 +2643,12 @@ get_addon_fields(TABLE *table, uint sortlength, LEX_STRING *addon_buf)
   if (table->file->ha_table_flags() & HA_SLOW_RND_POS)
     sortlength= 0;
 
+  /* The buffer has space for the length of packed addon fields */
   if (!filesort_use_addons(table, sortlength, &length, &fields, &null_fields) ||
       !my_multi_malloc(MYF(MY_WME | MY_THREAD_SPECIFIC), &addonf,
                        sizeof(SORT_ADDON_FIELD) * (fields+1),
-                       &addon_buf->str, length, NullS))
+                       &addon_buf->str, length + SORT_ADDON_LENGTH_BYTES,
+                       NullS))
 
     DBUG_RETURN(0);
 
@@ -2148,6 +2717,35 @@ unpack_addon_fields(struct st_sort_addon_field *addon_field, uchar *buff,
   }
 }
 
+
+/**
+  Copy (unpack) packed values appended to sorted fields from a buffer back
+  to their regular positions, see make_packed_addon_fields().
+  The end of the values is found from their length, buff_end is ignored.
+*/
+
+static void
+unpack_packed_addon_fields(struct st_sort_addon_field *addon_field,
+                           uchar *buff, uchar *buff_end)
+{
+  Field *field;
+  SORT_ADDON_FIELD *addonf= addon_field;
+  uchar *nulls= buff + SORT_ADDON_LENGTH_BYTES;
+  const uchar *pos= nulls + addonf->offset;
+
+  buff_end= buff + uint2korr(buff);
+  for ( ; (field= addonf->field) ; addonf++)
+  {
+    if (addonf->null_bit && (addonf->null_bit & nulls[addonf->null_offset]))
+    {
+      field->set_null();
+      continue;
+    }
+    field->set_notnull();
+    pos= field->unpack(field->ptr, pos, buff_end, 0);
+  }
+}
+
 /*
 ** functions to change a double or float to a sortable string
 ** The following should work for IEEE
@@ -2196,6 +2794,13 @@ void change_double_for_sort(double nr,uchar *to)
   }
 }
 
+uchar **SORT_INFO::get_sort_keys(const Sort_param *param)
+{
+  return param->using_packed_records() ? filesort_buffer.get_packed_keys() :
+                                         filesort_buffer.get_sort_keys();
+}
+
+
 /**
    Free SORT_INFO
 */
@@ -87,7 +87,7 @@ class SORT_INFO
 
 public:
   SORT_INFO()
-    :addon_field(0), record_pointers(0)
+    :addon_field(0), using_packed_addons(false), record_pointers(0)
   {
     buffpek.str= 0;
     my_b_clear(&io_cache);
@@ -118,6 +118,8 @@ class SORT_INFO
   struct st_sort_addon_field *addon_field;     /* Pointer to the fields info */
   /* To unpack back */
   void    (*unpack)(struct st_sort_addon_field *, uchar *, uchar *);
+  /* The addon fields of the result start with their length */
+  bool      using_packed_addons;
   uchar     *record_pointers;    /* If sorted in memory */
   /*
     How many rows in final result.
@@ -140,6 +142,27 @@ class SORT_INFO
   uchar **get_sort_keys()
   { return filesort_buffer.get_sort_keys(); }
 
+  /// The keys to sort, which are in the packed area for packed records
+  uchar **get_sort_keys(const Sort_param *param);
+
+  void init_packed_area()
+  { filesort_buffer.init_packed_area(); }
+
+  void init_packed_area(uchar **start, uchar **end)
+  { filesort_buffer.init_packed_area(start, end); }
+
+  bool packed_area_full(uint max_length) const
+  { return filesort_buffer.packed_area_full(max_length); }
+
+  uchar *get_packed_record_buffer()
+  { return filesort_buffer.get_packed_record_buffer(); }
+
+  void add_packed_record(uint length)
+  { filesort_buffer.add_packed_record(length); }
+
+  size_t sort_buffer_size() const
+  { return filesort_buffer.sort_buffer_size(); }
+
   uchar **alloc_sort_buffer(uint num_records, uint record_length)
   { return filesort_buffer.alloc_sort_buffer(num_records, record_length); }
 
@@ -149,9 +172,6 @@ class SORT_INFO
   void init_record_pointers()
   { filesort_buffer.init_record_pointers(); }
 
-  size_t sort_buffer_size() const
-  { return filesort_buffer.sort_buffer_size(); }
-
   friend SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
                              Filesort_tracker* tracker, JOIN *join,
                              table_map first_table_bit);
@@ -0,0 +1,997 @@
+/*
+   Copyright (c) 2019, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+/*
+  This file implements the threads that sort and merge for filesort().
+  See filesort_parallel.h for the overview and find_all_keys() in
+  filesort.cc for how the segments are filled.
+*/
+
+#include "mariadb.h"
+#include "sql_priv.h"
+#include "filesort_parallel.h"
+#include "filesort.h"
+#include "filesort_utils.h"
+#include "loser_tree.h"
+#include "sql_class.h"
+#include "mysqld.h"                     // key_thread_parallel_sort
+
+/* The smallest number of keys in a segment of the sort buffer */
+#define PARALLEL_SORT_MIN_SEGMENT_KEYS 128
+/* The smallest number of keys read from a run at once in a merge */
+#define PARALLEL_SORT_MIN_MERGE_KEYS 16
+
+
+pthread_handler_t parallel_sort_thread(void *arg)
+{
+  Parallel_sort *sort= (Parallel_sort *) arg;
+  my_thread_init();
+  sort->work();
+  my_thread_end();
+  return 0;
+}
+
+
+/*
+  Prepare a parallel sort for the sort buffer of filesort()
+
+  SYNOPSIS
+    init()
+      thd_arg      the thread of the query
+      param_arg    the sort parameters, max_keys_per_buffer is set
+      info         the sort, its buffer is allocated
+      num_rows     upper bound of the number of rows to sort
+
+  DESCRIPTION
+    The buffer is divided into one segment per thread, unless the segments
+    would be too small. Nothing is done if max_sort_threads is 1 or if all
+    rows fit into one segment. The threads are started only when the first
+    segment is full, see next_segment().
+    For packed records the segments are areas of slots of pointer size,
+    and the area of the first segment is set up to be filled.
+*/
+
+void Parallel_sort::init(THD *thd_arg, Sort_param *param_arg,
+                         SORT_INFO *info, ha_rows num_rows)
+{
+  uint max_keys= param_arg->max_keys_per_buffer;
+  uint slots= max_keys;
+  uint count;
+  DBUG_ENTER("Parallel_sort::init");
+
+  threads= (uint) thd_arg->variables.max_sort_threads;
+  count= threads;
+  if (count > 1 && max_keys / count < PARALLEL_SORT_MIN_SEGMENT_KEYS)
+    count= max_keys / PARALLEL_SORT_MIN_SEGMENT_KEYS;
+  if (count < 2 || num_rows <= max_keys / count)
+    DBUG_VOID_RETURN;
+
+  if (!(segments= (Sort_segment *) my_malloc(count * sizeof(Sort_segment),
+                                             MYF(MY_THREAD_SPECIFIC))) ||
+      !(workers= (pthread_t *) my_malloc(count * sizeof(pthread_t),
+                                         MYF(MY_THREAD_SPECIFIC))))
+  {
+    my_free(segments);
+    DBUG_VOID_RETURN;
+  }
+  if (param_arg->using_packed_records())
+    slots= (uint) (info->sort_buffer_size() / sizeof(uchar*));
+  for (uint i= 0; i < count; i++)
+  {
+    segments[i].start= i * (slots / count);
+    segments[i].end= i + 1 < count ? segments[i].start + slots / count :
+                                     slots;
+    segments[i].count= 0;
+    segments[i].state= SEGMENT_FREE;
+    segments[i].sorted= FALSE;
+  }
+  thd= thd_arg;
+  param= param_arg;
+  this->info= info;
+  sort_keys= info->get_sort_keys();
+  if (param->using_packed_records())
+    info->init_packed_area(sort_keys + segments[0].start,
+                           sort_keys + segments[0].end);
+  buffpek_pointers= tempfile= outfile= NULL;
+  segment_count= count;
+  current= 0;
+  handed_over= FALSE;
+  started= 0;
+  spill= stop= FALSE;
+  error= 0;
+  merge_type= NO_MERGE;
+  part_count= next_part= parts_done= 0;
+  bounds= part_starts= NULL;
+  merged= NULL;
+  cursors= NULL;
+  runs= run_cursors= NULL;
+  mysql_mutex_init(key_LOCK_parallel_sort, &lock, MY_MUTEX_INIT_FAST);
+  mysql_mutex_init(key_LOCK_parallel_sort_write, &write_lock,
+                   MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_COND_parallel_sort, &cond, NULL);
+  initialized= TRUE;
+  DBUG_PRINT("info", ("parallel sort with %u segments of %u keys",
+                      segment_count, max_keys / count));
+  DBUG_VOID_RETURN;
+}
+
+
+/* Stop the threads and free the memory of the sort */
+
+void Parallel_sort::end()
+{
+  if (!initialized)
+    return;
+  mysql_mutex_lock(&lock);
+  stop= TRUE;
+  mysql_cond_broadcast(&cond);
+  mysql_mutex_unlock(&lock);
+  for (uint i= 0; i < started; i++)
+    pthread_join(workers[i], NULL);
+  mysql_mutex_destroy(&lock);
+  mysql_mutex_destroy(&write_lock);
+  mysql_cond_destroy(&cond);
+  my_free(segments);
+  my_free(workers);
+  my_free(merged);
+  merged= NULL;
+  initialized= FALSE;
+  handed_over= FALSE;
+  spill= FALSE;
+}
+
+
+void Parallel_sort::start_workers()
+{
+  uint count= MY_MIN(threads, segment_count) - 1;
+  for (; started < count; started++)
+  {
+    /* The threads are joined, so connection_attrib cannot be used */
+    if (mysql_thread_create(key_thread_parallel_sort, workers + started,
+                            NULL, parallel_sort_thread, this))
+      break;
+  }
+  DBUG_PRINT("info", ("started %u sort threads", started));
+}
+
+
+/* Remember the first error of a thread, to be reported by report_error() */
+
+void Parallel_sort::set_error(uint code, File file, int errnr)
+{
+  mysql_mutex_lock(&lock);
+  if (!error)
+  {
+    error= code;
+    error_file= file;
+    error_errno= errnr;
+  }
+  mysql_cond_broadcast(&cond);
+  mysql_mutex_unlock(&lock);
+}
+
+
+/*
+  Report the error of a thread in the thread of the query
+
+  RETURN VALUE
+    TRUE     a thread failed or the query was killed
+    FALSE    OK
+*/
+
+bool Parallel_sort::report_error()
+{
+  mysql_mutex_assert_owner(&lock);
+  if (error)
+  {
+    my_error(error, MYF(0), my_filename(error_file), error_errno);
+    return TRUE;
+  }
+  return thd->killed != NOT_KILLED;
+}
+
+
+/*
+  Take the next task for a thread
+
+  SYNOPSIS
+    take_task()
+      segment   OUT: the segment to sort or write, UINT_MAX if none
+      part      OUT: the part of a merge, UINT_MAX if none
+
+  DESCRIPTION
+    The queued segments are taken in the order in which the thread of the
+    query is going to fill them again, starting with the current segment,
+    which the thread of the query may be waiting for.
+
+  RETURN VALUE
+    TRUE     a task is taken
+    FALSE    there is nothing to do now
+*/
+
+bool Parallel_sort::take_task(uint *segment, uint *part)
+{
+  mysql_mutex_assert_owner(&lock);
+  if (stop || error)
+    return FALSE;
+  for (uint i= 0; i < segment_count; i++)
+  {
+    uint nr= (current + i) % segment_count;
+    if (segments[nr].state == SEGMENT_QUEUED)
+    {
+      segments[nr].state= SEGMENT_BUSY;
+      *segment= nr;
+      *part= UINT_MAX;
+      return TRUE;
+    }
+  }
+  if (next_part < part_count)
+  {
+    *segment= UINT_MAX;
+    *part= next_part++;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+
+/*
+  Sort a segment and write it as a run if the segments are written
+
+  DESCRIPTION
+    A segment that is sorted before the first one is written is kept in
+    memory. When the thread of the query starts writing, it queues the
+    sorted segments again, so that they are only written.
+*/
+
+void Parallel_sort::run_task(uint segment, uint part)
+{
+  if (part != UINT_MAX)
+  {
+    if (merge_type == MEMORY_MERGE)
+      merge_memory_part(part);
+    else
+      merge_file_part(part);
+    mysql_mutex_lock(&lock);
+    parts_done++;
+    mysql_cond_broadcast(&cond);
+    mysql_mutex_unlock(&lock);
+    return;
+  }
+
+  Sort_segment *seg= segments + segment;
+  if (!seg->sorted)
+    Filesort_buffer::sort_keys(segment_keys(seg), seg->count, param, MYF(0));
+  mysql_mutex_lock(&lock);
+  seg->sorted= TRUE;
+  if (!spill)
+  {
+    seg->state= SEGMENT_SORTED;
+    mysql_cond_broadcast(&cond);
+    mysql_mutex_unlock(&lock);
+    return;
+  }
+  mysql_mutex_unlock(&lock);
+
+  if (write_segment(seg))
+    set_error(ER_ERROR_ON_WRITE, tempfile->file, my_errno);
+  mysql_mutex_lock(&lock);
+  seg->state= SEGMENT_FREE;
+  mysql_cond_broadcast(&cond);
+  mysql_mutex_unlock(&lock);
+}
+
+
+/* The loop of a sort thread */
+
+void Parallel_sort::work()
+{
+  uint segment, part;
+  mysql_mutex_lock(&lock);
+  for (;;)
+  {
+    if (take_task(&segment, &part))
+    {
+      mysql_mutex_unlock(&lock);
+      run_task(segment, part);
+      mysql_mutex_lock(&lock);
+      continue;
+    }
+    if (stop)
+      break;
+    mysql_cond_wait(&cond, &lock);
+  }
+  mysql_mutex_unlock(&lock);
+}
+
+
+/*
+  Do a task or wait for the threads in the thread of the query
+
+  DESCRIPTION
+    Called with the lock held in a loop that waits for the threads. Rather
+    than waiting, the thread of the query does a task itself if there is
+    one, so that the sort goes on even if no thread could be started.
+
+  RETURN VALUE
+    TRUE     stop waiting: a thread failed or the query was killed
+    FALSE    check the state again
+*/
+
+bool Parallel_sort::help_or_wait()
+{
+  uint segment, part;
+  mysql_mutex_assert_owner(&lock);
+  if (error || thd->killed)
+    return TRUE;
+  if (take_task(&segment, &part))
+  {
+    mysql_mutex_unlock(&lock);
+    run_task(segment, part);
+    mysql_mutex_lock(&lock);
+    return FALSE;
+  }
+  PSI_stage_info old_stage;
+  thd->ENTER_COND(&cond, &lock, &stage_waiting_for_sort_threads, &old_stage);
+  if (!thd->killed)
+    mysql_cond_wait(&cond, &lock);
+  thd->EXIT_COND(&old_stage);
+  mysql_mutex_lock(&lock);
+  return FALSE;
+}
+
+
+/*
+  Write a sorted segment as a run into the temporary file
+
+  DESCRIPTION
+    The same as write_keys() in filesort.cc does for the whole buffer.
+    The runs are written one at a time, in the order in which they are
+    sorted.
+
+  RETURN VALUE
+    FALSE    OK
+    TRUE     write error
+*/
+
+bool Parallel_sort::write_segment(Sort_segment *seg)
+{
+  uchar **keys= segment_keys(seg), **keys_end;
+  uint count= seg->count;
+  BUFFPEK buffpek;
+  bool res= TRUE;
+
+  mysql_mutex_lock(&write_lock);
+  /* check we won't have more buffpeks than we can possibly keep in memory */
+  if (my_b_tell(buffpek_pointers) + sizeof(BUFFPEK) > (ulonglong) UINT_MAX)
+    goto end;
+  bzero(&buffpek, sizeof(buffpek));
+  buffpek.file_pos= my_b_tell(tempfile);
+  if ((ha_rows) count > param->max_rows)
+    count= (uint) param->max_rows;
+  buffpek.count= (ha_rows) count;
+  for (keys_end= keys + count; keys != keys_end; keys++)
+    if (my_b_write(tempfile, *keys, param->get_record_length(*keys)))
+      goto end;
+  if (my_b_write(buffpek_pointers, (uchar*) &buffpek, sizeof(buffpek)))
+    goto end;
+  param->written_rows+= count;
+  res= FALSE;
+end:
+  mysql_mutex_unlock(&write_lock);
+  return res;
+}
+
+
+/*
+  Hand a full segment over to the threads and get the next one
+
+  SYNOPSIS
+    next_segment()
+      idx                   IN:  the number of keys in the area of packed
+                                 records
+                            OUT: the index of the first key of the segment,
+                                 0 for packed records
+      buffpek_pointers_arg  the file for the BUFFPEKs of the runs
+      tempfile_arg          the file for the runs
+
+  DESCRIPTION
+    When the segments are used up for the first time, the rows do not fit
+    into the sort buffer and all segments are written as runs from now on.
+    The function waits until the next segment is free, doing the tasks of
+    the threads meanwhile.
+
+  RETURN VALUE
+    FALSE    OK
+    TRUE     error, reported, or the query was killed
+*/
+
+bool Parallel_sort::next_segment(uint *idx, IO_CACHE *buffpek_pointers_arg,
+                                 IO_CACHE *tempfile_arg)
+{
+  uint next= (current + 1) % segment_count;
+  bool res;
+  DBUG_ENTER("Parallel_sort::next_segment");
+
+  if (!handed_over)
+  {
+    start_workers();
+    handed_over= TRUE;
+  }
+  if (next == 0 && !spill)
+  {
+    buffpek_pointers= buffpek_pointers_arg;
+    tempfile= tempfile_arg;
+    /*
+      Create the files here rather than when a thread fills their caches,
+      so that the memory for their names is counted for this thread.
+    */
+    if ((!my_b_inited(tempfile) &&
+         open_cached_file(tempfile, mysql_tmpdir, TEMP_PREFIX,
+                          DISK_BUFFER_SIZE, MYF(MY_WME | MY_ASYNC_IO))) ||
+        (tempfile->file == -1 && real_open_cached_file(tempfile)) ||
+        (buffpek_pointers->file == -1 &&
+         real_open_cached_file(buffpek_pointers)))
+      DBUG_RETURN(TRUE);
+  }
+
+  mysql_mutex_lock(&lock);
+  segments[current].count= (param->using_packed_records() ? *idx :
+                            segments[current].end - segments[current].start);
+  segments[current].state= SEGMENT_QUEUED;
+  segments[current].sorted= FALSE;
+  if (next == 0 && !spill)
+  {
+    DBUG_PRINT("info", ("writing the sorted segments"));
+    spill= TRUE;
+    for (uint i= 0; i < segment_count; i++)
+      if (segments[i].state == SEGMENT_SORTED)
+        segments[i].state= SEGMENT_QUEUED;
+  }
+  current= next;
+  mysql_cond_broadcast(&cond);
+  while (segments[current].state != SEGMENT_FREE && !help_or_wait())
+  {}
+  res= report_error();
+  mysql_mutex_unlock(&lock);
+  if (param->using_packed_records())
+  {
+    info->init_packed_area(sort_keys + segments[current].start,
+                           sort_keys + segments[current].end);
+    *idx= 0;
+  }
+  else
+    *idx= segments[current].start;
+  DBUG_RETURN(res);
+}
+
+
+/*
+  Hand the last segment over to the threads and wait for all segments
+
+  SYNOPSIS
+    finish_segments()
+      idx       IN:  the index after the last key in the sort buffer, or
+                     the number of keys in the area of packed records
+                OUT: the number of keys in the sort buffer
+
+  DESCRIPTION
+    If no segment was full, the keys are left to be sorted by the caller.
+
+  RETURN VALUE
+    FALSE    OK
+    TRUE     error, reported, or the query was killed
+*/
+
+bool Parallel_sort::finish_segments(uint *idx)
+{
+  Sort_segment *seg= segments + current;
+  bool res;
+  DBUG_ENTER("Parallel_sort::finish_segments");
+
+  if (!handed_over)
+    DBUG_RETURN(FALSE);
+  mysql_mutex_lock(&lock);
+  if ((seg->count= param->using_packed_records() ? *idx : *idx - seg->start))
+  {
+    seg->state= SEGMENT_QUEUED;
+    seg->sorted= FALSE;
+    mysql_cond_broadcast(&cond);
+  }
+  for (;;)
+  {
+    bool busy= FALSE;
+    for (uint i= 0; i < segment_count; i++)
+      if (segments[i].state == SEGMENT_QUEUED ||
+          segments[i].state == SEGMENT_BUSY)
+        busy= TRUE;
+    if (!busy || help_or_wait())
+      break;
+  }
+  res= report_error();
+  mysql_mutex_unlock(&lock);
+  if (!spill)
+  {
+    *idx= 0;
+    for (uint i= 0; i < segment_count; i++)
+      *idx+= segments[i].count;
+  }
+  DBUG_RETURN(res);
+}
+
+
+/*
+  Let the threads merge the parts of a merge
+
+  DESCRIPTION
+    If a thread fails or the query is killed, no further parts are taken
+    and the function waits only for the parts being merged.
+
+  RETURN VALUE
+    FALSE    OK
+    TRUE     error, reported, or the query was killed
+*/
+
+bool Parallel_sort::run_merge(Merge_type type, uint parts)
+{
+  bool res;
+  mysql_mutex_lock(&lock);
+  merge_type= type;
+  part_count= parts;
+  next_part= parts_done= 0;
+  mysql_cond_broadcast(&cond);
+  while (parts_done < part_count)
+  {
+    if (help_or_wait())
+    {
+      uint taken= next_part;
+      next_part= part_count;
+      while (parts_done < taken)
+        mysql_cond_wait(&cond, &lock);
+      break;
+    }
+  }
+  res= report_error();
+  part_count= next_part= parts_done= 0;
+  merge_type= NO_MERGE;
+  mysql_mutex_unlock(&lock);
+  return res;
+}
+
+
+/* The number of keys in a sorted array less than the key */
+
+static uint lower_bound(uchar **keys, uint count, uchar **key,
+                        qsort2_cmp cmp, void *cmp_arg)
+{
+  uint low= 0, high= count;
+  while (low < high)
+  {
+    uint mid= (low + high) / 2;
+    if (cmp(cmp_arg, keys + mid, key) < 0)
+      low= mid + 1;
+    else
+      high= mid;
+  }
+  return low;
+}
+
+
+/* Merge the keys of one part of the sorted segments into 'merged' */
+
+void Parallel_sort::merge_memory_part(uint part)
+{
+  Merge_cursor *cursor= cursors + part * segment_count;
+  uchar **to= merged + part_starts[part];
+  void *cmp_arg;
+  qsort2_cmp cmp= param->get_compare_function(&cmp_arg);
+  Loser_tree tree;
+
+  if (tree.init(segment_count, offsetof(Merge_cursor, key), 0,
+                (Loser_tree::Compare) cmp, cmp_arg,
+                param->using_packed_sortkeys ? 0 : param->compare_length,
+                MYF(0)))
+  {
+    set_error(ER_OUT_OF_RESOURCES, -1, 0);
+    return;
+  }
+  for (uint i= 0; i < segment_count; i++)
+  {
+    uchar **keys= segment_keys(segments + i);
+    ha_rows *bound= bounds + i * (part_count + 1) + part;
+    if (bound[0] < bound[1])
+    {
+      cursor->key= keys[bound[0]];
+      cursor->next= keys + bound[0] + 1;
+      cursor->end= keys + bound[1];
+      tree.insert((uchar*) cursor);
+      cursor++;
+    }
+  }
+  while (tree.elements() > 1)
+  {
+    cursor= (Merge_cursor*) tree.top();
+    *to++= cursor->key;
+    if (cursor->next == cursor->end)
+      tree.remove_top();
+    else
+    {
+      cursor->key= *cursor->next++;
+      tree.replace_top();
+    }
+  }
+  if (tree.elements())
+  {
+    cursor= (Merge_cursor*) tree.top();
+    *to++= cursor->key;
+    while (cursor->next != cursor->end)
+      *to++= *cursor->next++;
+  }
+}
+
+
+/*
+  Merge the sorted segments when all keys fit into the sort buffer
+
+  SYNOPSIS
+    merge_segments()
+      count     the number of keys in the buffer
+
+  DESCRIPTION
+    Every thread takes P-1 keys evenly spread over each segment as
+    samples, P being the number of threads. The samples are sorted and
+    P-1 of them evenly spread are the splitters of the parts of the merge.
+    The parts are merged into a separate array of key pointers, which is
+    kept until end().
+
+  RETURN VALUE
+    FALSE    OK, get_merged_keys() returns the sorted pointers
+    TRUE     error, reported, or the query was killed
+*/
+
+bool Parallel_sort::merge_segments(uint count)
+{
+  uint parts= started + 1;
+  void *cmp_arg;
+  qsort2_cmp cmp= param->get_compare_function(&cmp_arg);
+  uchar **samples= NULL;
+  uint sample_count= 0;
+  bool res= TRUE;
+  DBUG_ENTER("Parallel_sort::merge_segments");
+
+  if (!(bounds= (ha_rows *) my_malloc(segment_count * (parts + 1) *
+                                      sizeof(ha_rows),
+                                      MYF(MY_WME | MY_THREAD_SPECIFIC))) ||
+      !(part_starts= (ha_rows *) my_malloc((parts + 1) * sizeof(ha_rows),
+                                           MYF(MY_WME | MY_THREAD_SPECIFIC |
+                                               MY_ZEROFILL))) ||
+      !(cursors= (Merge_cursor *) my_malloc(parts * segment_count *
+                                            sizeof(Merge_cursor),
+                                            MYF(MY_WME |
+                                                MY_THREAD_SPECIFIC))) ||
+      !(samples= (uchar **) my_malloc(segment_count * parts * sizeof(uchar*),
+                                      MYF(MY_WME | MY_THREAD_SPECIFIC))) ||
+      !(merged= (uchar **) my_malloc(count * sizeof(uchar*),
+                                     MYF(MY_WME | MY_THREAD_SPECIFIC))))
+    goto end;
+
+  for (uint i= 0; i < segment_count; i++)
+  {
+    uchar **keys= segment_keys(segments + i);
+    for (uint j= 1; j < parts && segments[i].count; j++)
+      samples[sample_count++]= keys[(ulonglong) segments[i].count * j / parts];
+  }
+  my_qsort2(samples, sample_count, sizeof(uchar*), cmp, cmp_arg);
+
+  for (uint i= 0; i < segment_count; i++)
+  {
+    ha_rows *bound= bounds + i * (parts + 1);
+    bound[0]= 0;
+    bound[parts]= segments[i].count;
+    for (uint j= 1; j < parts; j++)
+    {
+      bound[j]= lower_bound(segment_keys(segments + i), segments[i].count,
+                            samples + sample_count * j / parts, cmp, cmp_arg);
+      part_starts[j]+= bound[j];
+    }
+  }
+  part_starts[parts]= count;
+
+  res= run_merge(MEMORY_MERGE, parts);
+
+end:
+  my_free(samples);
+  my_free(cursors);
+  my_free(part_starts);
+  my_free(bounds);
+  cursors= NULL;
+  bounds= part_starts= NULL;
+  DBUG_RETURN(res);
+}
+
+
+/*
+  Merge the keys of one part of the runs into the result file
+
+  DESCRIPTION
+    Like merge_buffers() with flag 1, only the result part of the records
+    is written. The output is collected in a buffer that is written at the
+    position of the part with a pwrite, as the threads cannot share the
+    IO_CACHE of the file. The runs are read with my_b_pread(), which does
+    not use the IO_CACHE of the temporary file.
+*/
+
+void Parallel_sort::merge_file_part(uint part)
+{
+  BUFFPEK *run= run_cursors + part * run_count;
+  uchar *buffer= merge_buffer + part * part_length;
+  uint rec_length= param->rec_length;
+  uint res_length= param->res_length;
+  uint offset= rec_length - res_length;
+  uchar *out= buffer + run_count * run_buffer_keys * rec_length;
+  uchar *out_end= out + (run_buffer_keys * rec_length / res_length) *
+                        res_length;
+  uchar *out_pos= out;
+  my_off_t to_pos= part_starts[part] * res_length;
+  size_t sort_length= param->sort_length;
+  Loser_tree tree;
+  uint code= 0;
+  File file= -1;
+
+  if (tree.init(run_count, offsetof(BUFFPEK, key), 0,
+                (Loser_tree::Compare) get_ptr_compare(sort_length),
+                &sort_length, (uint) sort_length, MYF(0)))
+  {
+    set_error(ER_OUT_OF_RESOURCES, -1, 0);
+    return;
+  }
+  for (uint i= 0; i < run_count; i++)
+  {
+    BUFFPEK *cur= run + i;
+    ha_rows *bound= bounds + i * (part_count + 1) + part;
+    cur->file_pos= runs[i].file_pos + bound[0] * rec_length;
+    cur->count= bound[1] - bound[0];
+    cur->base= buffer + i * run_buffer_keys * rec_length;
+    cur->max_keys= run_buffer_keys;
+    if (!cur->count)
+      continue;
+    if (read_to_buffer(tempfile, cur, rec_length) == (ulong) -1)
+    {
+      code= ER_ERROR_ON_READ;
+      file= tempfile->file;
+      goto end;
+    }
+    tree.insert((uchar*) cur);
+  }
+
+  while (tree.elements())
+  {
+    BUFFPEK *top= (BUFFPEK*) tree.top();
+    memcpy(out_pos, top->key + offset, res_length);
+    if ((out_pos+= res_length) == out_end)
+    {
+      if (mysql_file_pwrite(outfile->file, out, out_pos - out, to_pos,
+                            MYF(MY_NABP)))
+      {
+        code= ER_ERROR_ON_WRITE;
+        file= outfile->file;
+        goto end;
+      }
+      to_pos+= out_pos - out;
+      out_pos= out;
+      if (thd->killed)
+        goto end;
+    }
+    top->key+= rec_length;
+    if (!--top->mem_count)
+    {
+      ulong bytes_read= read_to_buffer(tempfile, top, rec_length);
+      if (bytes_read == (ulong) -1)
+      {
+        code= ER_ERROR_ON_READ;
+        file= tempfile->file;
+        goto end;
+      }
+      if (!bytes_read)
+      {
+        tree.remove_top();
+        continue;
+      }
+    }
+    tree.replace_top();
+  }
+  if (out_pos != out &&
+      mysql_file_pwrite(outfile->file, out, out_pos - out, to_pos,
+                        MYF(MY_NABP)))
+  {
+    code= ER_ERROR_ON_WRITE;
+    file= outfile->file;
+  }
+
+end:
+  tree.end();
+  if (code)
+    set_error(code, file, my_errno);
+}
+
+
+/*
+  Check whether the final merge of the runs can be done by the threads
+
+  SYNOPSIS
+    can_merge_runs()
+      buffpek     the runs
+      maxbuffer   the number of runs - 1
+      from_file   the file with the runs
+      to_file     the result file of filesort()
+
+  DESCRIPTION
+    The merge needs the threads that wrote the runs, unencrypted files
+    that can be read and written at any position without their IO_CACHEs,
+    and enough memory in the sort buffer for every thread to read a few
+    keys of each run at a time. The merge is not split if the result is
+    limited, as the parts could not know where to stop, nor for packed
+    records, whose positions in the runs are not known without reading.
+
+  RETURN VALUE
+    TRUE     call merge_runs()
+    FALSE    call merge_index()
+*/
+
+bool Parallel_sort::can_merge_runs(BUFFPEK *buffpek, uint maxbuffer,
+                                   IO_CACHE *from_file, IO_CACHE *to_file)
+{
+  ha_rows rows= 0;
+  size_t memory;
+  uint parts;
+
+  if (!initialized || !spill || !started ||
+      param->using_packed_records() ||
+      ((from_file->myflags | to_file->myflags) & MY_ENCRYPT))
+    return FALSE;
+  for (uint i= 0; i <= maxbuffer; i++)
+    rows+= buffpek[i].count;
+  if (rows > param->max_rows)
+    return FALSE;
+
+  memory= (size_t) param->max_keys_per_buffer * param->rec_length;
+  for (parts= started + 1; parts > 1; parts--)
+  {
+    run_buffer_keys= memory / parts / (maxbuffer + 2) / param->rec_length;
+    if (run_buffer_keys >= PARALLEL_SORT_MIN_MERGE_KEYS)
+      break;
+  }
+  if (parts < 2)
+    return FALSE;
+
+  runs= buffpek;
+  run_count= maxbuffer + 1;
+  tempfile= from_file;
+  outfile= to_file;
+  merge_buffer= (uchar*) sort_keys;
+  part_length= memory / parts;
+  run_parts= parts;
+  return TRUE;
+}
+
+
+/*
+  Merge the runs into the result file with the threads
+
+  DESCRIPTION
+    The splitters are chosen from samples of every run as in
+    merge_segments(). The bounds of the parts in the runs are found by
+    binary search, reading single keys from the temporary file. Every
+    part is written at the position that follows from the number of keys
+    in the parts before it.
+
+  RETURN VALUE
+    FALSE    OK, the result file is positioned after the result
+    TRUE     error, reported, or the query was killed
+*/
+
+bool Parallel_sort::merge_runs()
+{
+  uint parts= run_parts;
+  uint rec_length= param->rec_length;
+  size_t sort_length= param->sort_length;
+  uchar *sample_keys= NULL, **samples= NULL, *key;
+  uint sample_count= 0;
+  bool res= TRUE;
+  DBUG_ENTER("Parallel_sort::merge_runs");
+
+  if (!(bounds= (ha_rows *) my_malloc(run_count * (parts + 1) *
+                                      sizeof(ha_rows),
+                                      MYF(MY_WME | MY_THREAD_SPECIFIC))) ||
+      !(part_starts= (ha_rows *) my_malloc((parts + 1) * sizeof(ha_rows),
+                                           MYF(MY_WME | MY_THREAD_SPECIFIC |
+                                               MY_ZEROFILL))) ||
+      !(run_cursors= (BUFFPEK *) my_malloc(parts * run_count *
+                                           sizeof(BUFFPEK),
+                                           MYF(MY_WME |
+                                               MY_THREAD_SPECIFIC))) ||
+      !(samples= (uchar **) my_malloc(run_count * parts * sizeof(uchar*),
+                                      MYF(MY_WME | MY_THREAD_SPECIFIC))) ||
+      !(sample_keys= (uchar *) my_malloc((run_count * parts + 1) *
+                                         sort_length,
+                                         MYF(MY_WME | MY_THREAD_SPECIFIC))))
+    goto end;
+
+  for (uint i= 0; i < run_count; i++)
+  {
+    for (uint j= 1; j < parts && runs[i].count; j++)
+    {
+      key= sample_keys + sample_count * sort_length;
+      if (my_b_pread(tempfile, key, sort_length,
+                     runs[i].file_pos +
+                     runs[i].count * j / parts * rec_length))
+        goto end;
+      samples[sample_count++]= key;
+    }
+  }
+  my_qsort2(samples, sample_count, sizeof(uchar*),
+            get_ptr_compare(sort_length), &sort_length);
+
+  /* Binary search of the splitters in the runs */
+  key= sample_keys + sample_count * sort_length;
+  for (uint i= 0; i < run_count; i++)
+  {
+    ha_rows *bound= bounds + i * (parts + 1);
+    bound[0]= 0;
+    bound[parts]= runs[i].count;
+    for (uint j= 1; j < parts; j++)
+    {
+      const uchar *splitter= samples[sample_count * j / parts];
+      ha_rows low= bound[j - 1], high= runs[i].count;
+      while (low < high)
+      {
+        ha_rows mid= (low + high) / 2;
+        if (my_b_pread(tempfile, key, sort_length,
+                       runs[i].file_pos + mid * rec_length))
+          goto end;
+        if (memcmp(key, splitter, sort_length) < 0)
+          low= mid + 1;
+        else
+          high= mid;
+      }
+      bound[j]= low;
+      part_starts[j]+= low;
+    }
+    part_starts[parts]+= runs[i].count;
+  }
+
+  if (outfile->file == -1 && real_open_cached_file(outfile))
+    goto end;
+  thd->inc_status_sort_merge_passes();
+  thd->query_plan_fsort_passes++;
+  if (run_merge(FILE_MERGE, parts))
+    goto end;
+  /* Continue after the result, as if it was written through the cache */
+  if (reinit_io_cache(outfile, WRITE_CACHE,
+                      part_starts[parts] * param->res_length, 0, 1))
+    goto end;
+  res= FALSE;
+
+end:
+  my_free(sample_keys);
+  my_free(samples);
+  my_free(run_cursors);
+  my_free(part_starts);
+  my_free(bounds);
+  run_cursors= NULL;
+  bounds= part_starts= NULL;
+  DBUG_RETURN(res);
+}
@@ -0,0 +1,178 @@
+/*
+   Copyright (c) 2019, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+#ifndef FILESORT_PARALLEL_INCLUDED
+#define FILESORT_PARALLEL_INCLUDED
+
+#include "sql_sort.h"
+
+class THD;
+class SORT_INFO;
+
+/*
+  Threads that sort and merge for filesort().
+
+  When max_sort_threads is greater than 1, the sort buffer is divided into
+  segments. The thread of the query fills the segments with keys one after
+  the other, as find_all_keys() fills the whole buffer otherwise, and hands
+  every full segment over to the sort threads. While the segments are being
+  sorted, the thread of the query reads the rows for the next segment.
+
+  If all keys fit into the buffer, the sorted segments are merged in memory.
+  Otherwise the segments are written as runs into the temporary file of
+  filesort() once the thread of the query needs the first one again, and
+  every later segment is written as soon as it is sorted.
+
+  Both merges are split by the key space: some keys are taken as splitters
+  and every thread merges the keys between two neighbouring splitters from
+  all segments or runs into its own part of the result, whose position is
+  known from the number of keys before the lower splitter.
+
+  Packed records are not kept in slots of the same length. The segments
+  are then areas of the whole buffer, each filled from both ends as
+  Filesort_buffer::init_packed_area() describes, and the runs of packed
+  records are merged by merge_index().
+
+  The threads have no THD. They work only on the memory of the sort buffer
+  and on the temporary files, and the thread of the query reports the
+  errors they run into.
+*/
+
+class Parallel_sort
+{
+  enum Segment_state
+  {
+    SEGMENT_FREE,                       /* may be filled with keys */
+    SEGMENT_QUEUED,                     /* waits for a thread */
+    SEGMENT_BUSY,                       /* being sorted or written */
+    SEGMENT_SORTED                      /* sorted, kept in memory */
+  };
+
+  struct Sort_segment
+  {
+    uint start;                         /* index of the first key or slot */
+    uint end;                           /* end of the space of the segment */
+    uint count;                         /* number of keys in the segment */
+    Segment_state state;
+    bool sorted;
+  };
+
+  enum Merge_type { NO_MERGE, MEMORY_MERGE, FILE_MERGE };
+
+  /* The position of a merge in a sorted segment */
+  struct Merge_cursor
+  {
+    uchar *key;                         /* the current key */
+    uchar **next;
+    uchar **end;
+  };
+
+  THD *thd;
+  Sort_param *param;
+  SORT_INFO *info;
+  uchar **sort_keys;
+  IO_CACHE *buffpek_pointers;
+  IO_CACHE *tempfile;
+  /* Number of threads, including the thread of the query */
+  uint threads;
+
+  Sort_segment *segments;
+  uint segment_count;
+  uint current;                         /* the segment being filled */
+  bool handed_over;                     /* a segment was given to threads */
+
+  pthread_t *workers;
+  uint started;                         /* number of running workers */
+  bool initialized;
+
+  mysql_mutex_t lock;
+  mysql_mutex_t write_lock;             /* for writing the runs */
+  mysql_cond_t cond;
+  /* Protected by lock */
+  bool spill;                           /* the segments are written */
+  bool stop;
+  uint error;                           /* error code for my_error() */
+  File error_file;
+  int error_errno;
+
+  /* The merge done by the threads, split into parts by the splitters */
+  Merge_type merge_type;
+  uint part_count;
+  uint next_part;                       /* protected by lock */
+  uint parts_done;                      /* protected by lock */
+  /*
+    bounds[i * (part_count + 1) + j] is the number of keys of segment or
+    run i that are less than the splitter of part j
+  */
+  ha_rows *bounds;
+  ha_rows *part_starts;                 /* keys before each part */
+  /* MEMORY_MERGE */
+  uchar **merged;
+  Merge_cursor *cursors;
+  /* FILE_MERGE */
+  BUFFPEK *runs;
+  BUFFPEK *run_cursors;
+  uint run_count;
+  IO_CACHE *outfile;
+  uchar *merge_buffer;
+  uint run_parts;                       /* parts of the merge of the runs */
+  size_t part_length;                   /* merge_buffer per part */
+  ha_rows run_buffer_keys;              /* keys read from a run at once */
+
+  uchar **segment_keys(const Sort_segment *seg) const
+  {
+    /* The pointers to packed records are at the end of the segment */
+    return sort_keys + (param->using_packed_records() ? seg->end - seg->count :
+                                                        seg->start);
+  }
+  bool take_task(uint *segment, uint *part);
+  void run_task(uint segment, uint part);
+  bool help_or_wait();
+  void set_error(uint code, File file, int errnr);
+  bool report_error();
+  void start_workers();
+  bool write_segment(Sort_segment *segment);
+  void merge_memory_part(uint part);
+  void merge_file_part(uint part);
+  bool run_merge(Merge_type type, uint parts);
+
+public:
+  Parallel_sort()
+    :handed_over(FALSE), initialized(FALSE), spill(FALSE), merged(NULL) {}
+  ~Parallel_sort() { end(); }
+
+  void init(THD *thd_arg, Sort_param *param_arg, SORT_INFO *info,
+            ha_rows num_rows);
+  void end();
+  void work();
+
+  /* Filling of the segments, see find_all_keys() */
+  bool is_used() const { return initialized; }
+  uint segment_end() const { return segments[current].end; }
+  bool next_segment(uint *idx, IO_CACHE *buffpek_pointers_arg,
+                    IO_CACHE *tempfile_arg);
+  bool finish_segments(uint *idx);
+
+  /* The merges, see save_index() and merge_index() */
+  bool has_sorted_segments() const { return handed_over && !spill; }
+  bool merge_segments(uint count);
+  uchar **get_merged_keys() const { return merged; }
+  bool can_merge_runs(BUFFPEK *buffpek, uint maxbuffer,
+                      IO_CACHE *from_file, IO_CACHE *to_file);
+  bool merge_runs();
+};
+
+#endif /* FILESORT_PARALLEL_INCLUDED */
@@ -157,18 +157,54 @@ void Filesort_buffer::free_sort_buffer()
 }
 
 
-void Filesort_buffer::sort_buffer(const Sort_param *param, uint count)
+void Filesort_buffer::sort_buffer(Sort_param *param, uint count)
+{
+  sort_keys(param->using_packed_records() ? get_packed_keys() :
+                                            get_sort_keys(),
+            count, param, MYF(MY_THREAD_SPECIFIC));
+}
+
+
+/**
+  Sort an array of pointers to the keys of filesort().
+
+  @param keys         The pointers to sort
+  @param count        Number of pointers
+  @param param        The sort, for the length and comparison of the keys
+  @param malloc_flags Flags for the memory of the radix sort. The threads
+                      of a parallel sort have no THD and pass MYF(0).
+
+  @note
+    The pointers to packed records are added from the end of their area,
+    see init_packed_area(). They are reversed first, so that keys that
+    compare as equal are sorted the same way as if they were not packed.
+*/
+
+void Filesort_buffer::sort_keys(uchar **keys, uint count, Sort_param *param,
+                                myf malloc_flags)
 {
   size_t size= param->sort_length;
   if (count <= 1 || size == 0)
     return;
-  uchar **keys= get_sort_keys();
+  if (param->using_packed_records())
+  {
+    for (uchar **low= keys, **high= keys + count - 1; low < high;
+         low++, high--)
+      swap_variables(uchar*, *low, *high);
+  }
+  if (param->using_packed_sortkeys)
+  {
+    void *cmp_arg;
+    qsort2_cmp cmp= param->get_compare_function(&cmp_arg);
+    my_qsort2(keys, count, sizeof(uchar*), cmp, cmp_arg);
+    return;
+  }
+
   uchar **buffer= NULL;
-  if (radixsort_is_appliccable(count, param->sort_length) &&
-      (buffer= (uchar**) my_malloc(count*sizeof(char*),
-                                   MYF(MY_THREAD_SPECIFIC))))
+  if (radixsort_is_appliccable(count, size) &&
+      (buffer= (uchar**) my_malloc(count*sizeof(char*), malloc_flags)))
   {
-    radixsort_for_str_ptr(keys, count, param->sort_length, buffer);
+    radixsort_for_str_ptr(keys, count, size, buffer);
     my_free(buffer);
     return;
   }
@@ -60,7 +60,8 @@ class Filesort_buffer
 {
 public:
   Filesort_buffer()
-    : m_idx_array(), m_start_of_data(NULL), allocated_size(0)
+    : m_idx_array(), m_start_of_data(NULL), allocated_size(0),
+      m_next_rec_ptr(NULL), m_next_key(NULL)
   {}
   
   ~Filesort_buffer()
@@ -78,7 +79,9 @@ class Filesort_buffer
   }
 
   /** Sort me... */
-  void sort_buffer(const Sort_param *param, uint count);
+  void sort_buffer(Sort_param *param, uint count);
+  static void sort_keys(uchar **keys, uint count, Sort_param *param,
+                        myf malloc_flags);
 
   /// Initializes a record pointer.
   uchar *get_record_buffer(uint idx)
@@ -94,6 +97,44 @@ class Filesort_buffer
       (void) get_record_buffer(ix);
   }
 
+  /*
+    Packed records have different lengths, so they are not kept in slots.
+    An area of the buffer is filled from both ends instead: the records
+    from its start, and the pointers to them from its end.
+  */
+  void init_packed_area(uchar **start, uchar **end)
+  {
+    m_next_rec_ptr= reinterpret_cast<uchar*>(start);
+    m_next_key= end;
+  }
+
+  /// Makes the whole buffer one area.
+  void init_packed_area()
+  {
+    init_packed_area(m_idx_array.array(),
+                     m_idx_array.array() + allocated_size / sizeof(uchar*));
+  }
+
+  /// Whether a record of max_length bytes may not fit into the area.
+  bool packed_area_full(uint max_length) const
+  {
+    return m_next_rec_ptr + max_length + sizeof(uchar*) >
+           reinterpret_cast<uchar*>(m_next_key);
+  }
+
+  /// Where the next record of the area is to be made.
+  uchar *get_packed_record_buffer() { return m_next_rec_ptr; }
+
+  /// Adds the record made at get_packed_record_buffer() to the area.
+  void add_packed_record(uint length)
+  {
+    *--m_next_key= m_next_rec_ptr;
+    m_next_rec_ptr+= length;
+  }
+
+  /// The pointers to the records of the area, the last record first.
+  uchar **get_packed_keys() { return m_next_key; }
+
   /// Returns total size: pointer array + record buffers.
   size_t sort_buffer_size() const
   {
@@ -131,6 +172,8 @@ class Filesort_buffer
   uint       m_record_length;
   uchar     *m_start_of_data;                   /* Start of key data */
   size_t    allocated_size;
+  uchar     *m_next_rec_ptr;                    /* Packed: next record */
+  uchar    **m_next_key;                        /* Packed: last key added */
 };
 
 #endif  // FILESORT_UTILS_INCLUDED
@@ -5288,7 +5288,7 @@ bool ha_partition::init_record_priority_queue()
     else
       cmp_func= cmp_key_part_id;
     DBUG_PRINT("info", ("partition queue_init(1) used_parts: %u", used_parts));
-    if (init_queue(&m_queue, used_parts, 0, 0, cmp_func, cmp_arg, 0, 0))
+    if (m_queue.init(used_parts, 0, 0, cmp_func, cmp_arg))
     {
       my_free(m_ordered_rec_buffer);
       m_ordered_rec_buffer= NULL;
@@ -5308,7 +5308,7 @@ void ha_partition::destroy_record_priority_queue()
   DBUG_ENTER("ha_partition::destroy_record_priority_queue");
   if (m_ordered_rec_buffer)
   {
-    delete_queue(&m_queue);
+    m_queue.end();
     my_free(m_ordered_rec_buffer);
     m_ordered_rec_buffer= NULL;
   }
@@ -7441,7 +7441,6 @@ int ha_partition::handle_ordered_index_scan(uchar *buf, bool reverse_order)
 {
   int error;
   uint i;
-  uint j= queue_first_element(&m_queue);
   uint smallest_range_seq= 0;
   bool found= FALSE;
   uchar *part_rec_buf_ptr= m_ordered_rec_buffer;
@@ -7464,7 +7463,7 @@ int ha_partition::handle_ordered_index_scan(uchar *buf, bool reverse_order)
   }
   m_top_entry= NO_CURRENT_PART_ID;
   DBUG_PRINT("info", ("partition queue_remove_all(1)"));
-  queue_remove_all(&m_queue);
+  m_queue.remove_all();
   DBUG_ASSERT(bitmap_is_set(&m_part_info->read_partitions,
                             m_part_spec.start_part));
 
@@ -7569,7 +7568,7 @@ int ha_partition::handle_ordered_index_scan(uchar *buf, bool reverse_order)
       /*
         Initialize queue without order first, simply insert
       */
-      queue_element(&m_queue, j++)= part_rec_buf_ptr;
+      m_queue.insert(part_rec_buf_ptr);
     }
     else if (error == HA_ERR_KEY_NOT_FOUND)
     {
@@ -7616,7 +7615,7 @@ int ha_partition::handle_ordered_index_scan(uchar *buf, bool reverse_order)
       if (smallest_range_seq == m_stock_range_seq[i])
       {
         m_stock_range_seq[i]= 0;
-        queue_element(&m_queue, j++)= (uchar *) part_rec_buf_ptr;
+        m_queue.insert(part_rec_buf_ptr);
         DBUG_PRINT("info", ("partition smallest_range_seq == m_stock_range_seq[i]"));
       }
       part_rec_buf_ptr+= m_priority_queue_rec_len;
@@ -7632,10 +7631,8 @@ int ha_partition::handle_ordered_index_scan(uchar *buf, bool reverse_order)
       We found at least one partition with data, now sort all entries and
       after that read the first entry and copy it to the buffer to return in.
     */
-    queue_set_max_at_top(&m_queue, reverse_order);
-    queue_set_cmp_arg(&m_queue, (void*) this);
-    m_queue.elements= j - queue_first_element(&m_queue);
-    queue_fix(&m_queue);
+    m_queue.set_max_at_top(reverse_order);
+    m_queue.set_compare_arg((void*) this);
     return_top_record(buf);
     DBUG_PRINT("info", ("Record returned from partition %u", m_top_entry));
     DBUG_RETURN(0);
@@ -7658,7 +7655,7 @@ int ha_partition::handle_ordered_index_scan(uchar *buf, bool reverse_order)
 void ha_partition::return_top_record(uchar *buf)
 {
   uint part_id;
-  uchar *key_buffer= queue_top(&m_queue);
+  uchar *key_buffer= m_queue.top();
   uchar *rec_buffer= key_buffer + PARTITION_BYTES_IN_POS;
   DBUG_ENTER("ha_partition::return_top_record");
   DBUG_PRINT("enter", ("partition this: %p", this));
@@ -7696,7 +7693,7 @@ void ha_partition::return_record_by_parent()
 int ha_partition::handle_ordered_index_scan_key_not_found()
 {
   int error;
-  uint i, old_elements= m_queue.elements;
+  uint i, old_elements= m_queue.elements();
   uchar *part_buf= m_ordered_rec_buffer;
   uchar *curr_rec_buf= NULL;
   DBUG_ENTER("ha_partition::handle_ordered_index_scan_key_not_found");
@@ -7723,7 +7720,7 @@ int ha_partition::handle_ordered_index_scan_key_not_found()
       if (likely(!error))
       {
         DBUG_PRINT("info", ("partition queue_insert(1)"));
-        queue_insert(&m_queue, part_buf);
+        m_queue.insert(part_buf);
       }
       else if (error != HA_ERR_END_OF_FILE && error != HA_ERR_KEY_NOT_FOUND)
         DBUG_RETURN(error);
@@ -7734,10 +7731,10 @@ int ha_partition::handle_ordered_index_scan_key_not_found()
   bitmap_clear_all(&m_key_not_found_partitions);
   m_key_not_found= false;
 
-  if (m_queue.elements > old_elements)
+  if (m_queue.elements() > old_elements)
   {
     /* Update m_top_entry, which may have changed. */
-    uchar *key_buffer= queue_top(&m_queue);
+    uchar *key_buffer= m_queue.top();
     m_top_entry= uint2korr(key_buffer);
   }
   DBUG_RETURN(0);
@@ -7767,7 +7764,7 @@ int ha_partition::handle_ordered_next(uchar *buf, bool is_next_same)
     DBUG_RETURN(HA_ERR_END_OF_FILE);
 
   uint part_id= m_top_entry;
-  uchar *rec_buf= queue_top(&m_queue) + PARTITION_BYTES_IN_POS;
+  uchar *rec_buf= m_queue.top() + PARTITION_BYTES_IN_POS;
   handler *file;
 
   if (m_key_not_found)
@@ -7781,7 +7778,7 @@ int ha_partition::handle_ordered_next(uchar *buf, bool is_next_same)
     else
     {
       /* There are partitions not included in the index record queue. */
-      uint old_elements= m_queue.elements;
+      uint old_elements= m_queue.elements();
       if (unlikely((error= handle_ordered_index_scan_key_not_found())))
         DBUG_RETURN(error);
       /*
@@ -7790,7 +7787,7 @@ int ha_partition::handle_ordered_next(uchar *buf, bool is_next_same)
         return it.
         Otherwise replace the old with a call to index_next (fall through).
       */
-      if (old_elements != m_queue.elements && part_id != m_top_entry)
+      if (old_elements != m_queue.elements() && part_id != m_top_entry)
       {
         return_top_record(buf);
         DBUG_RETURN(0);
@@ -7823,12 +7820,13 @@ int ha_partition::handle_ordered_next(uchar *buf, bool is_next_same)
     if (unlikely(error == HA_ERR_END_OF_FILE))
     {
       bitmap_clear_bit(&m_mrr_used_partitions, part_id);
-      DBUG_PRINT("info", ("partition m_queue.elements: %u", m_queue.elements));
-      if (m_queue.elements)
+      DBUG_PRINT("info", ("partition m_queue.elements: %u",
+                          m_queue.elements()));
+      if (m_queue.elements())
       {
         DBUG_PRINT("info", ("partition queue_remove_top(1)"));
-        queue_remove_top(&m_queue);
-        if (m_queue.elements)
+        m_queue.remove_top();
+        if (m_queue.elements())
         {
           return_top_record(buf);
           DBUG_PRINT("info", ("Record returned from partition %u (3)",
@@ -7852,15 +7850,15 @@ int ha_partition::handle_ordered_next(uchar *buf, bool is_next_same)
         m_stock_range_seq[part_id]=
           ((PARTITION_KEY_MULTI_RANGE *) m_range_info[part_id])->id;
         DBUG_PRINT("info", ("partition queue_remove_top(2)"));
-        queue_remove_top(&m_queue);
-        if (!m_queue.elements)
+        m_queue.remove_top();
+        if (!m_queue.elements())
           get_next= TRUE;
       }
     }
     if (get_next)
     {
       DBUG_PRINT("info", ("get_next route"));
-      uint i, j= 0, smallest_range_seq= UINT_MAX32;
+      uint i, smallest_range_seq= UINT_MAX32;
       for (i= m_part_spec.start_part; i <= m_part_spec.end_part; i++)
       {
         if (!(bitmap_is_set(&(m_part_info->read_partitions), i)))
@@ -7876,7 +7874,7 @@ int ha_partition::handle_ordered_next(uchar *buf, bool is_next_same)
       {
         uchar *part_rec_buf_ptr= m_ordered_rec_buffer;
         DBUG_PRINT("info", ("partition queue_remove_all(2)"));
-        queue_remove_all(&m_queue);
+        m_queue.remove_all();
         DBUG_PRINT("info", ("m_part_spec.start_part: %u",
           m_part_spec.start_part));
 
@@ -7905,8 +7903,7 @@ int ha_partition::handle_ordered_next(uchar *buf, bool is_next_same)
           {
             m_stock_range_seq[i]= 0;
             DBUG_PRINT("info", ("partition queue_insert(2)"));
-            queue_insert(&m_queue, part_rec_buf_ptr);
-            j++;
+            m_queue.insert(part_rec_buf_ptr);
           }
         }
         while (m_mrr_range_current->id < smallest_range_seq)
@@ -7916,10 +7913,8 @@ int ha_partition::handle_ordered_next(uchar *buf, bool is_next_same)
                            m_mrr_range_current));
         DBUG_PRINT("info",("partition m_mrr_range_current->id: %u",
                            m_mrr_range_current ? m_mrr_range_current->id : 0));
-        queue_set_max_at_top(&m_queue, FALSE);
-        queue_set_cmp_arg(&m_queue, (void*) this);
-        m_queue.elements= j;
-        queue_fix(&m_queue);
+        m_queue.set_max_at_top(FALSE);
+        m_queue.set_compare_arg((void*) this);
         return_top_record(buf);
         DBUG_PRINT("info", ("Record returned from partition %u (4)",
                             m_top_entry));
@@ -7935,12 +7930,12 @@ int ha_partition::handle_ordered_next(uchar *buf, bool is_next_same)
 
   if (unlikely(error))
   {
-    if (error == HA_ERR_END_OF_FILE && m_queue.elements)
+    if (error == HA_ERR_END_OF_FILE && m_queue.elements())
     {
       /* Return next buffered row */
       DBUG_PRINT("info", ("partition queue_remove_top(3)"));
-      queue_remove_top(&m_queue);
-      if (m_queue.elements)
+      m_queue.remove_top();
+      if (m_queue.elements())
       {
          return_top_record(buf);
          DBUG_PRINT("info", ("Record returned from partition %u (2)",
@@ -7957,7 +7952,7 @@ int ha_partition::handle_ordered_next(uchar *buf, bool is_next_same)
     memcpy(rec_buf + m_rec_length, file->ref, file->ref_length);
   }
 
-  queue_replace_top(&m_queue);
+  m_queue.replace_top();
   return_top_record(buf);
   DBUG_PRINT("info", ("Record returned from partition %u", m_top_entry));
   DBUG_RETURN(0);
@@ -7987,16 +7982,16 @@ int ha_partition::handle_ordered_prev(uchar *buf)
     DBUG_RETURN(HA_ERR_END_OF_FILE);
 
   uint part_id= m_top_entry;
-  uchar *rec_buf= queue_top(&m_queue) + PARTITION_BYTES_IN_POS;
+  uchar *rec_buf= m_queue.top() + PARTITION_BYTES_IN_POS;
   handler *file= m_file[part_id];
 
   if (unlikely((error= file->ha_index_prev(rec_buf))))
   {
-    if (error == HA_ERR_END_OF_FILE && m_queue.elements)
+    if (error == HA_ERR_END_OF_FILE && m_queue.elements())
     {
       DBUG_PRINT("info", ("partition queue_remove_top(4)"));
-      queue_remove_top(&m_queue);
-      if (m_queue.elements)
+      m_queue.remove_top();
+      if (m_queue.elements())
       {
 	return_top_record(buf);
 	DBUG_PRINT("info", ("Record returned from partition %u (2)",
@@ -8006,7 +8001,7 @@ int ha_partition::handle_ordered_prev(uchar *buf)
     }
     DBUG_RETURN(error);
   }
-  queue_replace_top(&m_queue);
+  m_queue.replace_top();
   return_top_record(buf);
   DBUG_PRINT("info", ("Record returned from partition %u", m_top_entry));
   DBUG_RETURN(0);
@@ -19,7 +19,7 @@
    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
 
 #include "sql_partition.h"      /* part_id_range, partition_element */
-#include "queues.h"             /* QUEUE */
+#include "loser_tree.h"         /* Loser_tree */
 
 #define PARTITION_BYTES_IN_POS 2
 
@@ -254,7 +254,7 @@ class ha_partition :public handler
   KEY *m_curr_key_info[3];              // Current index
   uchar *m_rec0;                        // table->record[0]
   const uchar *m_err_rec;               // record which gave error
-  QUEUE m_queue;                        // Prio queue used by sorted read
+  Loser_tree m_queue;                   // Merge of the sorted reads
 
   /*
     Length of an element in m_ordered_rec_buffer. The elements are composed of
@@ -3003,6 +3003,68 @@ int handler::ha_rnd_next(uchar *buf)
   DBUG_RETURN(result);
 }
 
+
+/**
+  Read the next rows of a table scan, with statistics
+
+  The statistics are updated as if ha_rnd_next() had been called for
+  every row, but the engine is entered once for the whole batch.
+  Virtual columns are not computed, the caller has to do it after it
+  has copied a record to record[0].
+  The values of BLOB fields are only valid until the next read, so only
+  one row is read at a time for tables with BLOBs.
+*/
+
+int handler::ha_rnd_next_batch(uchar *buf, uint max_rows, uint *rows)
+{
+  int result;
+  DBUG_ENTER("handler::ha_rnd_next_batch");
+  DBUG_ASSERT(table_share->tmp_table != NO_TMP_TABLE ||
+              m_lock_type != F_UNLCK);
+  DBUG_ASSERT(inited == RND);
+  DBUG_ASSERT(max_rows > 0);
+
+  if (table->s->blob_fields)
+    max_rows= 1;
+
+  TABLE_IO_WAIT(tracker, m_psi, PSI_TABLE_FETCH_ROW, MAX_KEY, 0,
+    { result= rnd_next_batch(buf, max_rows, rows); })
+
+  for (uint i= 0; i < *rows; i++)
+  {
+    update_rows_read();
+    increment_statistics(&SSV::ha_read_rnd_next_count);
+  }
+  if (result)
+    increment_statistics(&SSV::ha_read_rnd_next_count);
+
+  table->status= *rows ? 0 : STATUS_NOT_FOUND;
+  DBUG_RETURN(result);
+}
+
+
+int handler::rnd_next_batch(uchar *buf, uint max_rows, uint *rows)
+{
+  size_t reclength= table->s->reclength;
+  int error= 0;
+
+  for (*rows= 0; *rows < max_rows; )
+  {
+    if (likely(!(error= rnd_next(buf + *rows * reclength))))
+      (*rows)++;
+    else if (error == HA_ERR_RECORD_DELETED)
+    {
+      status_var_increment(table->in_use->status_var.ha_read_rnd_deleted_count);
+      if (table->in_use->check_killed(1))
+        return HA_ERR_ABORTED_BY_USER;
+    }
+    else
+      break;
+  }
+  return error;
+}
+
+
 int handler::ha_rnd_pos(uchar *buf, uchar *pos)
 {
   int result;
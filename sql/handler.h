@@ -3164,6 +3164,21 @@ class handler :public Sql_alloc
     DBUG_ASSERT(inited == NONE);
   }
   virtual handler *clone(const char *name, MEM_ROOT *mem_root);
+  /**
+    Whether other threads may read the table at the same time as the
+    statement, each in a session of its own and through its own instance
+    of the table, and see the same data as the statement. See
+    start_parallel_read().
+  */
+  virtual bool can_read_parallel() { return false; }
+  /**
+    Make this handler, which was opened and locked by a session of a
+    thread of a parallel scan, see the same data as 'from', the handler
+    of the statement. This is called before the first read.
+    @return 0 or an error code
+  */
+  virtual int start_parallel_read(handler *from)
+  { return HA_ERR_WRONG_COMMAND; }
   /** This is called after create to allow us to set up cached variables */
   void init()
   {
@@ -3717,6 +3732,22 @@ class handler :public Sql_alloc
 public:
   virtual int ft_read(uchar *buf) { return HA_ERR_WRONG_COMMAND; }
   virtual int rnd_next(uchar *buf)=0;
+  /**
+    Read the next rows of a table scan.
+
+    @param buf       buffer for max_rows records, table->s->reclength
+                     bytes apart
+    @param max_rows  maximum number of rows to read
+    @param rows      OUT: number of rows read
+
+    @return the error that stopped the reading, 0 if max_rows rows were
+    read. The rows read before the error are valid.
+
+    The default implementation calls rnd_next() for every row. Engines
+    can read several rows at once, as long as the position of the scan
+    after the call is the one after the last row returned.
+  */
+  virtual int rnd_next_batch(uchar *buf, uint max_rows, uint *rows);
   virtual int rnd_pos(uchar * buf, uchar *pos)=0;
   /**
     This function only works for handlers having
@@ -3744,6 +3775,7 @@ class handler :public Sql_alloc
   inline int ha_ft_read(uchar *buf);
   inline void ha_ft_end() { ft_end(); ft_handler=NULL; }
   int ha_rnd_next(uchar *buf);
+  int ha_rnd_next_batch(uchar *buf, uint max_rows, uint *rows);
   int ha_rnd_pos(uchar *buf, uchar *pos);
   inline int ha_rnd_pos_by_record(uchar *buf);
   inline int ha_read_first_row(uchar *buf, uint primary_key);
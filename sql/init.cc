@@ -34,7 +34,6 @@ void unireg_init(ulong options)
   DBUG_ENTER("unireg_init");
 
   error_handler_hook = my_message_stderr;
-  my_disable_async_io=1;		/* aioread is only in shared library */
   wild_many='%'; wild_one='_'; wild_prefix='\\'; /* Change to sql syntax */
 
   current_pid=(ulong) getpid();		/* Save for later ref */
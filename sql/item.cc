@@ -1118,6 +1118,21 @@ void Item::set_name_no_truncate(THD *thd, const char *str, uint length,
 }
 
 
+void Item::filter_batch(Row_batch *batch)
+{
+  TABLE *table= batch->table;
+  uint selected= 0;
+  for (uint i= 0; i < batch->selected; i++)
+  {
+    uint rec= batch->sel[i];
+    memcpy(table->record[0], batch->record(rec), batch->rec_length);
+    if (val_int())
+      batch->sel[selected++]= rec;
+  }
+  batch->selected= selected;
+}
+
+
 /**
   @details
   This function is called when:
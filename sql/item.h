@@ -107,6 +107,7 @@ class Item_ref;
 class Item_param;
 class user_var_entry;
 class JOIN;
+class Row_batch;
 struct KEY_FIELD;
 struct SARGABLE_PARAM;
 class RANGE_OPT_PARAM;
@@ -1449,6 +1450,26 @@ class Item: public Value_source,
   }
   virtual String *val_raw(String*) { return 0; }
 
+  /*
+    Filter a batch of records by the value of the item.
+
+    SYNOPSIS
+      filter_batch()
+      batch    the records of one table, the records to check are
+               listed in batch->sel
+
+    DESCRIPTION
+      Leaves in batch->sel only the records for which the item is true.
+      The default implementation works row by row: it copies each record
+      into record[0] of the table and calls val_int().
+  */
+  virtual void filter_batch(Row_batch *batch);
+  /*
+    Return TRUE if filter_batch() checks the records of the table without
+    falling back to the row by row evaluation, at least partially.
+  */
+  virtual bool has_batch_filter(const TABLE *table) { return false; }
+
   bool eval_const_cond()
   {
     DBUG_ASSERT(const_item());
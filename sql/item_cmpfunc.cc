@@ -5428,6 +5428,484 @@ void Item_func_isnotnull::print(String *str, enum_query_type query_type)
 }
 
 
+/*
+  Filtering of batches of records (see Item::filter_batch()).
+
+  The predicates of the form 'field op constant' and 'field IS [NOT] NULL'
+  over numeric fields of the table of the batch are checked in a loop
+  over the records that reads the values of the field directly from the
+  record buffers. AND and OR filter the batch with their arguments.
+  Everything else, including comparisons of arithmetic expressions,
+  falls back to Item::filter_batch().
+*/
+
+struct Batch_tiny
+{
+  typedef longlong type;
+  longlong operator()(const uchar *ptr) const
+  { return (longlong) (signed char) *ptr; }
+};
+struct Batch_utiny
+{
+  typedef longlong type;
+  longlong operator()(const uchar *ptr) const { return (longlong) *ptr; }
+};
+struct Batch_short
+{
+  typedef longlong type;
+  longlong operator()(const uchar *ptr) const { return sint2korr(ptr); }
+};
+struct Batch_ushort
+{
+  typedef longlong type;
+  longlong operator()(const uchar *ptr) const { return uint2korr(ptr); }
+};
+struct Batch_int24
+{
+  typedef longlong type;
+  longlong operator()(const uchar *ptr) const { return sint3korr(ptr); }
+};
+struct Batch_uint24
+{
+  typedef longlong type;
+  longlong operator()(const uchar *ptr) const { return uint3korr(ptr); }
+};
+struct Batch_long
+{
+  typedef longlong type;
+  longlong operator()(const uchar *ptr) const { return sint4korr(ptr); }
+};
+struct Batch_ulong
+{
+  typedef longlong type;
+  longlong operator()(const uchar *ptr) const { return uint4korr(ptr); }
+};
+struct Batch_longlong
+{
+  typedef longlong type;
+  longlong operator()(const uchar *ptr) const { return sint8korr(ptr); }
+};
+struct Batch_float
+{
+  typedef double type;
+  double operator()(const uchar *ptr) const
+  {
+    float nr;
+    float4get(nr, ptr);
+    return (double) nr;
+  }
+};
+struct Batch_double
+{
+  typedef double type;
+  double operator()(const uchar *ptr) const
+  {
+    double nr;
+    float8get(nr, ptr);
+    return nr;
+  }
+};
+
+struct Batch_eq
+{ template <class T> bool operator()(T a, T b) const { return a == b; } };
+struct Batch_ne
+{ template <class T> bool operator()(T a, T b) const { return a != b; } };
+struct Batch_lt
+{ template <class T> bool operator()(T a, T b) const { return a < b; } };
+struct Batch_le
+{ template <class T> bool operator()(T a, T b) const { return a <= b; } };
+struct Batch_gt
+{ template <class T> bool operator()(T a, T b) const { return a > b; } };
+struct Batch_ge
+{ template <class T> bool operator()(T a, T b) const { return a >= b; } };
+
+
+/*
+  Leave in batch->sel the records where the field is not NULL and
+  'field op value' holds. The field is at 'offset' in the record,
+  null_bit is 0 for a NOT NULL field.
+*/
+
+template <class Reader, class Cmp>
+static uint filter_batch_loop(Row_batch *batch, uint offset,
+                              uint null_offset, uchar null_bit,
+                              typename Reader::type value)
+{
+  Reader get;
+  Cmp cmp;
+  uint *sel= batch->sel;
+  uint selected= 0;
+  for (uint i= 0; i < batch->selected; i++)
+  {
+    const uchar *rec= batch->record(sel[i]);
+    if (!(rec[null_offset] & null_bit) && cmp(get(rec + offset), value))
+      sel[selected++]= sel[i];
+  }
+  return selected;
+}
+
+
+template <class Reader>
+static uint filter_batch_op(Row_batch *batch, Item_func::Functype op,
+                            Field *field, typename Reader::type value)
+{
+  uint offset= field->offset(field->table->record[0]);
+  uint null_offset= field->null_ptr ? field->null_offset() : 0;
+  uchar null_bit= field->null_ptr ? field->null_bit : 0;
+
+  switch (op) {
+  case Item_func::EQ_FUNC:
+    return filter_batch_loop<Reader, Batch_eq>(batch, offset, null_offset,
+                                               null_bit, value);
+  case Item_func::NE_FUNC:
+    return filter_batch_loop<Reader, Batch_ne>(batch, offset, null_offset,
+                                               null_bit, value);
+  case Item_func::LT_FUNC:
+    return filter_batch_loop<Reader, Batch_lt>(batch, offset, null_offset,
+                                               null_bit, value);
+  case Item_func::LE_FUNC:
+    return filter_batch_loop<Reader, Batch_le>(batch, offset, null_offset,
+                                               null_bit, value);
+  case Item_func::GT_FUNC:
+    return filter_batch_loop<Reader, Batch_gt>(batch, offset, null_offset,
+                                               null_bit, value);
+  case Item_func::GE_FUNC:
+    return filter_batch_loop<Reader, Batch_ge>(batch, offset, null_offset,
+                                               null_bit, value);
+  default:
+    DBUG_ASSERT(0);
+    return batch->selected;
+  }
+}
+
+
+/*
+  Check whether the comparison can be checked for a batch of records of
+  the table without falling back to the row by row evaluation.
+
+  This is possible for 'field op constant' (or 'constant op field', then
+  *op is the reversed operation), where the field is an integer field
+  compared as an integer or a floating point field compared as a double,
+  exactly as Arg_comparator::compare_int_*() and compare_real() do it.
+  BIGINT UNSIGNED fields are not handled as their values do not fit into
+  longlong. The threads of a parallel scan check the comparisons the same
+  way (see Parallel_cond::create()).
+*/
+
+bool Item_bool_rowready_func2::get_batch_filter_args(const TABLE *table,
+                                                     Field **field,
+                                                     Item **value,
+                                                     Functype *op)
+{
+  Item *field_item;
+  *op= functype();
+  switch (*op) {
+  case EQ_FUNC:
+  case NE_FUNC:
+  case LT_FUNC:
+  case LE_FUNC:
+  case GT_FUNC:
+  case GE_FUNC:
+    break;
+  default:
+    return false;
+  }
+
+  if (args[0]->real_item()->type() == FIELD_ITEM && args[1]->const_item())
+  {
+    field_item= args[0]->real_item();
+    *value= args[1];
+  }
+  else if (args[1]->real_item()->type() == FIELD_ITEM &&
+           args[0]->const_item())
+  {
+    field_item= args[1]->real_item();
+    *value= args[0];
+    *op= rev_functype();
+  }
+  else
+    return false;
+  if ((*value)->is_expensive())
+    return false;
+  *field= ((Item_field *) field_item)->field;
+  if ((*field)->table != table)
+    return false;
+
+  if (cmp.func == &Arg_comparator::compare_real)
+    return ((*field)->type() == MYSQL_TYPE_DOUBLE ||
+            (*field)->type() == MYSQL_TYPE_FLOAT);
+  if (cmp.func == &Arg_comparator::compare_int_signed ||
+      cmp.func == &Arg_comparator::compare_int_signed_unsigned ||
+      cmp.func == &Arg_comparator::compare_int_unsigned_signed ||
+      cmp.func == &Arg_comparator::compare_int_unsigned)
+  {
+    switch ((*field)->type()) {
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONG:
+      return true;
+    case MYSQL_TYPE_LONGLONG:
+      return !((*field)->flags & UNSIGNED_FLAG);
+    default:
+      break;
+    }
+  }
+  return false;
+}
+
+
+bool Item_bool_rowready_func2::has_batch_filter(const TABLE *table)
+{
+  Field *field;
+  Item *value;
+  Functype op;
+  return get_batch_filter_args(table, &field, &value, &op);
+}
+
+
+void Item_bool_rowready_func2::filter_batch(Row_batch *batch)
+{
+  Field *field;
+  Item *value;
+  Functype op;
+  if (!get_batch_filter_args(batch->table, &field, &value, &op))
+  {
+    Item::filter_batch(batch);
+    return;
+  }
+
+  if (cmp.func == &Arg_comparator::compare_real)
+  {
+    double nr= value->val_real();
+    if (value->null_value)
+      batch->selected= 0;
+    else if (field->type() == MYSQL_TYPE_DOUBLE)
+      batch->selected= filter_batch_op<Batch_double>(batch, op, field, nr);
+    else
+      batch->selected= filter_batch_op<Batch_float>(batch, op, field, nr);
+    return;
+  }
+
+  longlong nr= value->val_int();
+  if (value->null_value)
+  {
+    batch->selected= 0;
+    return;
+  }
+  if (value->unsigned_flag && nr < 0)
+  {
+    /* The constant is out of the range of longlong */
+    Item::filter_batch(batch);
+    return;
+  }
+  bool is_unsigned= field->flags & UNSIGNED_FLAG;
+  switch (field->type()) {
+  case MYSQL_TYPE_TINY:
+    batch->selected= is_unsigned ?
+      filter_batch_op<Batch_utiny>(batch, op, field, nr) :
+      filter_batch_op<Batch_tiny>(batch, op, field, nr);
+    break;
+  case MYSQL_TYPE_SHORT:
+    batch->selected= is_unsigned ?
+      filter_batch_op<Batch_ushort>(batch, op, field, nr) :
+      filter_batch_op<Batch_short>(batch, op, field, nr);
+    break;
+  case MYSQL_TYPE_INT24:
+    batch->selected= is_unsigned ?
+      filter_batch_op<Batch_uint24>(batch, op, field, nr) :
+      filter_batch_op<Batch_int24>(batch, op, field, nr);
+    break;
+  case MYSQL_TYPE_LONG:
+    batch->selected= is_unsigned ?
+      filter_batch_op<Batch_ulong>(batch, op, field, nr) :
+      filter_batch_op<Batch_long>(batch, op, field, nr);
+    break;
+  default:
+    batch->selected= filter_batch_op<Batch_longlong>(batch, op, field, nr);
+  }
+}
+
+
+/*
+  Return the nullable field of the table the item refers to, or NULL
+*/
+
+static Field *get_batch_null_field(Item *item, const TABLE *table)
+{
+  Item *real_item= item->real_item();
+  if (real_item->type() != Item::FIELD_ITEM)
+    return NULL;
+  Field *field= ((Item_field *) real_item)->field;
+  return field->table == table && field->null_ptr ? field : NULL;
+}
+
+
+/*
+  Leave in batch->sel the records where the NULL flag of the field is
+  equal to is_null
+*/
+
+static void filter_batch_null(Row_batch *batch, Field *field, bool is_null)
+{
+  uint null_offset= field->null_offset();
+  uchar null_bit= field->null_bit;
+  uchar match= is_null ? null_bit : 0;
+  uint *sel= batch->sel;
+  uint selected= 0;
+  for (uint i= 0; i < batch->selected; i++)
+  {
+    if ((batch->record(sel[i])[null_offset] & null_bit) == match)
+      sel[selected++]= sel[i];
+  }
+  batch->selected= selected;
+}
+
+
+bool Item_func_isnull::has_batch_filter(const TABLE *table)
+{
+  return get_batch_null_field(args[0], table) != NULL;
+}
+
+
+void Item_func_isnull::filter_batch(Row_batch *batch)
+{
+  Field *field= get_batch_null_field(args[0], batch->table);
+  if (field)
+    filter_batch_null(batch, field, true);
+  else
+    Item::filter_batch(batch);
+}
+
+
+bool Item_func_isnotnull::has_batch_filter(const TABLE *table)
+{
+  return get_batch_null_field(args[0], table) != NULL;
+}
+
+
+void Item_func_isnotnull::filter_batch(Row_batch *batch)
+{
+  Field *field= get_batch_null_field(args[0], batch->table);
+  if (field)
+    filter_batch_null(batch, field, false);
+  else
+    Item::filter_batch(batch);
+}
+
+
+bool Item_cond_and::has_batch_filter(const TABLE *table)
+{
+  List_iterator_fast<Item> li(list);
+  Item *item;
+  while ((item= li++))
+  {
+    if (item->has_batch_filter(table))
+      return true;
+  }
+  return false;
+}
+
+
+/*
+  The conjuncts that can be checked for the whole batch are applied first,
+  so that the rest are evaluated row by row for fewer records.
+*/
+
+void Item_cond_and::filter_batch(Row_batch *batch)
+{
+  List_iterator_fast<Item> li(list);
+  Item *item;
+  while ((item= li++) && batch->selected)
+  {
+    if (item->has_batch_filter(batch->table))
+      item->filter_batch(batch);
+  }
+  li.rewind();
+  while ((item= li++) && batch->selected)
+  {
+    if (!item->has_batch_filter(batch->table))
+      item->filter_batch(batch);
+  }
+}
+
+
+bool Item_cond_or::has_batch_filter(const TABLE *table)
+{
+  List_iterator_fast<Item> li(list);
+  Item *item;
+  while ((item= li++))
+  {
+    if (item->has_batch_filter(table))
+      return true;
+  }
+  return false;
+}
+
+
+/*
+  Each disjunct is checked only for the records none of the previous
+  disjuncts has been true for. The records that are kept are marked in
+  the vector 'found', indexed by the number of the record in the batch.
+*/
+
+void Item_cond_or::filter_batch(Row_batch *batch)
+{
+  uint *rest, *work, *found;
+  if (!(rest= batch->alloc_vector()))
+  {
+    Item::filter_batch(batch);
+    return;
+  }
+  if (!(work= batch->alloc_vector()) || !(found= batch->alloc_vector()))
+  {
+    batch->free_vectors(rest);
+    Item::filter_batch(batch);
+    return;
+  }
+
+  uint *sel= batch->sel;
+  uint selected= batch->selected;
+  uint rest_count= selected;
+  memcpy(rest, sel, selected * sizeof(uint));
+  for (uint i= 0; i < selected; i++)
+    found[sel[i]]= 0;
+
+  for (uint pass= 0; pass < 2; pass++)
+  {
+    List_iterator_fast<Item> li(list);
+    Item *item;
+    while ((item= li++) && rest_count)
+    {
+      if (item->has_batch_filter(batch->table) != (pass == 0))
+        continue;
+      memcpy(work, rest, rest_count * sizeof(uint));
+      batch->sel= work;
+      batch->selected= rest_count;
+      item->filter_batch(batch);
+      for (uint i= 0; i < batch->selected; i++)
+        found[work[i]]= 1;
+      uint count= 0;
+      for (uint i= 0; i < rest_count; i++)
+      {
+        if (!found[rest[i]])
+          rest[count++]= rest[i];
+      }
+      rest_count= count;
+    }
+  }
+
+  batch->sel= sel;
+  batch->selected= 0;
+  for (uint i= 0; i < selected; i++)
+  {
+    if (found[sel[i]])
+      sel[batch->selected++]= sel[i];
+  }
+  batch->free_vectors(rest);
+}
+
+
 bool Item_bool_func2::count_sargable_conds(void *arg)
 {
   ((SELECT_LEX*) arg)->cond_count++;
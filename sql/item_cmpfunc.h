@@ -510,6 +510,8 @@ class Item_bool_rowready_func2 :public Item_bool_func2_with_rev
   Item_bool_rowready_func2(THD *thd, Item *a, Item *b):
     Item_bool_func2_with_rev(thd, a, b), cmp(tmp_arg, tmp_arg + 1)
   { }
+  bool get_batch_filter_args(const TABLE *table, Field **field,
+                             Item **value, Functype *op);
   void print(String *str, enum_query_type query_type)
   {
     Item_func::print_op(str, query_type);
@@ -517,6 +519,8 @@ class Item_bool_rowready_func2 :public Item_bool_func2_with_rev
   enum precedence precedence() const { return CMP_PRECEDENCE; }
   Item *neg_transformer(THD *thd);
   virtual Item *negated_item(THD *thd);
+  void filter_batch(Row_batch *batch);
+  bool has_batch_filter(const TABLE *table);
   Item* propagate_equal_fields(THD *thd, const Context &ctx, COND_EQUAL *cond)
   {
     Item_args::propagate_equal_fields(thd,
@@ -2549,6 +2553,8 @@ class Item_func_isnull :public Item_func_null_predicate
 public:
   Item_func_isnull(THD *thd, Item *a): Item_func_null_predicate(thd, a) {}
   longlong val_int();
+  void filter_batch(Row_batch *batch);
+  bool has_batch_filter(const TABLE *table);
   enum Functype functype() const { return ISNULL_FUNC; }
   const char *func_name() const { return "isnull"; }
   void print(String *str, enum_query_type query_type);
@@ -2627,6 +2633,8 @@ class Item_func_isnotnull :public Item_func_null_predicate
     Item_func_null_predicate(thd, a), abort_on_null(0)
   { }
   longlong val_int();
+  void filter_batch(Row_batch *batch);
+  bool has_batch_filter(const TABLE *table);
   enum Functype functype() const { return ISNOTNULL_FUNC; }
   const char *func_name() const { return "isnotnull"; }
   enum precedence precedence() const { return CMP_PRECEDENCE; }
@@ -3340,6 +3348,8 @@ class Item_cond_and :public Item_cond
   Item_cond_and(THD *thd, List<Item> &list_arg): Item_cond(thd, list_arg) {}
   enum Functype functype() const { return COND_AND_FUNC; }
   longlong val_int();
+  void filter_batch(Row_batch *batch);
+  bool has_batch_filter(const TABLE *table);
   const char *func_name() const { return "and"; }
   enum precedence precedence() const { return AND_PRECEDENCE; }
   table_map not_null_tables() const
@@ -3373,6 +3383,8 @@ class Item_cond_or :public Item_cond
   Item_cond_or(THD *thd, List<Item> &list_arg): Item_cond(thd, list_arg) {}
   enum Functype functype() const { return COND_OR_FUNC; }
   longlong val_int();
+  void filter_batch(Row_batch *batch);
+  bool has_batch_filter(const TABLE *table);
   const char *func_name() const { return "or"; }
   enum precedence precedence() const { return OR_PRECEDENCE; }
   table_map not_null_tables() const { return and_tables_cache; }
@@ -0,0 +1,256 @@
+/*
+   Copyright (c) 2019, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+/*
+  This file implements the tournament tree used for k-way merges, see
+  loser_tree.h.
+
+  The tree is stored as an implicit binary tree with leaf_count leaves:
+  the leaves are the positions leaf_count .. 2*leaf_count-1, the inner
+  nodes the positions 1 .. leaf_count-1, and the parent of position p is
+  p/2. This is a complete binary tree for any number of leaves.
+*/
+
+#include "mariadb.h"
+#include "loser_tree.h"
+
+/* Number of bytes of a key that are cached in its leaf */
+#define LOSER_TREE_PREFIX_LENGTH 8
+
+
+/*
+  Allocate the tree
+
+  SYNOPSIS
+    init()
+      max_elements       the number of streams that are merged
+      offset             offset of the key in an element
+      max_at_top         TRUE if the largest element is on top
+      cmp                the compare function for the keys
+      cmp_arg            the first argument of the compare function
+      key_prefix_length  0, or the length of the keys if the compare
+                         function compares them as byte strings
+      flags              flags for my_malloc()
+
+  RETURN VALUE
+    FALSE    on success
+    TRUE     out of memory
+*/
+
+bool Loser_tree::init(uint max_elements, uint offset, bool max_at_top,
+                      Compare cmp, void *cmp_arg, uint key_prefix_length,
+                      myf flags)
+{
+  DBUG_ENTER("Loser_tree::init");
+  DBUG_ASSERT(max_elements > 0);
+  end();
+  if (!(leaves= (Leaf*) my_malloc(max_elements * (sizeof(Leaf) +
+                                                  2 * sizeof(uint)),
+                                  flags)))
+    DBUG_RETURN(TRUE);
+  nodes= (uint*) (leaves + max_elements);
+  winners= nodes + max_elements;
+  capacity= max_elements;
+  leaf_count= active= 0;
+  needs_build= FALSE;
+  offset_to_key= offset;
+  set_max_at_top(max_at_top);
+  compare= cmp;
+  compare_arg= cmp_arg;
+  prefix_length= key_prefix_length;
+  nodes[0]= 0;
+  leaves[0].element= NULL;
+  DBUG_RETURN(FALSE);
+}
+
+
+void Loser_tree::end()
+{
+  my_free(leaves);
+  leaves= NULL;
+  nodes= winners= NULL;
+  capacity= leaf_count= active= 0;
+}
+
+
+/*
+  The first bytes of the key of an element, as a number that orders
+  as the bytes do
+*/
+
+ulonglong Loser_tree::key_prefix(const uchar *element) const
+{
+  const uchar *key= *(uchar**) (element + offset_to_key);
+  uint length= MY_MIN(prefix_length, LOSER_TREE_PREFIX_LENGTH);
+  ulonglong nr= 0;
+  uint i;
+
+  for (i= 0; i < length; i++)
+    nr= (nr << 8) | key[i];
+  for (; i < LOSER_TREE_PREFIX_LENGTH; i++)
+    nr<<= 8;
+  return nr;
+}
+
+
+/*
+  Check whether leaf a wins a match against leaf b
+
+  DESCRIPTION
+    A removed leaf loses against every other leaf. Of two equal elements
+    the one of the lower leaf wins, so that the merge is stable with
+    respect to the order of the leaves.
+*/
+
+inline bool Loser_tree::beats(uint a, uint b) const
+{
+  const Leaf *la= leaves + a, *lb= leaves + b;
+  int res;
+
+  if (unlikely(la->removed | lb->removed))
+    return lb->removed && (!la->removed || a < b);
+  if (prefix_length)
+  {
+    if (la->prefix != lb->prefix)
+      return (la->prefix < lb->prefix) == (sign > 0);
+    if (prefix_length <= LOSER_TREE_PREFIX_LENGTH)
+      return a < b;
+  }
+  res= compare(compare_arg, la->element + offset_to_key,
+               lb->element + offset_to_key) * sign;
+  return res < 0 || (res == 0 && a < b);
+}
+
+
+/*
+  Play all matches of the tree
+
+  DESCRIPTION
+    The winners of the matches are kept in winners[] only while the tree
+    is built, bottom up, so that every leaf is compared once per level.
+*/
+
+void Loser_tree::build()
+{
+  uint node;
+  needs_build= FALSE;
+  if (leaf_count <= 1)
+  {
+    nodes[0]= 0;
+    return;
+  }
+  for (node= leaf_count - 1; node > 0; node--)
+  {
+    uint left= 2 * node, right= left + 1;
+    left= left >= leaf_count ? left - leaf_count : winners[left];
+    right= right >= leaf_count ? right - leaf_count : winners[right];
+    if (beats(right, left))
+    {
+      winners[node]= right;
+      nodes[node]= left;
+    }
+    else
+    {
+      winners[node]= left;
+      nodes[node]= right;
+    }
+  }
+  nodes[0]= winners[1];
+}
+
+
+/* Play the matches from a leaf up to the root again */
+
+inline void Loser_tree::replay(uint leaf)
+{
+  uint winner= leaf;
+  for (uint node= (leaf + leaf_count) / 2; node > 0; node/= 2)
+  {
+    if (beats(nodes[node], winner))
+    {
+      uint loser= winner;
+      winner= nodes[node];
+      nodes[node]= loser;
+    }
+  }
+  nodes[0]= winner;
+}
+
+
+/*
+  Add a stream to the merge
+
+  DESCRIPTION
+    The matches are played when the winner is asked for the next time.
+    If all leaves are used, the removed ones are dropped first.
+*/
+
+void Loser_tree::insert(uchar *element)
+{
+  Leaf *leaf;
+  if (leaf_count == capacity)
+  {
+    uint to= 0;
+    for (uint from= 0; from < leaf_count; from++)
+    {
+      if (!leaves[from].removed)
+        leaves[to++]= leaves[from];
+    }
+    leaf_count= to;
+  }
+  DBUG_ASSERT(leaf_count < capacity);
+  leaf= leaves + leaf_count++;
+  leaf->element= element;
+  leaf->removed= FALSE;
+  if (prefix_length)
+    leaf->prefix= key_prefix(element);
+  active++;
+  needs_build= TRUE;
+}
+
+
+/* The key of the element on top has changed */
+
+void Loser_tree::replace_top()
+{
+  if (unlikely(needs_build))
+    build();
+  uint leaf= nodes[0];
+  DBUG_ASSERT(!leaves[leaf].removed);
+  if (prefix_length)
+    leaves[leaf].prefix= key_prefix(leaves[leaf].element);
+  replay(leaf);
+}
+
+
+/*
+  The stream of the element on top has ended
+
+  DESCRIPTION
+    The leaf stays in the tree and loses every match. If it was the last
+    one, the matches are not played, so the element stays on top.
+*/
+
+void Loser_tree::remove_top()
+{
+  if (unlikely(needs_build))
+    build();
+  uint leaf= nodes[0];
+  DBUG_ASSERT(!leaves[leaf].removed);
+  leaves[leaf].removed= TRUE;
+  if (--active)
+    replay(leaf);
+}
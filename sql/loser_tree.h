@@ -0,0 +1,133 @@
+/*
+   Copyright (c) 2019, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+#ifndef LOSER_TREE_INCLUDED
+#define LOSER_TREE_INCLUDED
+
+#include "my_base.h"
+#include <my_sys.h>                             /* myf */
+
+/*
+  Tournament tree for k-way merges.
+
+  The tree is used instead of a QUEUE where sorted streams are merged: the
+  runs of filesort() and the partitions of an ordered index scan over a
+  partitioned table. Each stream is a leaf, holding a pointer to the element
+  that describes the current position of the stream. Every inner node keeps
+  the leaf that lost the match played there, and the winner of the whole
+  tree is on top.
+
+  When the element on top changes, only the matches on the path from its
+  leaf to the root are played again, which takes log2(k) comparisons with
+  no further moves, while a binary heap needs up to 2*log2(k) of them.
+  Equal elements are returned in the order of their leaves, so a merge of
+  runs keeps the order of the runs for equal keys.
+
+  The interface follows that of QUEUE: the elements are passed to the
+  compare function as element + offset_to_key, and the caller changes the
+  element on top and calls replace_top() or remove_top().
+
+  If the elements point to keys that are compared as byte strings, as the
+  fixed size keys of filesort() are, the first bytes of every key may be
+  kept in the leaf (prefix_length of init()). The key pointer is then
+  found at element + offset_to_key. Most matches are decided by these
+  cached prefixes, without calling the compare function and without
+  touching the memory of the keys.
+*/
+
+class Loser_tree
+{
+public:
+  typedef int (*Compare)(void *arg, uchar *a, uchar *b);
+
+  Loser_tree()
+    :leaves(NULL), nodes(NULL), capacity(0), leaf_count(0), active(0),
+     needs_build(FALSE)
+  {}
+  ~Loser_tree() { end(); }
+
+  bool init(uint max_elements, uint offset, bool max_at_top, Compare cmp,
+            void *cmp_arg, uint key_prefix_length= 0,
+            myf flags= MYF(MY_WME));
+  void end();
+
+  void set_max_at_top(bool max_at_top)
+  {
+    sign= max_at_top ? -1 : 1;
+    needs_build= TRUE;
+  }
+  void set_compare_arg(void *arg) { compare_arg= arg; }
+
+  /* Number of elements that are not removed */
+  uint elements() const { return active; }
+
+  void insert(uchar *element);
+  void remove_all()
+  {
+    leaf_count= active= 0;
+    needs_build= FALSE;
+  }
+
+  /*
+    The winner. After the last element is removed this is still the
+    element removed last, as it is for QUEUE.
+  */
+  uchar *top()
+  {
+    if (unlikely(needs_build))
+      build();
+    return leaves[nodes[0]].element;
+  }
+  void replace_top();
+  void remove_top();
+
+  /* The elements in the order of insertion, NULL for a removed one */
+  uint leaf_elements() const { return leaf_count; }
+  uchar *leaf(uint i) const
+  {
+    return leaves[i].removed ? NULL : leaves[i].element;
+  }
+
+private:
+  struct Leaf
+  {
+    uchar *element;
+    ulonglong prefix;                   /* first bytes of the key */
+    bool removed;
+  };
+
+  Leaf *leaves;
+  /* nodes[0] is the winner, nodes[1..leaf_count-1] the losers */
+  uint *nodes;
+  uint *winners;                        /* used by build() */
+  uint capacity;
+  uint leaf_count;
+  uint active;
+  bool needs_build;
+
+  uint offset_to_key;
+  int sign;                             /* -1 if the largest is on top */
+  Compare compare;
+  void *compare_arg;
+  uint prefix_length;
+
+  ulonglong key_prefix(const uchar *element) const;
+  bool beats(uint a, uint b) const;
+  void build();
+  void replay(uint leaf);
+};
+
+#endif /* LOSER_TREE_INCLUDED */
@@ -37,8 +37,10 @@
 
 static int rr_quick(READ_RECORD *info);
 int rr_sequential(READ_RECORD *info);
+static int rr_sequential_batch(READ_RECORD *info);
 static int rr_from_tempfile(READ_RECORD *info);
 static int rr_unpack_from_tempfile(READ_RECORD *info);
+static int rr_unpack_packed_from_tempfile(READ_RECORD *info);
 static int rr_unpack_from_buffer(READ_RECORD *info);
 int rr_from_pointers(READ_RECORD *info);
 static int rr_from_cache(READ_RECORD *info);
@@ -153,6 +155,10 @@ bool init_read_record_idx(READ_RECORD *info, THD *thd, TABLE *table,
       Same as rr_unpack_from_buffer except that references are fetched from
       temporary file. Should obviously not really happen other than in
       strange configurations.
+    rr_unpack_packed_from_tempfile:
+    -------------------------------
+      Same as rr_unpack_from_tempfile for addon fields that are stored
+      with their length, see filesort->using_packed_addons.
 
     rr_from_tempfile:
     -----------------
@@ -229,7 +235,9 @@ bool init_read_record(READ_RECORD *info,THD *thd, TABLE *table,
   {
     DBUG_PRINT("info",("using rr_from_tempfile"));
     info->read_record_func=
-        addon_field ? rr_unpack_from_tempfile : rr_from_tempfile;
+        !addon_field ? rr_from_tempfile :
+        filesort->using_packed_addons ? rr_unpack_packed_from_tempfile :
+                                        rr_unpack_from_tempfile;
     info->io_cache= tempfile;
     reinit_io_cache(info->io_cache,READ_CACHE,0L,0,0);
     info->ref_pos=table->file->ref;
@@ -319,6 +327,45 @@ bool init_read_record(READ_RECORD *info,THD *thd, TABLE *table,
 
 
 
+/*
+  Make a table scan read the records in batches
+
+  SYNOPSIS
+    init_read_record_batch()
+      info      read structure set up by init_read_record() for a
+                sequential scan
+      buff      buffer for 'records' records of the table
+      records   the number of records to read from the engine at once
+
+  DESCRIPTION
+    After this call info->read_record() gets the records from 'buff',
+    that is refilled by handler::ha_rnd_next_batch() when all records
+    in it have been returned. The handler is positioned after the last
+    record of the batch, not after the record in record[0], so this
+    must not be used when the caller calls position(), update_row() or
+    delete_row() for the current record, nor for reads that lock the
+    records.
+
+  RETURN VALUE
+    TRUE     the scan now reads batches
+    FALSE    the scan is not a sequential one, nothing was changed
+*/
+
+bool init_read_record_batch(READ_RECORD *info, uchar *buff, uint records)
+{
+  DBUG_ASSERT(info->table->reginfo.lock_type == TL_READ ||
+              info->table->reginfo.lock_type == TL_READ_HIGH_PRIORITY);
+  if (info->read_record_func != rr_sequential || records < 2)
+    return FALSE;
+  info->batch_buff= info->batch_pos= info->batch_end= buff;
+  info->batch_records= records;
+  info->batch_error= 0;
+  info->reclength= info->table->s->reclength;
+  info->read_record_func= rr_sequential_batch;
+  return TRUE;
+}
+
+
 void end_read_record(READ_RECORD *info)
 {                   /* free cache if used */
   if (info->cache)
@@ -487,6 +534,38 @@ int rr_sequential(READ_RECORD *info)
 }
 
 
+/*
+  Read a record of a table scan from the rows read ahead by
+  handler::ha_rnd_next_batch(), see init_read_record_batch()
+*/
+
+static int rr_sequential_batch(READ_RECORD *info)
+{
+  TABLE *table= info->table;
+  if (info->batch_pos == info->batch_end)
+  {
+    int error;
+    uint rows;
+    if (unlikely((error= info->batch_error)))
+      return rr_handle_error(info, error);
+    error= table->file->ha_rnd_next_batch(info->batch_buff,
+                                          info->batch_records, &rows);
+    if (!rows)
+      return rr_handle_error(info, error);
+    /* Report the error after the rows that were read before it */
+    info->batch_error= error;
+    info->batch_pos= info->batch_buff;
+    info->batch_end= info->batch_buff + rows * info->reclength;
+  }
+  memcpy(info->record, info->batch_pos, info->reclength);
+  info->batch_pos+= info->reclength;
+  table->status= 0;
+  if (table->vfield)
+    table->update_virtual_fields(table->file, VCOL_UPDATE_FOR_READ);
+  return 0;
+}
+
+
 static int rr_from_tempfile(READ_RECORD *info)
 {
   int tmp;
@@ -532,6 +611,34 @@ static int rr_unpack_from_tempfile(READ_RECORD *info)
   return 0;
 }
 
+
+/**
+  Read a result set record with packed addon fields from a temporary file
+  after sorting: first their length, then the rest of them.
+
+  @param info          Reference to the context including record descriptors
+
+  @retval
+    0   Record successfully read.
+  @retval
+    -1   There is no record to be read anymore.
+*/
+
+static int rr_unpack_packed_from_tempfile(READ_RECORD *info)
+{
+  uchar *buff= info->rec_buf;
+  uint length;
+  if (my_b_read(info->io_cache, buff, SORT_ADDON_LENGTH_BYTES))
+    return -1;
+  length= uint2korr(buff);
+  DBUG_ASSERT(length <= info->ref_length);
+  if (my_b_read(info->io_cache, buff + SORT_ADDON_LENGTH_BYTES,
+                length - SORT_ADDON_LENGTH_BYTES))
+    return -1;
+  (*info->unpack)(info->addon_field, buff, buff + length);
+  return 0;
+}
+
 int rr_from_pointers(READ_RECORD *info)
 {
   int tmp;
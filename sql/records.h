@@ -65,6 +65,10 @@ struct READ_RECORD
   uchar *record;
   uchar *rec_buf;                /* to read field values  after filesort */
   uchar	*cache,*cache_pos,*cache_end,*read_positions;
+  /* Records read ahead by a batched table scan (rr_sequential_batch) */
+  uchar *batch_buff, *batch_pos, *batch_end;
+  uint batch_records;
+  int batch_error;
   struct st_sort_addon_field *addon_field;     /* Pointer to the fields info */
   struct st_io_cache *io_cache;
   bool print_error;
@@ -89,6 +93,7 @@ bool init_read_record(READ_RECORD *info, THD *thd, TABLE *reg_form,
                       bool print_errors, bool disable_rr_cache);
 bool init_read_record_idx(READ_RECORD *info, THD *thd, TABLE *table,
                           bool print_error, uint idx, bool reverse);
+bool init_read_record_batch(READ_RECORD *info, uchar *buff, uint records);
 
 void rr_unlock_row(st_join_table *tab);
 
@@ -162,6 +162,29 @@ class Table_access_tracker
 };
 
 
+/*
+  A class for collecting statistics about a hash join that has spilled
+  its join buffer to disk (see JOIN_CACHE_BNLH::spill_buffer()).
+*/
+
+class Join_spill_tracker
+{
+public:
+  Join_spill_tracker() :
+    r_spills(0), r_partitions(0), r_build_rows(0), r_probe_rows(0),
+    r_bytes(0)
+  {}
+
+  ha_rows r_spills; /* How many times the join was done with partitions */
+  ha_rows r_partitions; /* Total number of partitions */
+  ha_rows r_build_rows; /* Rows from the join buffer written to partitions */
+  ha_rows r_probe_rows; /* Rows from the joined table written to partitions */
+  ulonglong r_bytes; /* Total number of bytes written to partitions */
+
+  bool has_spilled() { return (r_spills != 0); }
+};
+
+
 class Json_writer;
 
 /*
@@ -620,8 +620,10 @@ typedef struct system_variables
   ulong max_allowed_packet;
   ulong max_error_count;
   ulong max_length_for_sort_data;
+  ulong max_parallel_degree;
   ulong max_recursive_iterations;
   ulong max_sort_length;
+  ulong max_sort_threads;
   ulong max_tmp_tables;
   ulong max_insert_delayed_threads;
   ulong min_examined_row_limit;
@@ -6082,6 +6084,15 @@ struct SORT_FIELD_ATTR
 {
   uint length;          /* Length of sort field */
   uint suffix_length;   /* Length suffix (0-4) */
+  /*
+    Packed sort keys: a string is stored as its value of at most
+    original_length bytes after its length in length_bytes bytes and is
+    compared with cs. length_bytes is 0 for a key part of fixed length.
+  */
+  uint length_bytes;
+  uint original_length;
+  CHARSET_INFO *cs;
+  bool maybe_null;      /* The key part starts with a null byte */
 };
 
 
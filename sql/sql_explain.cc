@@ -1628,6 +1628,9 @@ void Explain_table_access::tag_to_json(Json_writer *writer, enum explain_extra_t
     case ET_DISTINCT:
       writer->add_member("distinct").add_bool(true);
       break;
+    case ET_PARALLEL_SCAN:
+      writer->add_member("parallel_threads").add_ll(parallel_workers);
+      break;
 
     default:
       DBUG_ASSERT(0);
@@ -1868,6 +1871,19 @@ void Explain_table_access::print_explain_json(Explain_query *query,
         writer->add_double(jbuf_tracker.get_filtered_after_where()*100.0);
       else
         writer->add_null();
+      if (jbuf_spill_tracker.has_spilled())
+      {
+        writer->add_member("r_spill").start_object();
+        writer->add_member("r_loops").add_ll(jbuf_spill_tracker.r_spills);
+        writer->add_member("r_partitions").
+          add_ll(jbuf_spill_tracker.r_partitions);
+        writer->add_member("r_build_rows").
+          add_ll(jbuf_spill_tracker.r_build_rows);
+        writer->add_member("r_probe_rows").
+          add_ll(jbuf_spill_tracker.r_probe_rows);
+        writer->add_member("r_bytes").add_size(jbuf_spill_tracker.r_bytes);
+        writer->end_object(); // "r_spill"
+      }
     }
   }
 
@@ -1949,6 +1965,8 @@ const char * extra_tag_text[]=
   "Const row not found",
   "Unique row not found",
   "Impossible ON condition",
+
+  "Parallel scan", // special handling
 };
 
 
@@ -2015,6 +2033,14 @@ void Explain_table_access::append_tag_name(String *str, enum explain_extra_tag t
         str->append(" (scanning)");
       break;
     }
+    case ET_PARALLEL_SCAN:
+    {
+      str->append(extra_tag_text[tag]);
+      str->append(STRING_WITH_LEN(" ("));
+      str->append_ulonglong(parallel_workers);
+      str->append(STRING_WITH_LEN(" threads)"));
+      break;
+    }
     default:
      str->append(extra_tag_text[tag]);
   }
@@ -548,6 +548,8 @@ enum explain_extra_tag
   ET_UNIQUE_ROW_NOT_FOUND,
   ET_IMPOSSIBLE_ON_CONDITION,
 
+  ET_PARALLEL_SCAN,
+
   ET_total
 };
 
@@ -743,6 +745,8 @@ class Explain_table_access : public Sql_alloc
   String_list used_partitions_list;
   // valid with ET_USING_MRR
   StringBuffer<32> mrr_type;
+  // valid with ET_PARALLEL_SCAN
+  uint parallel_workers;
   StringBuffer<32> firstmatch_table_name;
 
   /* 
@@ -835,6 +839,7 @@ class Explain_table_access : public Sql_alloc
   Table_access_tracker tracker;
   Exec_time_tracker op_tracker;
   Table_access_tracker jbuf_tracker;
+  Join_spill_tracker jbuf_spill_tracker;
   
   Explain_rowid_filter *rowid_filter;
 
@@ -0,0 +1,279 @@
+/*
+   Copyright (c) 2019, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+/*
+  This file implements the in-memory hash table used to aggregate the
+  groups of GROUP BY without updating the temporary table for every row.
+  See end_hash_update() in sql_select.cc for how it is used.
+*/
+
+#include "mariadb.h"
+#include "sql_priv.h"
+#include "sql_group_hash.h"
+#include "key.h"
+
+/* Initial number of slots of the hash table */
+#define GROUP_HASH_MIN_SLOTS 256
+
+
+Group_hash_table::Group_hash_table(TABLE *table, size_t group_length)
+  :key_info(table->key_info),
+   key_parts(table->key_info->user_defined_key_parts),
+   key_length(group_length),
+   rec_length(table->s->reclength),
+   slots(NULL), slot_count(0), first(NULL), last(&first), groups(0),
+   max_memory(0), used_memory(0)
+{
+  entry_length= ALIGN_SIZE(sizeof(Entry)) + ALIGN_SIZE(key_length) +
+                rec_length;
+  init_alloc_root(&mem_root, "Group_hash_table",
+                  MY_MAX(entry_length * 64, 8192), 0,
+                  MYF(MY_THREAD_SPECIFIC));
+}
+
+
+/*
+  Allocate the hash table
+
+  SYNOPSIS
+    init()
+      memory_limit   the memory the table may use before it is full
+
+  DESCRIPTION
+    The function allocates the initial array of slots for the hash table,
+    unless this has already been done for an earlier execution of the
+    query.
+
+  RETURN VALUE
+    FALSE    on success
+    TRUE     out of memory
+*/
+
+bool Group_hash_table::init(ulonglong memory_limit)
+{
+  max_memory= memory_limit;
+  if (slots)
+    return FALSE;
+  slot_count= GROUP_HASH_MIN_SLOTS;
+  if (!(slots= (Entry **) my_malloc(slot_count * sizeof(Entry *),
+                                    MYF(MY_THREAD_SPECIFIC | MY_ZEROFILL |
+                                        MY_WME))))
+    return TRUE;
+  used_memory= slot_count * sizeof(Entry *);
+  return FALSE;
+}
+
+
+/*
+  Remove all groups from the hash table
+
+  SYNOPSIS
+    reset()
+
+  DESCRIPTION
+    The function empties the hash table, keeping its slot array for the
+    next groups. The memory of the entries is released.
+*/
+
+void Group_hash_table::reset()
+{
+  if (groups)
+  {
+    bzero(slots, slot_count * sizeof(Entry *));
+    free_root(&mem_root, MYF(MY_MARK_BLOCKS_FREE));
+  }
+  first= NULL;
+  last= &first;
+  groups= 0;
+  used_memory= slot_count * sizeof(Entry *);
+}
+
+
+/* Release all memory of the hash table */
+
+void Group_hash_table::free()
+{
+  my_free(slots);
+  slots= NULL;
+  slot_count= 0;
+  free_root(&mem_root, MYF(0));
+  first= NULL;
+  last= &first;
+  groups= 0;
+  used_memory= 0;
+}
+
+
+/*
+  Double the number of slots of the hash table
+
+  SYNOPSIS
+    grow()
+
+  DESCRIPTION
+    The function allocates a new array of slots twice as large as the
+    current one and rehashes all entries into it, using the hash values
+    saved in the entries.
+
+  RETURN VALUE
+    FALSE    on success
+    TRUE     out of memory
+*/
+
+bool Group_hash_table::grow()
+{
+  ulong new_count= slot_count * 2;
+  Entry **new_slots;
+  if (!(new_slots= (Entry **) my_malloc(new_count * sizeof(Entry *),
+                                        MYF(MY_THREAD_SPECIFIC | MY_ZEROFILL |
+                                            MY_WME))))
+    return TRUE;
+  for (Entry *entry= first; entry; entry= entry->next)
+  {
+    ulong idx= entry->hash & (new_count - 1);
+    while (new_slots[idx])
+      idx= (idx + 1) & (new_count - 1);
+    new_slots[idx]= entry;
+  }
+  my_free(slots);
+  used_memory+= (new_count - slot_count) * sizeof(Entry *);
+  slots= new_slots;
+  slot_count= new_count;
+  return FALSE;
+}
+
+
+/*
+  Check whether two group keys belong to different groups
+
+  SYNOPSIS
+    cmp_keys()
+      key1      the first key
+      key2      the second key
+
+  DESCRIPTION
+    The keys are compared as the unique group index of the temporary
+    table compares them: NULLs are equal to each other, strings are
+    compared according to their collations, so trailing spaces are
+    ignored for PAD SPACE collations, other values are compared byte
+    by byte. Unlike key_buf_cmp() the function does not treat strings
+    of different lengths as different.
+
+  RETURN VALUE
+    TRUE    the keys are different
+    FALSE   the keys are equal
+*/
+
+bool Group_hash_table::cmp_keys(const uchar *key1, const uchar *key2)
+{
+  KEY_PART_INFO *key_part= key_info->key_part;
+  KEY_PART_INFO *end_key_part= key_part + key_parts;
+
+  for (; key_part < end_key_part; key_part++)
+  {
+    const uchar *pos1= key1;
+    const uchar *pos2= key2;
+    bool is_varchar= FALSE;
+
+    switch (key_part->type) {
+    case HA_KEYTYPE_VARTEXT1:
+    case HA_KEYTYPE_VARBINARY1:
+    case HA_KEYTYPE_VARTEXT2:
+    case HA_KEYTYPE_VARBINARY2:
+      is_varchar= TRUE;
+      break;
+    default:
+      ;
+    }
+    key1+= key_part->length + (is_varchar ? HA_KEY_BLOB_LENGTH : 0);
+    key2+= key_part->length + (is_varchar ? HA_KEY_BLOB_LENGTH : 0);
+    if (key_part->null_bit)
+    {
+      key1++; key2++;                           /* Skip null byte */
+      if (*pos1 != *pos2)
+        return TRUE;
+      if (*pos1)                                /* Both are null */
+        continue;
+      pos1++; pos2++;
+    }
+    if (key_part->type == HA_KEYTYPE_TEXT || is_varchar)
+    {
+      if (key_part->field->key_cmp(pos1, pos2))
+        return TRUE;
+    }
+    else if (memcmp(pos1, pos2, key1 - pos1))
+      return TRUE;
+  }
+  return FALSE;
+}
+
+
+/*
+  Find the group for a key, adding a new group if there is none
+
+  SYNOPSIS
+    find_or_add()
+      key       the packed group key, in the format of the group key
+                of the temporary table
+      found     OUT: TRUE if the group already existed
+
+  DESCRIPTION
+    The function looks up the group with the given key by linear probing.
+    Keys that differ as byte sequences but are equal according to the
+    collations of their key parts belong to the same group, as in the
+    unique index of the temporary table.
+    If there is no such group, a new entry is added with a copy of the key.
+    The record of a new group is not initialized: the caller is supposed
+    to fill it.
+
+  RETURN VALUE
+    pointer to the record of the group
+    NULL     out of memory
+*/
+
+uchar *Group_hash_table::find_or_add(const uchar *key, bool *found)
+{
+  my_hash_value_type hash= (my_hash_value_type) key_hashnr(key_info,
+                                                           key_parts, key);
+  ulong idx= hash & (slot_count - 1);
+  Entry *entry;
+
+  for (; (entry= slots[idx]) ; idx= (idx + 1) & (slot_count - 1))
+  {
+    if (entry->hash == hash && !cmp_keys(entry_key(entry), key))
+    {
+      *found= TRUE;
+      return entry_rec(entry);
+    }
+  }
+  *found= FALSE;
+
+  if (!(entry= (Entry *) alloc_root(&mem_root, entry_length)))
+    return NULL;
+  entry->next= NULL;
+  entry->hash= hash;
+  memcpy(entry_key(entry), key, key_length);
+  slots[idx]= entry;
+  *last= entry;
+  last= &entry->next;
+  groups++;
+  used_memory+= entry_length;
+
+  /* Keep the load factor of the table at most 1/2 */
+  if (groups * 2 > slot_count && grow())
+    return NULL;
+  return entry_rec(entry);
+}
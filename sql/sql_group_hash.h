@@ -0,0 +1,91 @@
+/*
+   Copyright (c) 2019, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+#ifndef SQL_GROUP_HASH_INCLUDED
+#define SQL_GROUP_HASH_INCLUDED
+
+#include "sql_select.h"
+
+/*
+  In-memory hash table for GROUP BY over rows coming in arbitrary order.
+
+  When the grouping is done through a temporary table with a unique group
+  key, every row of the join costs an index lookup and an update of the
+  temporary table (see end_update()). With the optimizer switch
+  hash_group_by the groups are kept in this table instead: the key of
+  an entry is the packed group key as it is built in group_buff, the
+  payload is the image of the temporary table record that holds the
+  values of the group fields and the aggregate functions of the group.
+  The records are written into the temporary table only once, when all
+  rows have been aggregated or when the table grows over the memory
+  limit of in-memory temporary tables.
+*/
+
+class Group_hash_table :public Sql_alloc
+{
+  struct Entry
+  {
+    Entry *next;                 /* next entry in the order of insertion */
+    my_hash_value_type hash;
+  };
+
+  KEY *key_info;
+  uint key_parts;
+  /* Length of the group key and of the record of the temporary table */
+  size_t key_length;
+  size_t rec_length;
+  size_t entry_length;
+
+  /* Memory for the entries */
+  MEM_ROOT mem_root;
+  /* The open-addressing hash table, size is a power of 2 */
+  Entry **slots;
+  ulong slot_count;
+
+  Entry *first;
+  Entry **last;
+  ha_rows groups;
+
+  /* Memory limit and current memory usage */
+  ulonglong max_memory;
+  ulonglong used_memory;
+
+  uchar *entry_key(Entry *entry)
+  { return (uchar *) entry + ALIGN_SIZE(sizeof(Entry)); }
+  uchar *entry_rec(Entry *entry)
+  { return entry_key(entry) + ALIGN_SIZE(key_length); }
+  bool grow();
+  bool cmp_keys(const uchar *key1, const uchar *key2);
+
+public:
+  Group_hash_table(TABLE *table, size_t group_length);
+  ~Group_hash_table() { free(); }
+
+  bool init(ulonglong memory_limit);
+  void free();
+  void reset();
+
+  uchar *find_or_add(const uchar *key, bool *found);
+  bool is_full() { return used_memory > max_memory; }
+  ha_rows elements() { return groups; }
+
+  /* Iteration over the records in the order of insertion */
+  void *first_group() { return first; }
+  void *next_group(void *group) { return ((Entry *) group)->next; }
+  uchar *group_record(void *group) { return entry_rec((Entry *) group); }
+};
+
+#endif /* SQL_GROUP_HASH_INCLUDED */
@@ -3325,6 +3325,48 @@ uint JOIN_CACHE_HASHED::get_next_key(uchar ** key)
 }
 
 
+/* 
+  Get the number of the spill partition for a key value
+
+  SYNOPSIS
+    get_spill_part()
+      key             pointer to the key value
+      parts           the number of partitions
+
+  DESCRIPTION
+    The function calculates the number of the partition file into which
+    the records with the given join key are written when the join buffer
+    is spilled. Like the hash function of the hash table it guarantees
+    the same partition for any two equal keys that may differ as byte
+    sequences. The partition is taken from the high bits of the hash value,
+    so that the records of one partition still spread over all entries of
+    the hash table when they are put back into the join buffer.
+
+  RETURN VALUE
+    the number of the partition for the given key, less than parts
+*/
+
+uint JOIN_CACHE_HASHED::get_spill_part(uchar *key, uint parts)
+{
+  ulong nr;
+  if (hash_func == &JOIN_CACHE_HASHED::get_hash_idx_complex)
+    nr= key_hashnr(ref_key_info, ref_used_key_parts, key);
+  else
+  {
+    ulong nr2= 4;
+    uchar *pos= key;
+    uchar *end= key+key_length;
+    nr= 1;
+    for (; pos < end ; pos++)
+    {
+      nr^= (ulong) ((((uint) nr & 63)+nr2)*((uint) *pos))+ (nr << 8);
+      nr2+= 3;
+    }
+  }
+  return (uint) (((ulonglong) (uint32) (nr * 2654435761UL) * parts) >> 32);
+}
+
+
 /* 
   Initiate an iteration process over records in the joined table
 
@@ -3472,6 +3514,56 @@ void JOIN_TAB_SCAN::close()
 }
 
 
+/* 
+  Initiate an iteration process over records of a join_tab partition
+
+  SYNOPSIS
+    open()
+
+  DESCRIPTION
+    The function initiates the process of iteration over the records of
+    join_tab written into the partition file 'file' by
+    JOIN_CACHE_BNLH::spill_join_tab.
+
+  RETURN VALUE   
+    0            the initiation is a success 
+    error code   otherwise     
+*/
+
+int JOIN_TAB_SCAN_SPILL::open()
+{
+  save_or_restore_used_tabs(join_tab, FALSE);
+  return reinit_io_cache(file, READ_CACHE, 0L, 0, 0);
+}
+
+
+/* 
+  Read the next record of a join_tab partition
+
+  SYNOPSIS
+    next()
+
+  DESCRIPTION
+    The function reads the next record from the partition file into the
+    record buffer of join_tab. The record has been checked against the
+    condition pushed to join_tab before it was written into the file.
+
+  RETURN VALUE   
+    0            the next record exists and has been successfully read 
+    -1           there are no more records in the partition
+    error code   otherwise     
+*/
+
+int JOIN_TAB_SCAN_SPILL::next()
+{
+  TABLE *table= join_tab->table;
+  if (my_b_read(file, table->record[0], table->s->reclength))
+    return file->error ? 1 : -1;
+  table->status= 0;
+  return 0;
+}
+
+
 /*
   Prepare to iterate over the BNL join cache buffer to look for matches 
 
@@ -3803,12 +3895,442 @@ void JOIN_CACHE_BNLH::read_next_candidate_for_match(uchar *rec_ptr)
 
 int JOIN_CACHE_BNLH::init(bool for_explain)
 {
+  int rc;
   DBUG_ENTER("JOIN_CACHE_BNLH::init");
 
   if (!(join_tab_scan= new JOIN_TAB_SCAN(join, join_tab)))
     DBUG_RETURN(1);
 
-  DBUG_RETURN(JOIN_CACHE_HASHED::init(for_explain));
+  if ((rc= JOIN_CACHE_HASHED::init(for_explain)) || for_explain)
+    DBUG_RETURN(rc);
+
+  spill_parts= 0;
+  spill_error= FALSE;
+  if ((can_spill= check_spill_possible()))
+  {
+    THD *thd= join->thd;
+    size_t rec_buff_size= MY_MAX(pack_length, join_tab->table->s->reclength);
+    if (!(spill_scan= new JOIN_TAB_SCAN_SPILL(join, join_tab)) ||
+        !(spill_files= (IO_CACHE*) thd->calloc(sizeof(IO_CACHE) * 2 *
+                                               JOIN_CACHE_SPILL_MAX_PARTS)) ||
+        !(spill_rec_buff= (uchar*) thd->alloc(rec_buff_size)))
+      DBUG_RETURN(1);
+  }
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Check whether the BNLH join buffer can be spilled into partition files
+
+  SYNOPSIS
+    check_spill_possible()
+
+  DESCRIPTION
+    The function checks whether the records of the join buffer and of the
+    joined table can be written into partition files and joined partition
+    by partition, when the join buffer gets full, instead of scanning
+    join_tab once for every refill of the join buffer. 
+    This is done only if the optimizer switch join_cache_spill is set and
+    the records are self-contained: no other join cache is linked to this
+    one, no blobs have to be saved and no match flags are needed, that is,
+    join_tab is not an inner table of an outer join or a semi-join.
+    The position of the current record of join_tab must not be needed by
+    the following join operations either.
+
+  RETURN VALUE
+    TRUE    the join buffer can be spilled
+    FALSE   otherwise
+*/
+
+bool JOIN_CACHE_BNLH::check_spill_possible()
+{
+  return (optimizer_flag(join->thd, OPTIMIZER_SWITCH_JOIN_CACHE_SPILL) &&
+          !prev_cache && !next_cache && !blobs && !with_match_flag &&
+          !join_tab->first_inner && !join_tab->first_sj_inner_tab &&
+          !join_tab->bush_children && !join_tab->keep_current_rowid &&
+          !join_tab->table->s->blob_fields);
+}
+
+
+/*
+  Add a record into the buffer of a BNLH join cache
+
+  SYNOPSIS
+    put_record()
+
+  DESCRIPTION
+    This implementation of the virtual function put_record adds the record
+    to the join buffer as JOIN_CACHE_HASHED::put_record does. If the join
+    buffer gets full and it can be spilled then all records from the buffer
+    are written into partition files instead of being joined with join_tab
+    right now. In this case the partitions are joined in join_records when
+    all records have been put.
+
+  RETURN VALUE
+    TRUE    if it has been decided that it should be the last record
+            in the join buffer,
+    FALSE   otherwise
+*/
+
+bool JOIN_CACHE_BNLH::put_record()
+{
+  bool is_full= JOIN_CACHE_HASHED::put_record();
+
+  if (!is_full || !can_spill)
+    return is_full;
+  if (!spill_parts && start_spill())
+    return is_full;
+  if (spill_buffer())
+  {
+    /* Let the join_records call that follows report the error */
+    spill_error= TRUE;
+    return is_full;
+  }
+  return FALSE;
+}
+
+
+/*
+  Join records from the buffer of a BNLH join cache
+
+  SYNOPSIS
+    join_records()
+      skip_last    do not find matches for the last record from the buffer
+
+  DESCRIPTION
+    If the join buffer has been spilled the function joins the records from
+    the partition files, otherwise it calls JOIN_CACHE::join_records.
+
+  RETURN VALUE
+    return one of enum_nested_loop_state, except NESTED_LOOP_NO_MORE_ROWS.
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::join_records(bool skip_last)
+{
+  if (!spill_parts)
+    return JOIN_CACHE::join_records(skip_last);
+  DBUG_ASSERT(!skip_last);
+  return join_spilled_records();
+}
+
+
+/*
+  Start spilling the BNLH join buffer into partition files
+
+  SYNOPSIS
+    start_spill()
+
+  DESCRIPTION
+    The function is called when the join buffer gets full for the first time.
+    It chooses the number of partitions such that the records of the join
+    buffer expected for one partition fit into the join buffer, allowing for
+    some skew in the distribution of the join keys, and initializes the
+    partition files. The files are created in the temporary directory
+    only when their cache buffers overflow.
+
+  RETURN VALUE
+    FALSE   the join buffer is to be spilled
+    TRUE    the join buffer cannot be spilled
+*/
+
+bool JOIN_CACHE_BNLH::start_spill()
+{
+  DBUG_ENTER("JOIN_CACHE_BNLH::start_spill");
+
+  /* Another join cache may have been linked to this one after init() */
+  if (next_cache || join_tab->keep_current_rowid)
+  {
+    can_spill= FALSE;
+    DBUG_RETURN(TRUE);
+  }
+
+  double parts= 2 * (join_tab-1)->get_partial_join_cardinality() / records;
+  spill_parts= parts < 2 ? 2 :
+               parts > JOIN_CACHE_SPILL_MAX_PARTS ? JOIN_CACHE_SPILL_MAX_PARTS :
+               (uint) parts;
+
+  for (uint i= 0; i < spill_parts; i++)
+  {
+    if (open_cached_file(spill_files + i, mysql_tmpdir, TEMP_PREFIX,
+                         IO_SIZE * 4, MYF(MY_WME)) ||
+        open_cached_file(spill_files + JOIN_CACHE_SPILL_MAX_PARTS + i,
+                         mysql_tmpdir, TEMP_PREFIX, IO_SIZE * 4, MYF(MY_WME)))
+    {
+      end_spill();
+      can_spill= FALSE;
+      DBUG_RETURN(TRUE);
+    }
+  }
+  DBUG_PRINT("info", ("spilling the join buffer into %u partitions",
+                      spill_parts));
+  DBUG_RETURN(FALSE);
+}
+
+
+/*
+  Write all records from the BNLH join buffer into partition files
+
+  SYNOPSIS
+    spill_buffer()
+
+  DESCRIPTION
+    The function reads the records from the join buffer one by one,
+    builds the join key for each of them as put_record does and appends
+    the record to the partition file for this key. Every record is written
+    as its length followed by the flag and data fields of the record
+    as they are stored in the join buffer.
+    After this the join buffer is reset for writing.
+
+  RETURN VALUE
+    FALSE   on success
+    TRUE    if writing into a partition file failed
+*/
+
+bool JOIN_CACHE_BNLH::spill_buffer()
+{
+  TABLE_REF *ref= &join_tab->ref;
+  Join_spill_tracker *tracker= join_tab->jbuf_spill_tracker;
+  DBUG_ENTER("JOIN_CACHE_BNLH::spill_buffer");
+
+  reset(FALSE);
+  while (!get_record())
+  {
+    uchar *key;
+    uchar len_buff[4];
+    size_t len= pos-curr_rec_pos;
+
+    if (use_emb_key)
+      key= get_curr_emb_key();
+    else
+    {
+      cp_buffer_from_ref(join->thd, join_tab->table, ref);
+      key= ref->key_buff;
+    }
+    IO_CACHE *file= spill_files+get_spill_part(key, spill_parts);
+    int4store(len_buff, (uint32) len);
+    if (my_b_write(file, len_buff, sizeof(len_buff)) ||
+        my_b_write(file, curr_rec_pos, len))
+      DBUG_RETURN(TRUE);
+    tracker->r_build_rows++;
+    tracker->r_bytes+= sizeof(len_buff)+len;
+  }
+  reset(TRUE);
+  DBUG_RETURN(FALSE);
+}
+
+
+/*
+  Write the records of join_tab into partition files
+
+  SYNOPSIS
+    spill_join_tab()
+
+  DESCRIPTION
+    The function scans join_tab once and appends each record that meets
+    the condition pushed to join_tab to the partition file for the join
+    key of the record. The record is written as the image of the record
+    buffer of the table.
+
+  RETURN VALUE
+    return one of enum_nested_loop_state
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::spill_join_tab()
+{
+  int error;
+  enum_nested_loop_state rc;
+  TABLE *table= join_tab->table;
+  KEY *keyinfo= join_tab->get_keyinfo_by_key_no(join_tab->ref.key);
+  Join_spill_tracker *tracker= join_tab->jbuf_spill_tracker;
+  DBUG_ENTER("JOIN_CACHE_BNLH::spill_join_tab");
+
+  if ((rc= join_tab_execution_startup(join_tab)) < 0)
+    DBUG_RETURN(rc);
+
+  if (!(error= join_tab_scan->open()))
+  {
+    while (!(error= join_tab_scan->next()))
+    {
+      if (unlikely(join->thd->check_killed()))
+      {
+        rc= NESTED_LOOP_KILLED;
+        break;
+      }
+      key_copy(key_buff, table->record[0], keyinfo, key_length, TRUE);
+      IO_CACHE *file= spill_files + JOIN_CACHE_SPILL_MAX_PARTS +
+                      get_spill_part(key_buff, spill_parts);
+      if (my_b_write(file, table->record[0], table->s->reclength))
+      {
+        rc= NESTED_LOOP_ERROR;
+        break;
+      }
+      tracker->r_probe_rows++;
+      tracker->r_bytes+= table->s->reclength;
+    }
+  }
+  if (error > 0)
+    rc= NESTED_LOOP_ERROR;
+  join_tab_scan->close();
+  DBUG_RETURN(rc);
+}
+
+
+/*
+  Read a spilled record into the record buffers
+
+  SYNOPSIS
+    read_spilled_record()
+      rec_ptr   the flag and data fields of the record as written
+                by spill_buffer
+
+  DESCRIPTION
+    The function reads all flag and data fields of a record that has been
+    read from a partition file into the corresponding record buffers,
+    the same way as read_all_record_fields does for a record in the join
+    buffer.
+
+  RETURN VALUE
+    none
+*/
+
+void JOIN_CACHE_BNLH::read_spilled_record(uchar *rec_ptr)
+{
+  uchar *save_pos= pos;
+  pos= rec_ptr;
+  read_flag_fields();
+  CACHE_FIELD *copy= field_descr+flag_fields;
+  CACHE_FIELD *copy_end= field_descr+fields;
+  for ( ; copy < copy_end; copy++)
+    read_record_field(copy, FALSE);
+  pos= save_pos;
+}
+
+
+/*
+  Join the records from the partition files of a BNLH join cache
+
+  SYNOPSIS
+    join_spilled_records()
+
+  DESCRIPTION
+    The function is called instead of JOIN_CACHE::join_records when all
+    records have been put into a join cache whose buffer has been spilled.
+    It writes the remaining records from the join buffer and the records
+    of join_tab into partition files. Then for each partition it puts the
+    records from the join buffer partition back into the join buffer and
+    looks for their matches among the records of the join_tab partition
+    with JOIN_CACHE::join_records, where the companion object spill_scan
+    is used to iterate over the records of join_tab. If the records of a
+    partition do not fit into the join buffer then the join_tab partition
+    is read once for every refill of the join buffer.
+    Thus join_tab is scanned only once, whatever the number of records
+    in the join buffer.
+
+  RETURN VALUE
+    return one of enum_nested_loop_state, except NESTED_LOOP_NO_MORE_ROWS.
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::join_spilled_records()
+{
+  enum_nested_loop_state rc;
+  JOIN_TAB_SCAN *save_join_tab_scan= join_tab_scan;
+  Join_spill_tracker *tracker= join_tab->jbuf_spill_tracker;
+  DBUG_ENTER("JOIN_CACHE_BNLH::join_spilled_records");
+
+  if (spill_error || spill_buffer())
+  {
+    rc= NESTED_LOOP_ERROR;
+    goto finish;
+  }
+  if ((rc= spill_join_tab()) != NESTED_LOOP_OK)
+    goto finish;
+
+  tracker->r_spills++;
+  tracker->r_partitions+= spill_parts;
+
+  join_tab_scan= spill_scan;
+  for (uint part= 0; part < spill_parts; part++)
+  {
+    IO_CACHE *file= spill_files+part;
+    IO_CACHE *join_tab_file= spill_files+JOIN_CACHE_SPILL_MAX_PARTS+part;
+
+    /* A partition without records of join_tab cannot have any matches */
+    if (!my_b_tell(file) || !my_b_tell(join_tab_file))
+      continue;
+    if (reinit_io_cache(file, READ_CACHE, 0L, 0, 0))
+    {
+      rc= NESTED_LOOP_ERROR;
+      goto finish;
+    }
+    spill_scan->set_file(join_tab_file);
+
+    for (;;)
+    {
+      uchar len_buff[4];
+      if (my_b_read(file, len_buff, sizeof(len_buff)))
+      {
+        if (file->error)
+        {
+          rc= NESTED_LOOP_ERROR;
+          goto finish;
+        }
+        break;
+      }
+      if (my_b_read(file, spill_rec_buff, uint4korr(len_buff)))
+      {
+        rc= NESTED_LOOP_ERROR;
+        goto finish;
+      }
+      read_spilled_record(spill_rec_buff);
+      if (JOIN_CACHE_HASHED::put_record())
+      {
+        rc= JOIN_CACHE::join_records(FALSE);
+        if (rc != NESTED_LOOP_OK && rc != NESTED_LOOP_NO_MORE_ROWS)
+          goto finish;
+      }
+    }
+    if (records)
+    {
+      rc= JOIN_CACHE::join_records(FALSE);
+      if (rc != NESTED_LOOP_OK && rc != NESTED_LOOP_NO_MORE_ROWS)
+        goto finish;
+    }
+  }
+  rc= NESTED_LOOP_OK;
+
+finish:
+  join_tab_scan= save_join_tab_scan;
+  end_spill();
+  reset(TRUE);
+  DBUG_PRINT("exit", ("rc: %d", rc));
+  DBUG_RETURN(rc);
+}
+
+
+/*
+  Close the partition files of a BNLH join cache
+
+  SYNOPSIS
+    end_spill()
+
+  DESCRIPTION
+    The function closes the partition files, which removes them, and
+    resets the join cache to stop spilling.
+
+  RETURN VALUE
+    none
+*/
+
+void JOIN_CACHE_BNLH::end_spill()
+{
+  for (uint i= 0; i < spill_parts; i++)
+  {
+    close_cached_file(spill_files+i);
+    close_cached_file(spill_files+JOIN_CACHE_SPILL_MAX_PARTS+i);
+  }
+  spill_parts= 0;
+  spill_error= FALSE;
 }
 
 
@@ -23,6 +23,12 @@
 #define JOIN_CACHE_HASHED_BIT                2
 #define JOIN_CACHE_BKA_BIT                   4
 
+/* 
+  The maximal number of partitions a BNLH join buffer is spilled into
+  (see JOIN_CACHE_BNLH::spill_buffer)
+*/
+#define JOIN_CACHE_SPILL_MAX_PARTS          64
+
 /* 
   Categories of data fields of variable length written into join cache buffers.
   The value of any of these fields is written into cache together with the
@@ -659,7 +665,7 @@ class JOIN_CACHE :public Sql_alloc
   }
      
   /* Join records from the join buffer with records from the next join table */ 
-  enum_nested_loop_state join_records(bool skip_last);
+  virtual enum_nested_loop_state join_records(bool skip_last);
 
   /* Add a comment on the join algorithm employed by the join cache */
   virtual bool save_explain_data(EXPLAIN_BKA_TYPE *explain);
@@ -668,7 +674,7 @@ class JOIN_CACHE :public Sql_alloc
 
   virtual ~JOIN_CACHE() {}
   void reset_join(JOIN *j) { join= j; }
-  void free()
+  virtual void free()
   { 
     my_free(buff);
     buff= 0;
@@ -975,6 +981,9 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   /* Reallocate the join buffer of a hashed join cache */
   int realloc_buffer();
 
+  /* Get the number of the spill partition for a key value */
+  uint get_spill_part(uchar *key, uint parts);
+
   /* 
     This constructor creates an unlinked hashed join cache. The cache is to be
     used to join table 'tab' to the result of joining the previous tables 
@@ -1086,6 +1095,32 @@ class JOIN_TAB_SCAN: public Sql_alloc
 
 };
 
+/*
+  The class JOIN_TAB_SCAN_SPILL is a companion class for the class
+  JOIN_CACHE_BNLH. It implements the iterator over the records of the
+  joined table that have been written into a spill partition file by
+  JOIN_CACHE_BNLH::spill_join_tab(). The records are read back into the
+  record buffer of the joined table. They have already been checked against
+  the condition pushed to the table.
+*/
+
+class JOIN_TAB_SCAN_SPILL: public JOIN_TAB_SCAN
+{
+  /* The partition file to read the records from */
+  IO_CACHE *file;
+
+public:
+
+  JOIN_TAB_SCAN_SPILL(JOIN *j, JOIN_TAB *tab)
+    :JOIN_TAB_SCAN(j, tab), file(0) {}
+
+  void set_file(IO_CACHE *f) { file= f; }
+
+  int open();
+
+  int next();
+};
+
 /*
   The class JOIN_CACHE_BNL is used when the BNL join algorithm is
   employed to perform a join operation   
@@ -1178,6 +1213,57 @@ class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
 
   void read_next_candidate_for_match(uchar *rec_ptr);
 
+private:
+
+  /* 
+    This flag is set by init() if the join buffer can be spilled into
+    partition files when it gets full (optimizer_switch join_cache_spill)
+  */
+  bool can_spill;
+
+  /* 
+    The number of partitions the join is performed with, or 0 while the
+    join buffer has not been spilled
+  */
+  uint spill_parts;
+
+  /* 
+    Partition files: the records from the join buffer are written into
+    the first JOIN_CACHE_SPILL_MAX_PARTS elements, the records of join_tab
+    into the next JOIN_CACHE_SPILL_MAX_PARTS ones
+  */
+  IO_CACHE *spill_files;
+
+  /* Buffer to read a record from a partition file into */
+  uchar *spill_rec_buff;
+
+  /* The iterator over the records of join_tab in a partition file */
+  JOIN_TAB_SCAN_SPILL *spill_scan;
+
+  /* This flag is set if writing into a partition file failed */
+  bool spill_error;
+
+  /* Check whether the join buffer can be spilled at this moment */
+  bool check_spill_possible();
+
+  /* Start spilling the join buffer into partition files */
+  bool start_spill();
+
+  /* Write all records from the join buffer into partition files */
+  bool spill_buffer();
+
+  /* Write the records of join_tab into partition files */
+  enum_nested_loop_state spill_join_tab();
+
+  /* Read a record written by spill_buffer into the record buffers */
+  void read_spilled_record(uchar *rec_ptr);
+
+  /* Join the records from the partition files */
+  enum_nested_loop_state join_spilled_records();
+
+  /* Close the partition files */
+  void end_spill();
+
 public:
 
   /* 
@@ -1185,7 +1271,8 @@ class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
     used to join table 'tab' to the result of joining the previous tables 
     specified by the 'j' parameter.
   */   
-  JOIN_CACHE_BNLH(JOIN *j, JOIN_TAB *tab) : JOIN_CACHE_HASHED(j, tab) {}
+  JOIN_CACHE_BNLH(JOIN *j, JOIN_TAB *tab)
+    : JOIN_CACHE_HASHED(j, tab), can_spill(FALSE), spill_parts(0) {}
 
   /* 
     This constructor creates a linked BNLH join cache. The cache is to be 
@@ -1194,11 +1281,23 @@ class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
     cache object to which this cache is linked.
   */   
   JOIN_CACHE_BNLH(JOIN *j, JOIN_TAB *tab, JOIN_CACHE *prev) 
-    : JOIN_CACHE_HASHED(j, tab, prev) {}
+    : JOIN_CACHE_HASHED(j, tab, prev), can_spill(FALSE), spill_parts(0) {}
 
   /* Initialize the BNLH cache */       
   int init(bool for_explain);
 
+  /* Add a record into the buffer of a BNLH cache */
+  bool put_record();
+
+  /* Join records from the join buffer or from the partition files */
+  enum_nested_loop_state join_records(bool skip_last);
+
+  void free()
+  {
+    end_spill();
+    JOIN_CACHE::free();
+  }
+
   enum Join_algorithm get_join_alg() { return BNLH_JOIN_ALG; }
 
   bool is_key_access() { return TRUE; }
@@ -0,0 +1,1258 @@
+/*
+   Copyright (c) 2019, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+/*
+  This file implements the parallel scan of a table for aggregation.
+  See sql_parallel.h for the overview and choose_parallel_scan() in
+  sql_select.cc for the queries it is used for.
+*/
+
+#include "mariadb.h"
+#include "sql_priv.h"
+#include "sql_parallel.h"
+#include "mysqld.h"                     // key_thread_parallel_scan
+#include "transaction.h"                // trans_commit_stmt
+#include "item_cmpfunc.h"
+#include "item_sum.h"
+#include "key.h"
+#include "hash.h"
+
+/* Number of chunks of the primary key range per thread */
+#define PARALLEL_SCAN_CHUNKS_PER_THREAD 8
+/* The smallest memory limit for the partial groups of a thread */
+#define PARALLEL_SCAN_MIN_MEMORY (64*1024)
+/* How often the threads check whether the query has been killed */
+#define PARALLEL_SCAN_KILL_CHECK_ROWS 1024
+
+
+/*
+  Set up the access to a numeric field
+
+  SYNOPSIS
+    Parallel_column::init_value()
+      field     the field
+
+  RETURN VALUE
+    FALSE    the field is an integer or floating point field
+    TRUE     the values of the field cannot be read by the threads
+*/
+
+bool Parallel_column::init_value(Field *field)
+{
+  if (init_key(field))
+    return TRUE;
+  switch (field->type()) {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_LONGLONG:
+    type= (field->flags & UNSIGNED_FLAG) ? UINT_VALUE : INT_VALUE;
+    return FALSE;
+  case MYSQL_TYPE_FLOAT:
+    type= FLOAT_VALUE;
+    return FALSE;
+  case MYSQL_TYPE_DOUBLE:
+    type= DOUBLE_VALUE;
+    return FALSE;
+  default:
+    return TRUE;
+  }
+}
+
+
+/*
+  Set up the access to a field whose bytes are a part of a group key
+
+  SYNOPSIS
+    Parallel_column::init_key()
+      field     the field
+
+  DESCRIPTION
+    The group key of a partial group is made of the bytes of the group
+    fields, so values that are equal but are stored differently, e.g.
+    strings that differ only in letter case, get different partial
+    groups. This is harmless, as the partial groups are merged by the
+    usual GROUP BY code later.
+
+  RETURN VALUE
+    FALSE    OK
+    TRUE     the field is not stored in the record buffer
+*/
+
+bool Parallel_column::init_key(Field *field)
+{
+  if ((field->flags & BLOB_FLAG) || field->type() == MYSQL_TYPE_BIT ||
+      field->vcol_info)
+    return TRUE;
+  offset= field->offset(field->table->record[0]);
+  null_offset= field->null_ptr ? field->null_offset() : 0;
+  null_bit= field->null_ptr ? field->null_bit : 0;
+  length= field->pack_length();
+  length_bytes= field->real_type() == MYSQL_TYPE_VARCHAR ?
+                ((Field_varstring *) field)->length_bytes : 0;
+  type= INT_VALUE;
+  return FALSE;
+}
+
+
+longlong Parallel_column::val_int(const uchar *rec) const
+{
+  const uchar *ptr= rec + offset;
+  bool is_unsigned= type == UINT_VALUE;
+  switch (length) {
+  case 1:
+    return is_unsigned ? (longlong) *ptr : (longlong) (signed char) *ptr;
+  case 2:
+    return is_unsigned ? (longlong) uint2korr(ptr) : (longlong) sint2korr(ptr);
+  case 3:
+    return is_unsigned ? (longlong) uint3korr(ptr) : (longlong) sint3korr(ptr);
+  case 4:
+    return is_unsigned ? (longlong) uint4korr(ptr) : (longlong) sint4korr(ptr);
+  default:
+    return sint8korr(ptr);
+  }
+}
+
+
+double Parallel_column::val_real(const uchar *rec) const
+{
+  const uchar *ptr= rec + offset;
+  if (type == FLOAT_VALUE)
+  {
+    float nr;
+    float4get(nr, ptr);
+    return (double) nr;
+  }
+  if (type == DOUBLE_VALUE)
+  {
+    double nr;
+    float8get(nr, ptr);
+    return nr;
+  }
+  if (type == UINT_VALUE)
+    return ulonglong2double((ulonglong) val_int(rec));
+  return (double) val_int(rec);
+}
+
+
+/* Append the bytes of the field in the record to a group key */
+
+uchar *Parallel_column::store_key(uchar *to, const uchar *rec) const
+{
+  if (null_bit)
+  {
+    if ((*to++= is_null(rec) ? 1 : 0))
+      return to;
+  }
+  const uchar *ptr= rec + offset;
+  size_t key_length= length;
+  if (length_bytes)
+    key_length= length_bytes + (length_bytes == 1 ? (uint) *ptr :
+                                uint2korr(ptr));
+  memcpy(to, ptr, key_length);
+  return to + key_length;
+}
+
+
+/*
+  Compile a condition for checking it in the threads
+
+  SYNOPSIS
+    Parallel_cond::create()
+      thd       thread handle
+      cond      the condition attached to the table
+      table     the table
+
+  DESCRIPTION
+    The condition may be made of AND, OR, comparisons of numeric fields
+    with constants that Item_bool_rowready_func2::filter_batch() would
+    check without evaluating the items (see get_batch_filter_args()),
+    and IS [NOT] NULL over fields. The constants are evaluated for every
+    execution by fix_values().
+
+  RETURN VALUE
+    the compiled condition
+    NULL      the condition cannot be checked by the threads
+*/
+
+Parallel_cond *Parallel_cond::create(THD *thd, Item *cond, TABLE *table)
+{
+  Parallel_cond *res;
+  if (cond->type() == Item::COND_ITEM)
+  {
+    Item_cond *item_cond= (Item_cond *) cond;
+    List_iterator_fast<Item> li(*item_cond->argument_list());
+    Item *item;
+    uint i= 0;
+
+    if (!(res= new (thd->mem_root) Parallel_cond))
+      return NULL;
+    switch (item_cond->functype()) {
+    case Item_func::COND_AND_FUNC:
+      res->cond_type= AND_COND;
+      break;
+    case Item_func::COND_OR_FUNC:
+      res->cond_type= OR_COND;
+      break;
+    default:
+      return NULL;
+    }
+    res->arg_count= item_cond->argument_list()->elements;
+    if (!(res->args= (Parallel_cond **)
+          thd->alloc(res->arg_count * sizeof(Parallel_cond *))))
+      return NULL;
+    while ((item= li++))
+    {
+      if (!(res->args[i++]= create(thd, item, table)))
+        return NULL;
+    }
+    return res;
+  }
+
+  if (cond->type() != Item::FUNC_ITEM)
+    return NULL;
+  Item_func *func= (Item_func *) cond;
+  Field *field;
+  Item *value;
+  Item_func::Functype op;
+
+  switch (func->functype()) {
+  case Item_func::ISNULL_FUNC:
+  case Item_func::ISNOTNULL_FUNC:
+  {
+    Item *arg= func->arguments()[0]->real_item();
+    if (arg->type() != Item::FIELD_ITEM ||
+        (field= ((Item_field *) arg)->field)->table != table ||
+        !(res= new (thd->mem_root) Parallel_cond) ||
+        res->column.init_key(field))
+      return NULL;
+    res->cond_type= func->functype() == Item_func::ISNULL_FUNC ?
+                    IS_NULL_COND : IS_NOT_NULL_COND;
+    return res;
+  }
+  case Item_func::EQ_FUNC:
+  case Item_func::NE_FUNC:
+  case Item_func::LT_FUNC:
+  case Item_func::LE_FUNC:
+  case Item_func::GT_FUNC:
+  case Item_func::GE_FUNC:
+    if (!((Item_bool_rowready_func2 *) func)->
+          get_batch_filter_args(table, &field, &value, &op) ||
+        value->used_tables() & ~PARAM_TABLE_BIT ||
+        !(res= new (thd->mem_root) Parallel_cond) ||
+        res->column.init_value(field))
+      return NULL;
+    res->cond_type= CMP_COND;
+    res->op= op;
+    res->value_item= value;
+    return res;
+  default:
+    return NULL;
+  }
+}
+
+
+/*
+  Evaluate the constants of the condition
+
+  RETURN VALUE
+    FALSE    OK
+    TRUE     a constant is out of the range the threads can compare with,
+             or an error occurred
+*/
+
+bool Parallel_cond::fix_values()
+{
+  switch (cond_type) {
+  case AND_COND:
+  case OR_COND:
+    for (uint i= 0; i < arg_count; i++)
+    {
+      if (args[i]->fix_values())
+        return TRUE;
+    }
+    return FALSE;
+  case CMP_COND:
+    if (column.type == Parallel_column::FLOAT_VALUE ||
+        column.type == Parallel_column::DOUBLE_VALUE)
+      real_value= value_item->val_real();
+    else
+    {
+      int_value= value_item->val_int();
+      /* The constant does not fit into longlong */
+      if (!value_item->null_value && value_item->unsigned_flag &&
+          int_value < 0)
+        return TRUE;
+    }
+    null_value= value_item->null_value;
+    return current_thd->is_error();
+  default:
+    return FALSE;
+  }
+}
+
+
+template <class T>
+static bool compare_values(Item_func::Functype op, T a, T b)
+{
+  switch (op) {
+  case Item_func::EQ_FUNC:
+    return a == b;
+  case Item_func::NE_FUNC:
+    return a != b;
+  case Item_func::LT_FUNC:
+    return a < b;
+  case Item_func::LE_FUNC:
+    return a <= b;
+  case Item_func::GT_FUNC:
+    return a > b;
+  default:
+    return a >= b;
+  }
+}
+
+
+/* Check the condition for a record, like val_int() of the item would */
+
+bool Parallel_cond::check(const uchar *rec) const
+{
+  switch (cond_type) {
+  case AND_COND:
+    for (uint i= 0; i < arg_count; i++)
+    {
+      if (!args[i]->check(rec))
+        return FALSE;
+    }
+    return TRUE;
+  case OR_COND:
+    for (uint i= 0; i < arg_count; i++)
+    {
+      if (args[i]->check(rec))
+        return TRUE;
+    }
+    return FALSE;
+  case IS_NULL_COND:
+    return column.is_null(rec);
+  case IS_NOT_NULL_COND:
+    return !column.is_null(rec);
+  default:
+    if (null_value || column.is_null(rec))
+      return FALSE;
+    if (column.type == Parallel_column::FLOAT_VALUE ||
+        column.type == Parallel_column::DOUBLE_VALUE)
+      return compare_values(op, column.val_real(rec), real_value);
+    return compare_values(op, column.val_int(rec), int_value);
+  }
+}
+
+
+/*
+  Set up the computation of an aggregate function by the threads
+
+  SYNOPSIS
+    init_parallel_sum()
+      thd       thread handle
+      sum       the description to set up
+      item      the aggregate function
+      table     the scanned table
+
+  DESCRIPTION
+    COUNT, SUM and MIN/MAX without DISTINCT are supported, as they have
+    direct_add() to take the partial results. The argument has to be a
+    numeric field of the table, or a constant for COUNT.
+
+  RETURN VALUE
+    FALSE    OK
+    TRUE     the function cannot be computed by the threads
+*/
+
+static bool init_parallel_sum(THD *thd, Parallel_sum *sum, Item_sum *item,
+                              TABLE *table)
+{
+  Item *arg;
+  Field *field= NULL;
+
+  if (item->has_with_distinct() || item->get_arg_count() != 1)
+    return TRUE;
+  sum->item= item;
+  arg= item->get_arg(0)->real_item();
+  if (arg->type() == Item::FIELD_ITEM)
+  {
+    if ((field= ((Item_field *) arg)->field)->table != table)
+      return TRUE;
+  }
+  else if (!(item->sum_func() == Item_sum::COUNT_FUNC &&
+             arg->const_item() && !arg->maybe_null && !arg->is_expensive()))
+    return TRUE;
+
+  switch (item->sum_func()) {
+  case Item_sum::COUNT_FUNC:
+    if (!field)
+    {
+      sum->sum_type= Parallel_sum::COUNT_ROWS;
+      return FALSE;
+    }
+    sum->sum_type= Parallel_sum::COUNT_VALUES;
+    return sum->column.init_key(field);
+  case Item_sum::SUM_FUNC:
+    if (sum->column.init_value(field))
+      return TRUE;
+    if (sum->column.type == Parallel_column::FLOAT_VALUE ||
+        sum->column.type == Parallel_column::DOUBLE_VALUE)
+    {
+      sum->sum_type= Parallel_sum::SUM_REAL;
+      return item->result_type() != REAL_RESULT;
+    }
+    sum->sum_type= Parallel_sum::SUM_INT;
+    return item->result_type() != DECIMAL_RESULT;
+  case Item_sum::MIN_FUNC:
+  case Item_sum::MAX_FUNC:
+    if (sum->column.init_value(field))
+      return TRUE;
+    sum->sum_type= Parallel_sum::MIN_MAX;
+    sum->cmp_sign= item->sum_func() == Item_sum::MIN_FUNC ? -1 : 1;
+    if (sum->column.type == Parallel_column::FLOAT_VALUE ||
+        sum->column.type == Parallel_column::DOUBLE_VALUE)
+    {
+      if (item->result_type() != REAL_RESULT ||
+          !(sum->value_item= new (thd->mem_root) Item_float(thd, 0.0,
+                                                            NOT_FIXED_DEC)))
+        return TRUE;
+    }
+    else
+    {
+      if (item->result_type() != INT_RESULT ||
+          !(sum->value_item= new (thd->mem_root) Item_int(thd, (longlong) 0)))
+        return TRUE;
+      sum->value_item->unsigned_flag=
+        sum->column.type == Parallel_column::UINT_VALUE;
+    }
+    return !(sum->null_item= new (thd->mem_root) Item_null(thd));
+  default:
+    return TRUE;
+  }
+}
+
+
+/*
+  Create the description of a parallel scan of a table
+
+  SYNOPSIS
+    Parallel_scan::create()
+      join        the join
+      tab         the only non-const table of the join
+      group_list  the fields the rows are grouped by, NULL if none
+      degree      the number of threads
+
+  DESCRIPTION
+    The function checks the parts of the query that the threads must
+    handle themselves: the engine must allow the parallel read of the
+    table (see handler::can_read_parallel()), the table must have a
+    primary key over a single integer field to split the scan by, the
+    condition of the table, the fields of GROUP BY and the aggregate
+    functions must be supported by Parallel_cond, Parallel_column and
+    Parallel_sum. The caller checks the rest of the query.
+
+  RETURN VALUE
+    the description of the scan
+    NULL      the table cannot be read in parallel
+*/
+
+Parallel_scan *Parallel_scan::create(JOIN *join, JOIN_TAB *tab,
+                                     ORDER *group_list, uint degree)
+{
+  THD *thd= join->thd;
+  TABLE *table= tab->table;
+  Parallel_scan *scan;
+  uint key_nr= table->s->primary_key;
+  DBUG_ENTER("Parallel_scan::create");
+
+  if (key_nr == MAX_KEY ||
+      table->key_info[key_nr].user_defined_key_parts != 1 ||
+      table->s->blob_fields || table->vfield ||
+      table->s->tmp_table != NO_TMP_TABLE ||
+      !table->file->can_read_parallel())
+    DBUG_RETURN(NULL);
+
+  if (!(scan= new (thd->mem_root) Parallel_scan))
+    DBUG_RETURN(NULL);
+  scan->table= table;
+  scan->degree= degree;
+  scan->key_nr= key_nr;
+  if (scan->key_column.init_value(table->key_info[key_nr].key_part->field) ||
+      scan->key_column.type == Parallel_column::FLOAT_VALUE ||
+      scan->key_column.type == Parallel_column::DOUBLE_VALUE)
+    DBUG_RETURN(NULL);
+
+  scan->cond= NULL;
+  if (tab->select_cond &&
+      !(scan->cond= Parallel_cond::create(thd, tab->select_cond, table)))
+    DBUG_RETURN(NULL);
+
+  scan->group_count= 0;
+  scan->max_group_key_length= 0;
+  for (ORDER *group= group_list; group; group= group->next)
+    scan->group_count++;
+  if (!(scan->group_columns= (Parallel_column *)
+        thd->alloc(sizeof(Parallel_column) * (scan->group_count + 1))))
+    DBUG_RETURN(NULL);
+  uint i= 0;
+  for (ORDER *group= group_list; group; group= group->next, i++)
+  {
+    Item *item= (*group->item)->real_item();
+    Parallel_column *column= scan->group_columns + i;
+    if (item->type() != Item::FIELD_ITEM ||
+        ((Item_field *) item)->field->table != table ||
+        column->init_key(((Item_field *) item)->field))
+      DBUG_RETURN(NULL);
+    scan->max_group_key_length+= column->length + 1;
+  }
+
+  scan->sum_count= 0;
+  for (Item_sum **func= join->sum_funcs; *func; func++)
+    scan->sum_count++;
+  if (!(scan->sums= (Parallel_sum *)
+        thd->calloc(sizeof(Parallel_sum) * (scan->sum_count + 1))))
+    DBUG_RETURN(NULL);
+  for (i= 0; i < scan->sum_count; i++)
+  {
+    if (init_parallel_sum(thd, scan->sums + i, join->sum_funcs[i], table))
+      DBUG_RETURN(NULL);
+  }
+  DBUG_PRINT("info", ("parallel scan of %s with %u threads",
+                      table->alias.c_ptr(), degree));
+  DBUG_RETURN(scan);
+}
+
+
+/*
+  Check whether the scan can be done in parallel for this execution
+
+  DESCRIPTION
+    The constants of the condition are evaluated, and it is checked that
+    the query still aggregates with the functions the scan was set up
+    for.
+
+  RETURN VALUE
+    TRUE     run the parallel scan (or report the error that occurred)
+    FALSE    read the table in the usual way
+*/
+
+bool Parallel_scan::can_execute(JOIN *join)
+{
+  for (uint i= 0; i < sum_count; i++)
+  {
+    if (join->sum_funcs[i] != sums[i].item)
+      return FALSE;
+  }
+  if (join->sum_funcs[sum_count])
+    return FALSE;
+  return !(cond && cond->fix_values()) || join->thd->is_error();
+}
+
+
+/*
+  The state of the aggregate functions of a partial group.
+  COUNT_* use count, SUM_INT a 128 bit sum in high and low, SUM_REAL
+  real, MIN_MAX the value in low (see Parallel_column::val_ordered()) or
+  in real. count is the number of values that are not NULL.
+*/
+
+struct Parallel_sum_value
+{
+  longlong count;
+  longlong high;
+  ulonglong low;
+  double real;
+};
+
+
+/* A partial group */
+
+struct Parallel_group
+{
+  uchar *key;
+  uint key_length;
+  /* The first record of the group */
+  uchar *record;
+  Parallel_sum_value *values;
+};
+
+
+static uchar *parallel_group_get_key(const uchar *entry, size_t *length,
+                                     my_bool not_used __attribute__((unused)))
+{
+  const Parallel_group *group= (const Parallel_group *) entry;
+  *length= group->key_length;
+  return group->key;
+}
+
+
+/*
+  The partial groups of a thread. The memory is not thread specific, as
+  the groups are merged and freed by the thread of the query.
+*/
+
+class Parallel_groups
+{
+public:
+  HASH hash;
+  MEM_ROOT mem_root;
+  size_t memory;
+  Parallel_groups *next;
+
+  Parallel_groups() :memory(0), next(NULL)
+  {
+    init_alloc_root(&mem_root, "Parallel_groups", 65536, 0, MYF(0));
+    my_hash_init(&hash, &my_charset_bin, 256, 0, 0, parallel_group_get_key,
+                 0, 0);
+  }
+  ~Parallel_groups()
+  {
+    my_hash_free(&hash);
+    free_root(&mem_root, MYF(0));
+  }
+};
+
+
+class Parallel_scan_run;
+
+/* A thread of the scan */
+
+struct Parallel_worker
+{
+  Parallel_scan_run *run;
+  /* The instance of the table the thread reads, and its record buffer */
+  handler *file;
+  uchar *record;
+  uchar *group_key;
+  pthread_t thread;
+  Parallel_groups *groups;
+  /* Statistics */
+  ha_rows rows_read;
+  ha_rows rows_matched;
+  ulong key_reads;
+  ulong next_reads;
+};
+
+
+/* The state of one execution of a parallel scan */
+
+class Parallel_scan_run
+{
+public:
+  Parallel_scan *scan;
+  THD *thd;
+  mysql_mutex_t lock;
+  mysql_cond_t cond;
+  /* The chunks: the key images and the ordered values of their starts */
+  uchar *chunk_keys;
+  ulonglong *chunk_starts;
+  uint chunks;
+  /* Protected by lock */
+  uint next_chunk;
+  Parallel_groups *full_groups;
+  uint full_count;
+  uint running;
+  int error;
+  bool abort;
+  /* The memory the partial groups of a thread may use */
+  size_t memory_limit;
+
+  void work(Parallel_worker *worker);
+  int scan_chunks(Parallel_worker *worker);
+  bool add_row(Parallel_worker *worker);
+  bool hand_over(Parallel_worker *worker);
+  enum_nested_loop_state merge(JOIN *join, JOIN_TAB *tab,
+                               Parallel_groups *groups);
+};
+
+
+static void add_to_sum(const Parallel_sum *sum, Parallel_sum_value *value,
+                       const uchar *rec)
+{
+  const Parallel_column *column= &sum->column;
+  switch (sum->sum_type) {
+  case Parallel_sum::COUNT_ROWS:
+    value->count++;
+    return;
+  case Parallel_sum::COUNT_VALUES:
+    if (!column->is_null(rec))
+      value->count++;
+    return;
+  case Parallel_sum::SUM_INT:
+  {
+    if (column->is_null(rec))
+      return;
+    longlong nr= column->val_int(rec);
+    ulonglong low= value->low + (ulonglong) nr;
+    value->high+= (low < value->low ? 1 : 0) -
+                  (column->type == Parallel_column::INT_VALUE && nr < 0 ?
+                   1 : 0);
+    value->low= low;
+    value->count++;
+    return;
+  }
+  case Parallel_sum::SUM_REAL:
+    if (column->is_null(rec))
+      return;
+    value->real+= column->val_real(rec);
+    value->count++;
+    return;
+  case Parallel_sum::MIN_MAX:
+    if (column->is_null(rec))
+      return;
+    if (column->type == Parallel_column::FLOAT_VALUE ||
+        column->type == Parallel_column::DOUBLE_VALUE)
+    {
+      double nr= column->val_real(rec);
+      if (!value->count ||
+          (sum->cmp_sign > 0 ? nr > value->real : nr < value->real))
+        value->real= nr;
+    }
+    else
+    {
+      ulonglong nr= column->val_ordered(rec);
+      if (!value->count ||
+          (sum->cmp_sign > 0 ? nr > value->low : nr < value->low))
+        value->low= nr;
+    }
+    value->count++;
+    return;
+  }
+}
+
+
+/*
+  Add a record that matched the condition to the partial groups of a
+  thread
+
+  RETURN VALUE
+    FALSE    OK
+    TRUE     out of memory
+*/
+
+bool Parallel_scan_run::add_row(Parallel_worker *worker)
+{
+  const uchar *rec= worker->record;
+  Parallel_groups *groups= worker->groups;
+  uchar *key_end= worker->group_key;
+  Parallel_group *group;
+
+  for (uint i= 0; i < scan->group_count; i++)
+    key_end= scan->group_columns[i].store_key(key_end, rec);
+  size_t key_length= (size_t) (key_end - worker->group_key);
+
+  if (!(group= (Parallel_group *) my_hash_search(&groups->hash,
+                                                 worker->group_key,
+                                                 key_length)))
+  {
+    size_t rec_length= scan->table->s->reclength;
+    size_t length= ALIGN_SIZE(sizeof(Parallel_group)) +
+                   ALIGN_SIZE(key_length) + ALIGN_SIZE(rec_length) +
+                   sizeof(Parallel_sum_value) * scan->sum_count;
+    uchar *pos;
+    if (!(pos= (uchar *) alloc_root(&groups->mem_root, length)))
+      return TRUE;
+    group= (Parallel_group *) pos;
+    group->key= pos+= ALIGN_SIZE(sizeof(Parallel_group));
+    group->key_length= (uint) key_length;
+    memcpy(group->key, worker->group_key, key_length);
+    group->record= pos+= ALIGN_SIZE(key_length);
+    memcpy(group->record, rec, rec_length);
+    group->values= (Parallel_sum_value *) (pos + ALIGN_SIZE(rec_length));
+    bzero(group->values, sizeof(Parallel_sum_value) * scan->sum_count);
+    if (my_hash_insert(&groups->hash, (uchar *) group))
+      return TRUE;
+    /* The entry and its link in the hash */
+    groups->memory+= length + 2 * sizeof(uchar *);
+  }
+  for (uint i= 0; i < scan->sum_count; i++)
+    add_to_sum(scan->sums + i, group->values + i, rec);
+  return FALSE;
+}
+
+
+/*
+  Pass the partial groups of a thread to the thread of the query
+
+  DESCRIPTION
+    This is done when the groups of the thread have grown over the
+    memory limit and when the thread is done. At most 'degree' sets of
+    groups wait to be merged, further threads wait for the merge.
+
+  RETURN VALUE
+    FALSE    OK
+    TRUE     the scan is aborted or out of memory
+*/
+
+bool Parallel_scan_run::hand_over(Parallel_worker *worker)
+{
+  bool res;
+  mysql_mutex_lock(&lock);
+  while (full_count >= scan->degree && !abort && !error)
+    mysql_cond_wait(&cond, &lock);
+  if (!(res= abort || error))
+  {
+    worker->groups->next= full_groups;
+    full_groups= worker->groups;
+    full_count++;
+    worker->groups= NULL;
+    mysql_cond_broadcast(&cond);
+  }
+  mysql_mutex_unlock(&lock);
+  if (!res && !(worker->groups= new Parallel_groups))
+    return TRUE;
+  return res;
+}
+
+
+/*
+  Read the chunks of the primary key range in a thread
+
+  DESCRIPTION
+    The thread takes the next chunk that is not read yet until all are
+    done. A chunk is read from its first key value with index_read_map()
+    and index_next() until the key of the next chunk is reached.
+
+  RETURN VALUE
+    0        OK
+    #        the error code of the engine or HA_ERR_OUT_OF_MEM
+*/
+
+int Parallel_scan_run::scan_chunks(Parallel_worker *worker)
+{
+  handler *file= worker->file;
+  uchar *record= worker->record;
+  size_t key_length= scan->key_column.length;
+  int res= 0;
+  DBUG_ENTER("Parallel_scan_run::scan_chunks");
+
+  for (;;)
+  {
+    uint chunk;
+    mysql_mutex_lock(&lock);
+    chunk= next_chunk++;
+    if (abort || error)
+      chunk= chunks;
+    mysql_mutex_unlock(&lock);
+    if (chunk >= chunks)
+      break;
+
+    worker->key_reads++;
+    if (chunk == 0)
+      res= file->ha_index_first(record);
+    else
+      res= file->ha_index_read_map(record, chunk_keys + chunk * key_length,
+                                   (key_part_map) 1, HA_READ_KEY_OR_NEXT);
+    while (!res)
+    {
+      if (chunk + 1 < chunks &&
+          scan->key_column.val_ordered(record) >= chunk_starts[chunk + 1])
+        break;
+      worker->rows_read++;
+      if (!scan->cond || scan->cond->check(record))
+      {
+        worker->rows_matched++;
+        if (add_row(worker))
+        {
+          res= HA_ERR_OUT_OF_MEM;
+          break;
+        }
+        if (worker->groups->memory > memory_limit && hand_over(worker))
+        {
+          res= worker->groups ? 0 : HA_ERR_OUT_OF_MEM;
+          break;
+        }
+      }
+      if (!(worker->rows_read % PARALLEL_SCAN_KILL_CHECK_ROWS) &&
+          (thd->killed || abort))
+        break;
+      worker->next_reads++;
+      res= file->ha_index_next(record);
+    }
+    if (res && res != HA_ERR_END_OF_FILE && res != HA_ERR_KEY_NOT_FOUND)
+      break;
+    res= 0;
+    if (thd->killed || abort || !worker->groups)
+      break;
+  }
+
+  if (!res && worker->groups && worker->groups->hash.records)
+    hand_over(worker);
+  DBUG_RETURN(res);
+}
+
+
+/*
+  Read a part of the table in a thread of the scan
+
+  DESCRIPTION
+    The thread reads in a session of its own, through its own instance
+    of the table, so that the engine gives it a transaction of its own:
+    the state of a transaction in the engine must not be used by several
+    threads at the same time. handler::start_parallel_read() makes the
+    transaction of the thread see the same data as the statement.
+*/
+
+void Parallel_scan_run::work(Parallel_worker *worker)
+{
+  TABLE *table= scan->table;
+  TABLE worker_table;
+  THD *worker_thd;
+  int res;
+  DBUG_ENTER("Parallel_scan_run::work");
+
+  worker_thd= new THD(next_thread_id());
+  worker_thd->thread_stack= (char*) &worker_thd;
+  worker_thd->system_thread= SYSTEM_THREAD_GENERIC;
+  worker_thd->store_globals();
+  worker_thd->security_ctx->skip_grants();
+  worker_thd->set_command(COM_DAEMON);
+  worker_thd->tx_isolation= thd->tx_isolation;
+  worker_thd->variables.tx_isolation= thd->variables.tx_isolation;
+
+  if (open_table_from_share(worker_thd, table->s, &table->s->table_name,
+                            HA_OPEN_KEYFILE | HA_TRY_READ_ONLY,
+                            EXTRA_RECORD, HA_OPEN_IGNORE_IF_LOCKED,
+                            &worker_table, FALSE))
+    res= HA_ERR_OUT_OF_MEM;
+  else
+  {
+    handler *file= worker_table.file;
+    bitmap_copy(worker_table.read_set, table->read_set);
+    if (!(res= file->ha_external_lock(worker_thd, F_RDLCK)))
+    {
+      if (!(res= file->start_parallel_read(table->file)) &&
+          !(res= file->ha_index_init(scan->key_nr, 1)))
+      {
+        worker->file= file;
+        worker->record= worker_table.record[0];
+        res= scan_chunks(worker);
+        file->ha_index_end();
+      }
+      trans_commit_stmt(worker_thd);
+      file->ha_external_lock(worker_thd, F_UNLCK);
+    }
+    closefrm(&worker_table);
+  }
+  delete worker_thd;
+
+  mysql_mutex_lock(&lock);
+  if (res && !error)
+    error= res;
+  running--;
+  mysql_cond_broadcast(&cond);
+  mysql_mutex_unlock(&lock);
+  DBUG_VOID_RETURN;
+}
+
+
+pthread_handler_t parallel_scan_thread(void *arg)
+{
+  Parallel_worker *worker= (Parallel_worker *) arg;
+  my_thread_init();
+  worker->run->work(worker);
+  my_thread_end();
+  return 0;
+}
+
+
+/* Convert a 128 bit integer to a decimal */
+
+static void int128_to_decimal(longlong high, ulonglong low, my_decimal *to)
+{
+  if ((high == 0 && low <= (ulonglong) LONGLONG_MAX) ||
+      (high == -1 && low > (ulonglong) LONGLONG_MAX))
+    int2my_decimal(E_DEC_FATAL_ERROR, (longlong) low, FALSE, to);
+  else
+  {
+    my_decimal high_dec, low_dec, shift, tmp;
+    int2my_decimal(E_DEC_FATAL_ERROR, high, FALSE, &high_dec);
+    int2my_decimal(E_DEC_FATAL_ERROR, (longlong) low, TRUE, &low_dec);
+    int2my_decimal(E_DEC_FATAL_ERROR, 1LL << 32, FALSE, &shift);
+    my_decimal_mul(E_DEC_FATAL_ERROR, &tmp, &high_dec, &shift);
+    my_decimal_mul(E_DEC_FATAL_ERROR, &high_dec, &tmp, &shift);
+    my_decimal_add(E_DEC_FATAL_ERROR, to, &high_dec, &low_dec);
+  }
+}
+
+
+/*
+  Pass partial groups to the rest of the query
+
+  DESCRIPTION
+    Every partial group is passed on as a row of the table: the first
+    record of the group is put into record[0] and the aggregate functions
+    get the results of the group with direct_add(), which they use
+    instead of the values of their arguments for the next row.
+*/
+
+enum_nested_loop_state
+Parallel_scan_run::merge(JOIN *join, JOIN_TAB *tab, Parallel_groups *groups)
+{
+  TABLE *table= scan->table;
+  enum_nested_loop_state rc= NESTED_LOOP_OK;
+
+  for (ulong i= 0; i < groups->hash.records && rc == NESTED_LOOP_OK; i++)
+  {
+    Parallel_group *group= (Parallel_group *) my_hash_element(&groups->hash,
+                                                               i);
+    memcpy(table->record[0], group->record, table->s->reclength);
+    for (uint j= 0; j < scan->sum_count; j++)
+    {
+      Parallel_sum *sum= scan->sums + j;
+      Parallel_sum_value *value= group->values + j;
+      switch (sum->sum_type) {
+      case Parallel_sum::COUNT_ROWS:
+      case Parallel_sum::COUNT_VALUES:
+        ((Item_sum_count *) sum->item)->direct_add(value->count);
+        break;
+      case Parallel_sum::SUM_INT:
+      {
+        my_decimal dec;
+        int128_to_decimal(value->high, value->low, &dec);
+        ((Item_sum_sum *) sum->item)->direct_add(value->count ? &dec : NULL);
+        break;
+      }
+      case Parallel_sum::SUM_REAL:
+        ((Item_sum_sum *) sum->item)->direct_add(value->real, !value->count);
+        break;
+      case Parallel_sum::MIN_MAX:
+        if (!value->count)
+        {
+          ((Item_sum_hybrid *) sum->item)->direct_add(sum->null_item);
+          break;
+        }
+        if (sum->column.type == Parallel_column::FLOAT_VALUE ||
+            sum->column.type == Parallel_column::DOUBLE_VALUE)
+          ((Item_float *) sum->value_item)->value= value->real;
+        else
+          ((Item_int *) sum->value_item)->value= (longlong)
+            (sum->column.type == Parallel_column::UINT_VALUE ? value->low :
+             value->low ^ (1ULL << 63));
+        ((Item_sum_hybrid *) sum->item)->direct_add(sum->value_item);
+        break;
+      }
+    }
+    rc= (*tab->next_select)(join, tab + 1, 0);
+    if (rc == NESTED_LOOP_OK && join->thd->is_error())
+      rc= NESTED_LOOP_ERROR;
+  }
+  return rc;
+}
+
+
+/*
+  Read the table in parallel and pass the partial groups on
+
+  SYNOPSIS
+    Parallel_scan::execute()
+      join      the join
+      tab       the table
+
+  DESCRIPTION
+    The function is called by sub_select() instead of the loop over the
+    records of the table. It reads the smallest and the largest primary
+    key values, splits the range into chunks, starts the threads and
+    merges the partial groups the threads hand over until all threads
+    are done.
+
+  RETURN VALUE
+    the state of the nested loop, NESTED_LOOP_NO_MORE_ROWS when all
+    records have been read
+*/
+
+enum_nested_loop_state Parallel_scan::execute(JOIN *join, JOIN_TAB *tab)
+{
+  THD *thd= join->thd;
+  handler *file= table->file;
+  Parallel_scan_run run;
+  Parallel_worker *workers;
+  enum_nested_loop_state rc= NESTED_LOOP_OK;
+  size_t key_length= key_column.length;
+  ulonglong min_value, max_value;
+  uint count, started= 0;
+  int error;
+  DBUG_ENTER("Parallel_scan::execute");
+
+  if (unlikely(thd->is_error()))
+    DBUG_RETURN(NESTED_LOOP_ERROR);
+
+  /* The threads read the primary key to find the ends of their chunks */
+  bitmap_set_bit(table->read_set,
+                 table->key_info[key_nr].key_part->fieldnr - 1);
+
+  /* Find the range of the primary key, this also opens the read view */
+  if ((error= file->ha_index_init(key_nr, 1)))
+  {
+    file->print_error(error, MYF(0));
+    DBUG_RETURN(NESTED_LOOP_ERROR);
+  }
+  if (!(error= file->ha_index_first(table->record[0])))
+  {
+    min_value= key_column.val_ordered(table->record[0]);
+    if (!(error= file->ha_index_last(table->record[0])))
+      max_value= key_column.val_ordered(table->record[0]);
+  }
+  file->ha_index_end();
+  if (error)
+  {
+    if (error == HA_ERR_END_OF_FILE || error == HA_ERR_KEY_NOT_FOUND)
+      DBUG_RETURN(NESTED_LOOP_NO_MORE_ROWS);
+    file->print_error(error, MYF(0));
+    DBUG_RETURN(NESTED_LOOP_ERROR);
+  }
+
+  run.scan= this;
+  run.thd= thd;
+  run.chunks= degree * PARALLEL_SCAN_CHUNKS_PER_THREAD;
+  ulonglong step= (max_value - min_value) / run.chunks;
+  if (!step)
+  {
+    run.chunks= (uint) (max_value - min_value) + 1;
+    step= 1;
+  }
+  run.next_chunk= 0;
+  run.full_groups= NULL;
+  run.full_count= 0;
+  run.error= 0;
+  run.abort= FALSE;
+  run.memory_limit= (size_t) MY_MAX(thd->variables.tmp_memory_table_size /
+                                    degree, PARALLEL_SCAN_MIN_MEMORY);
+  count= MY_MIN(degree, run.chunks);
+  if (!(run.chunk_keys= (uchar *) thd->alloc(run.chunks * key_length)) ||
+      !(run.chunk_starts= (ulonglong *)
+        thd->alloc(run.chunks * sizeof(ulonglong))) ||
+      !(workers= (Parallel_worker *)
+        thd->calloc(count * sizeof(Parallel_worker))))
+    DBUG_RETURN(NESTED_LOOP_ERROR);
+
+  /* The key images of the starts of the chunks */
+  for (uint i= 0; i < run.chunks; i++)
+  {
+    ulonglong start= min_value + step * i;
+    ulonglong nr= key_column.type == Parallel_column::UINT_VALUE ?
+                  start : start ^ (1ULL << 63);
+    uchar *key= run.chunk_keys + i * key_length;
+    run.chunk_starts[i]= start;
+    switch (key_length) {
+    case 1: *key= (uchar) nr; break;
+    case 2: int2store(key, (uint16) nr); break;
+    case 3: int3store(key, (uint32) nr); break;
+    case 4: int4store(key, (uint32) nr); break;
+    default: int8store(key, nr);
+    }
+  }
+
+  mysql_mutex_init(key_LOCK_parallel_scan, &run.lock, MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_COND_parallel_scan, &run.cond, NULL);
+  run.running= count;
+
+  for (; started < count; started++)
+  {
+    Parallel_worker *worker= workers + started;
+    worker->run= &run;
+    if (!(worker->group_key= (uchar *) thd->alloc(max_group_key_length + 1)) ||
+        !(worker->groups= new Parallel_groups))
+      break;
+    /* The threads are joined, so connection_attrib cannot be used */
+    if (mysql_thread_create(key_thread_parallel_scan, &worker->thread, NULL,
+                            parallel_scan_thread, worker))
+      break;
+  }
+
+  /* Merge the partial groups as they are handed over */
+  mysql_mutex_lock(&run.lock);
+  run.running-= count - started;
+  if (started < count)
+    run.abort= TRUE;
+  for (;;)
+  {
+    if (run.full_groups)
+    {
+      Parallel_groups *groups= run.full_groups;
+      run.full_groups= groups->next;
+      run.full_count--;
+      mysql_cond_broadcast(&run.cond);
+      mysql_mutex_unlock(&run.lock);
+      if (rc == NESTED_LOOP_OK && !run.abort)
+        rc= run.merge(join, tab, groups);
+      delete groups;
+      mysql_mutex_lock(&run.lock);
+      if (rc != NESTED_LOOP_OK)
+      {
+        run.abort= TRUE;
+        mysql_cond_broadcast(&run.cond);
+      }
+      continue;
+    }
+    if (!run.running)
+      break;
+    if (thd->killed && !run.abort)
+    {
+      run.abort= TRUE;
+      mysql_cond_broadcast(&run.cond);
+    }
+    /*
+      After a kill, wait for the workers to notice run.abort; each of
+      them broadcasts run.cond when it exits.
+    */
+    PSI_stage_info old_stage;
+    thd->ENTER_COND(&run.cond, &run.lock, &stage_waiting_for_parallel_scan,
+                    &old_stage);
+    mysql_cond_wait(&run.cond, &run.lock);
+    thd->EXIT_COND(&old_stage);
+    mysql_mutex_lock(&run.lock);
+  }
+  mysql_mutex_unlock(&run.lock);
+
+  for (uint i= 0; i < count; i++)
+  {
+    Parallel_worker *worker= workers + i;
+    if (i < started)
+    {
+      pthread_join(worker->thread, NULL);
+      join->join_examined_rows+= worker->rows_read;
+      tab->tracker->r_rows+= worker->rows_read;
+      tab->tracker->r_rows_after_where+= worker->rows_matched;
+      thd->status_var.ha_read_key_count+= worker->key_reads;
+      thd->status_var.ha_read_next_count+= worker->next_reads;
+      file->rows_read+= worker->rows_read;
+      file->index_rows_read[key_nr]+= worker->rows_read;
+    }
+    delete worker->groups;
+  }
+  mysql_mutex_destroy(&run.lock);
+  mysql_cond_destroy(&run.cond);
+
+  if (rc != NESTED_LOOP_OK)
+    DBUG_RETURN(rc);
+  if (started < count)
+  {
+    my_error(ER_OUT_OF_RESOURCES, MYF(0));
+    DBUG_RETURN(NESTED_LOOP_ERROR);
+  }
+  if (run.error)
+  {
+    file->print_error(run.error, MYF(0));
+    DBUG_RETURN(NESTED_LOOP_ERROR);
+  }
+  if (thd->check_killed())
+    DBUG_RETURN(NESTED_LOOP_KILLED);
+  DBUG_RETURN(NESTED_LOOP_NO_MORE_ROWS);
+}
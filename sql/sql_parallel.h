@@ -0,0 +1,147 @@
+/*
+   Copyright (c) 2019, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+#ifndef SQL_PARALLEL_INCLUDED
+#define SQL_PARALLEL_INCLUDED
+
+#include "sql_select.h"
+
+/*
+  Parallel scan of a table for aggregation.
+
+  When max_parallel_degree is greater than 1, a query that scans a single
+  table and aggregates its rows with COUNT, SUM, MIN and MAX may read the
+  table with several threads. The primary key range of the table is split
+  into chunks that the threads take one by one. Every thread reads its
+  chunks in a session of its own, through its own instance of the table,
+  checks the WHERE condition and aggregates the matching rows into
+  partial groups of its own. The engine makes the sessions see the same
+  data as the statement (see handler::start_parallel_read()).
+
+  The partial groups are passed back to the thread of the query, that
+  feeds each of them into the usual GROUP BY machinery as a single row:
+  the row is the first row of the partial group and the partial results
+  of the aggregate functions are given to them with direct_add(). So the
+  groups of the different threads are merged by end_send_group() or by
+  the temporary table of the query exactly as rows are.
+
+  The threads cannot evaluate items, so the WHERE condition and the
+  aggregate functions are compiled into Parallel_cond and Parallel_sum
+  descriptions that read the values straight from the record buffers.
+*/
+
+/* A field of the scanned table read directly from a record buffer */
+
+struct Parallel_column
+{
+  enum Value_type { INT_VALUE, UINT_VALUE, FLOAT_VALUE, DOUBLE_VALUE };
+
+  uint offset;
+  uint null_offset;
+  uchar null_bit;                          /* 0 for a NOT NULL field */
+  uint length;                             /* pack length of the field */
+  uint length_bytes;                       /* of a VARCHAR, 0 otherwise */
+  Value_type type;
+
+  bool init_value(Field *field);
+  bool init_key(Field *field);
+
+  bool is_null(const uchar *rec) const { return rec[null_offset] & null_bit; }
+  longlong val_int(const uchar *rec) const;
+  double val_real(const uchar *rec) const;
+  /* The integer value mapped to ulonglong so that the order is kept */
+  ulonglong val_ordered(const uchar *rec) const
+  {
+    ulonglong nr= (ulonglong) val_int(rec);
+    return type == UINT_VALUE ? nr : nr ^ (1ULL << 63);
+  }
+  uchar *store_key(uchar *to, const uchar *rec) const;
+};
+
+
+/* A condition of the WHERE clause checked over a record buffer */
+
+class Parallel_cond :public Sql_alloc
+{
+public:
+  enum Cond_type { AND_COND, OR_COND, CMP_COND, IS_NULL_COND,
+                   IS_NOT_NULL_COND };
+
+  Cond_type cond_type;
+  /* Arguments of AND and OR */
+  Parallel_cond **args;
+  uint arg_count;
+  /* 'column op value' or 'column IS [NOT] NULL' */
+  Parallel_column column;
+  Item_func::Functype op;
+  Item *value_item;
+  /* The value of value_item, set by fix_values() for every execution */
+  longlong int_value;
+  double real_value;
+  bool null_value;
+
+  static Parallel_cond *create(THD *thd, Item *cond, TABLE *table);
+  bool fix_values();
+  bool check(const uchar *rec) const;
+};
+
+
+/* An aggregate function computed by the threads */
+
+struct Parallel_sum
+{
+  enum Sum_type { COUNT_ROWS, COUNT_VALUES, SUM_INT, SUM_REAL, MIN_MAX };
+
+  Item_sum *item;
+  Sum_type sum_type;
+  Parallel_column column;
+  /* MIN_MAX: -1 for MIN, 1 for MAX */
+  int cmp_sign;
+  /*
+    MIN_MAX: the constant that passes the value of a partial group to the
+    aggregate function, and the one that is passed for a group with only
+    NULL values
+  */
+  Item *value_item;
+  Item *null_item;
+};
+
+
+class Parallel_scan :public Sql_alloc
+{
+public:
+  TABLE *table;
+  /* Number of threads and the primary key whose range is split */
+  uint degree;
+  uint key_nr;
+  Parallel_column key_column;
+  /* The condition of the table, NULL if there is none */
+  Parallel_cond *cond;
+  /* The fields of GROUP BY */
+  Parallel_column *group_columns;
+  uint group_count;
+  uint max_group_key_length;
+  /* The aggregate functions, in the order of join->sum_funcs */
+  Parallel_sum *sums;
+  uint sum_count;
+
+  static Parallel_scan *create(JOIN *join, JOIN_TAB *tab, ORDER *group_list,
+                               uint degree);
+  bool can_execute(JOIN *join);
+  enum_nested_loop_state execute(JOIN *join, JOIN_TAB *tab);
+};
+
+#endif /* SQL_PARALLEL_INCLUDED */
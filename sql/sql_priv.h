@@ -229,6 +229,10 @@
 #define OPTIMIZER_SWITCH_COND_PUSHDOWN_FOR_SUBQUERY (1ULL << 32)
 #define OPTIMIZER_SWITCH_USE_ROWID_FILTER          (1ULL << 33)
 #define OPTIMIZER_SWITCH_COND_PUSHDOWN_FROM_HAVING (1ULL << 34)
+#define OPTIMIZER_SWITCH_JOIN_CACHE_SPILL          (1ULL << 35)
+#define OPTIMIZER_SWITCH_HASH_GROUP_BY             (1ULL << 36)
+#define OPTIMIZER_SWITCH_BATCH_COND_EVAL           (1ULL << 37)
+#define OPTIMIZER_SWITCH_MULTI_ROW_FETCH           (1ULL << 38)
 
 #define OPTIMIZER_SWITCH_DEFAULT   (OPTIMIZER_SWITCH_INDEX_MERGE | \
                                     OPTIMIZER_SWITCH_INDEX_MERGE_UNION | \
@@ -66,6 +66,8 @@
 #include "sp_rcontext.h"
 #include "rowid_filter.h"
 #include "select_handler.h"
+#include "sql_group_hash.h"
+#include "sql_parallel.h"
 #include "my_json_writer.h"
 #include "opt_trace.h"
 
@@ -178,7 +180,12 @@ static COND *optimize_cond(JOIN *join, COND *conds,
 bool const_expression_in_where(COND *conds,Item *item, Item **comp_item);
 static int do_select(JOIN *join, Procedure *procedure);
 
-static enum_nested_loop_state evaluate_join_record(JOIN *, JOIN_TAB *, int);
+static enum_nested_loop_state evaluate_join_record(JOIN *, JOIN_TAB *, int,
+                                                   bool cond_checked= false);
+static bool check_cond_batch(JOIN *join, JOIN_TAB *join_tab);
+static bool choose_parallel_scan(JOIN *join);
+static bool aggregates_in_any_order(JOIN *join, JOIN_TAB *join_tab);
+static enum_nested_loop_state sub_select_batch(JOIN *join, JOIN_TAB *join_tab);
 static enum_nested_loop_state
 evaluate_null_complemented_join_record(JOIN *join, JOIN_TAB *join_tab);
 static enum_nested_loop_state
@@ -189,6 +196,8 @@ static enum_nested_loop_state
 end_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
 static enum_nested_loop_state
 end_unique_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
+static enum_nested_loop_state
+end_hash_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
 
 static int join_read_const_table(THD *thd, JOIN_TAB *tab, POSITION *pos);
 static int join_read_system(JOIN_TAB *tab);
@@ -2925,6 +2934,9 @@ int JOIN::optimize_stage2()
   if (init_range_rowid_filters())
     DBUG_RETURN(1);
 
+  if (choose_parallel_scan(this))
+    DBUG_RETURN(1);
+
   error= 0;
 
   if (select_options & SELECT_DESCRIBE)
@@ -13077,6 +13089,10 @@ void JOIN_TAB::cleanup()
     cache= 0;
   }
   limit= 0;
+  cond_batch= NULL;
+  cond_batch_checked= FALSE;
+  read_batch_buff= NULL;
+  parallel_scan= NULL;
   // Free select that was created for filesort outside of create_sort_index
   if (filesort && filesort->select && !filesort->own_select)
     delete filesort->select;
@@ -13510,6 +13526,8 @@ void JOIN::cleanup(bool full)
         {
           if (curr_tab->aggr)
           {
+            delete curr_tab->aggr->group_hash;
+            curr_tab->aggr->group_hash= NULL;
             free_tmp_table(thd, curr_tab->table);
             delete curr_tab->tmp_table_param;
             curr_tab->tmp_table_param= NULL;
@@ -19391,7 +19409,17 @@ void set_postjoin_aggr_write_func(JOIN_TAB *tab)
       Note for MyISAM tmp tables: if uniques is true keys won't be
       created.
     */
-    if (table->s->keys && !table->s->uniques)
+    if (table->s->keys && !table->s->uniques &&
+        optimizer_flag(join->thd, OPTIMIZER_SWITCH_HASH_GROUP_BY) &&
+        !table->s->blob_fields &&
+        (aggr->group_hash ||
+         (aggr->group_hash= new (join->thd->mem_root)
+                              Group_hash_table(table, tmp_tbl->group_length))))
+    {
+      DBUG_PRINT("info",("Using end_hash_update"));
+      aggr->set_write_func(end_hash_update);
+    }
+    else if (table->s->keys && !table->s->uniques)
     {
       DBUG_PRINT("info",("Using end_update"));
       aggr->set_write_func(end_update);
@@ -20029,12 +20057,28 @@ sub_select(JOIN *join,JOIN_TAB *join_tab,bool end_of_records)
   if (join_tab->loosescan_match_tab)
     join_tab->loosescan_match_tab->found_match= FALSE;
 
+  if (!join_tab->cond_batch_checked)
+  {
+    join_tab->cond_batch_checked= TRUE;
+    if (check_cond_batch(join, join_tab) &&
+        !(join_tab->cond_batch= Row_batch::create(join->thd, join_tab->table)))
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+  }
+
   if (rc != NESTED_LOOP_NO_MORE_ROWS)
   {
-    error= (*join_tab->read_first_record)(join_tab);
-    if (!error && join_tab->keep_current_rowid)
-      join_tab->table->file->position(join_tab->table->record[0]);    
-    rc= evaluate_join_record(join, join_tab, error);
+    if (join_tab->parallel_scan && aggregates_in_any_order(join, join_tab) &&
+        join_tab->parallel_scan->can_execute(join))
+      rc= join_tab->parallel_scan->execute(join, join_tab);
+    else if (join_tab->cond_batch)
+      rc= sub_select_batch(join, join_tab);
+    else
+    {
+      error= (*join_tab->read_first_record)(join_tab);
+      if (!error && join_tab->keep_current_rowid)
+        join_tab->table->file->position(join_tab->table->record[0]);    
+      rc= evaluate_join_record(join, join_tab, error);
+    }
   }
 
   /* 
@@ -20085,6 +20129,265 @@ sub_select(JOIN *join,JOIN_TAB *join_tab,bool end_of_records)
   DBUG_RETURN(rc);
 }
 
+/*
+  Allocate a batch for the filtering of the records of a table
+
+  SYNOPSIS
+    Row_batch::create()
+      thd       thread handle
+      table     the table whose records are put into the batch
+
+  DESCRIPTION
+    The batch gets as many records as fit into ROW_BATCH_MAX_BYTES, but
+    at most ROW_BATCH_MAX_RECORDS. The memory is allocated on the
+    statement memory root.
+
+  RETURN VALUE
+    the batch
+    NULL      out of memory
+*/
+
+Row_batch *Row_batch::create(THD *thd, TABLE *table)
+{
+  Row_batch *batch;
+  size_t rec_length= table->s->reclength;
+  uint size= (uint) MY_MIN(ROW_BATCH_MAX_RECORDS,
+                           MY_MAX(ROW_BATCH_MAX_BYTES / rec_length, 1));
+  if (!(batch= new (thd->mem_root) Row_batch) ||
+      !(batch->buff= (uchar *) thd->alloc(size * rec_length)) ||
+      !(batch->sel= (uint *) thd->alloc(size * sizeof(uint))) ||
+      !(batch->scratch= (uint *) thd->alloc(size * sizeof(uint) *
+                                            ROW_BATCH_SCRATCH_VECTORS)))
+    return NULL;
+  batch->table= table;
+  batch->rec_length= rec_length;
+  batch->size= size;
+  batch->records= batch->selected= batch->scratch_used= 0;
+  return batch;
+}
+
+
+/*
+  Check whether the records of a table can be filtered batch by batch
+
+  SYNOPSIS
+    check_cond_batch()
+      join      the join
+      join_tab  the table
+
+  DESCRIPTION
+    The records of the table are read in batches and filtered with
+    Item::filter_batch() when the optimizer switch batch_cond_eval is on,
+    the table is the first non-const table of a read-only SELECT that is
+    read without locking its rows and without any join buffer, outer or
+    semi-join machinery, the condition attached to the table depends on
+    no other table and has no side effects, and a part of it can be
+    checked without the row by row evaluation. As the records are copied
+    to and from the batch, tables with BLOB fields are excluded, their
+    values are not stored in the record buffer.
+
+  RETURN VALUE
+    TRUE     use a batch for the table
+    FALSE    read the table row by row
+*/
+
+static bool check_cond_batch(JOIN *join, JOIN_TAB *join_tab)
+{
+  TABLE *table= join_tab->table;
+  Item *cond= join_tab->select_cond;
+  Item_func::Functype set_user_var= Item_func::SUSERVAR_FUNC;
+
+  if (!optimizer_flag(join->thd, OPTIMIZER_SWITCH_BATCH_COND_EVAL) ||
+      join_tab != join->join_tab + join->const_tables ||
+      join->thd->lex->sql_command != SQLCOM_SELECT ||
+      (table->reginfo.lock_type != TL_READ &&
+       table->reginfo.lock_type != TL_READ_HIGH_PRIORITY) ||
+      join_tab->last_inner || join_tab->first_inner ||
+      join_tab->loosescan_match_tab || join_tab->keep_current_rowid ||
+      join_tab->bush_children || join_tab->bush_root_tab ||
+      join_tab->type == JT_FT || table->s->blob_fields || !cond)
+    return FALSE;
+  if ((cond->used_tables() & ~(table->map | OUTER_REF_TABLE_BIT)) ||
+      cond->with_subquery() || cond->is_expensive() ||
+      cond->walk(&Item::find_function_processor, FALSE, &set_user_var))
+    return FALSE;
+  return cond->has_batch_filter(table);
+}
+
+
+/*
+  Check whether the rows of a table are aggregated in any order
+
+  SYNOPSIS
+    aggregates_in_any_order()
+      join      the join
+      join_tab  the last table of the join
+
+  DESCRIPTION
+    The rows are aggregated in any order when there is no GROUP BY and
+    they go to end_send_group(), or when they go to a temporary table
+    whose groups are updated through its unique key or its hash table.
+
+  RETURN VALUE
+    TRUE     the order of the rows does not matter
+    FALSE    the rows have to come in the order of the groups
+*/
+
+static bool aggregates_in_any_order(JOIN *join, JOIN_TAB *join_tab)
+{
+  if (join_tab->next_select == end_send_group)
+    return !join->group_list;
+  if (join_tab->next_select == sub_select_postjoin_aggr)
+  {
+    Next_select_func write_func= join_tab[1].aggr->get_write_func();
+    return write_func == end_update || write_func == end_unique_update ||
+           write_func == end_hash_update;
+  }
+  return FALSE;
+}
+
+
+/*
+  Choose the parallel scan for the table of a query
+
+  SYNOPSIS
+    choose_parallel_scan()
+      join      the join
+
+  DESCRIPTION
+    The table of a single table SELECT is read by max_parallel_degree
+    threads when the query aggregates its rows in any order (see
+    aggregates_in_any_order()) and the table would be read with a full
+    table or index scan. The query must be a plain read of the top level
+    SELECT without ROLLUP, window functions or a procedure. The rest of
+    the checks are done by Parallel_scan::create().
+
+  RETURN VALUE
+    FALSE    OK, join_tab->parallel_scan is set if the scan is used
+    TRUE     out of memory
+*/
+
+static bool choose_parallel_scan(JOIN *join)
+{
+  THD *thd= join->thd;
+  uint degree= (uint) thd->variables.max_parallel_degree;
+  JOIN_TAB *tab;
+
+  if (degree <= 1 || !join->join_tab ||
+      thd->lex->sql_command != SQLCOM_SELECT || thd->in_sub_stmt ||
+      join->select_lex != thd->lex->first_select_lex() ||
+      join->table_count != join->const_tables + 1 ||
+      join->top_join_tab_count != join->table_count ||
+      join->rollup.state != ROLLUP::STATE_NONE || join->procedure ||
+      join->select_lex->have_window_funcs() ||
+      !join->sum_funcs || !*join->sum_funcs)
+    return FALSE;
+
+  tab= join->join_tab + join->const_tables;
+  if ((tab->type != JT_ALL && tab->type != JT_NEXT) ||
+      tab->quick || (tab->select && tab->select->quick) ||
+      tab->use_quick == 2 || tab->filesort || tab->keep_current_rowid ||
+      tab->bush_children || tab->first_inner || tab->last_inner ||
+      (tab->table->reginfo.lock_type != TL_READ &&
+       tab->table->reginfo.lock_type != TL_READ_HIGH_PRIORITY) ||
+      tab->table->s->tmp_table != NO_TMP_TABLE ||
+      !aggregates_in_any_order(join, tab))
+    return FALSE;
+
+  /* The rows are grouped by join->group_list or by the temporary table */
+  ORDER *group_list= tab->next_select == sub_select_postjoin_aggr ?
+                     tab[1].table->group : join->group_list;
+  if (!(tab->parallel_scan= Parallel_scan::create(join, tab, group_list,
+                                                  degree)))
+    return thd->is_fatal_error;
+  return FALSE;
+}
+
+
+/*
+  Read the records of a table batch by batch and join the qualifying ones
+
+  SYNOPSIS
+    sub_select_batch()
+      join      the join
+      join_tab  the table, join_tab->cond_batch is set
+
+  DESCRIPTION
+    This is the loop of sub_select() over the records of join_tab for
+    the case when the condition attached to the table is checked for
+    batches of records (see check_cond_batch()). The records are copied
+    into the batch as they are read, then join_tab->select_cond filters
+    the whole batch at once and the qualifying records are put back into
+    record[0] one by one and passed to evaluate_join_record(), that does
+    not evaluate the condition again. The records are read without
+    locking, so the rejected ones need no read_record.unlock_row().
+
+  RETURN VALUE
+    the state of the nested loop, as for evaluate_join_record(), with
+    NESTED_LOOP_NO_MORE_ROWS when all records have been read
+*/
+
+static enum_nested_loop_state
+sub_select_batch(JOIN *join, JOIN_TAB *join_tab)
+{
+  Row_batch *batch= join_tab->cond_batch;
+  TABLE *table= join_tab->table;
+  READ_RECORD *info= &join_tab->read_record;
+  THD *thd= join->thd;
+  enum_nested_loop_state rc;
+  int error= (*join_tab->read_first_record)(join_tab);
+  DBUG_ENTER("sub_select_batch");
+
+  for (;;)
+  {
+    for (batch->records= 0; !error; )
+    {
+      memcpy(batch->record(batch->records), table->record[0],
+             batch->rec_length);
+      if (++batch->records == batch->size)
+        break;
+      error= info->read_record();
+    }
+    if (error > 0 || unlikely(thd->is_error()))
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+    if (unlikely(thd->check_killed()))
+      DBUG_RETURN(NESTED_LOOP_KILLED);
+
+    batch->select_all();
+    join_tab->select_cond->filter_batch(batch);
+    if (unlikely(thd->is_error()))
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+    DBUG_PRINT("info", ("batch records: %u  selected: %u",
+                        batch->records, batch->selected));
+
+    /* Account for the rejected records as evaluate_join_record() does */
+    uint rejected= batch->records - batch->selected;
+    join_tab->tracker->r_rows+= rejected;
+    join->join_examined_rows+= rejected;
+
+    for (uint i= 0, rec= 0; rec < batch->records; rec++)
+    {
+      if (i == batch->selected || batch->sel[i] != rec)
+      {
+        thd->get_stmt_da()->inc_current_row_for_warning();
+        continue;
+      }
+      i++;
+      memcpy(table->record[0], batch->record(rec), batch->rec_length);
+      rc= evaluate_join_record(join, join_tab, 0, true);
+      if (rc != NESTED_LOOP_OK)
+        DBUG_RETURN(rc);
+      if (join->return_tab < join_tab)
+        DBUG_RETURN(NESTED_LOOP_OK);
+    }
+
+    if (error)
+      DBUG_RETURN(NESTED_LOOP_NO_MORE_ROWS);
+    error= info->read_record();
+  }
+}
+
+
 /**
   @brief Process one row of the nested loop join.
 
@@ -20097,12 +20400,14 @@ sub_select(JOIN *join,JOIN_TAB *join_tab,bool end_of_records)
   @param  error > 0: Error, terminate processing
                 = 0: (Partial) row is available
                 < 0: No more rows available at this level
+  @param  cond_checked  join_tab->select_cond is known to be true for
+                        the row (see sub_select_batch())
   @return Nested loop state (Ok, No_more_rows, Error, Killed)
 */
 
 static enum_nested_loop_state
 evaluate_join_record(JOIN *join, JOIN_TAB *join_tab,
-                     int error)
+                     int error, bool cond_checked)
 {
   bool shortcut_for_distinct= join_tab->shortcut_for_distinct;
   ha_rows found_records=join->found_records;
@@ -20127,7 +20432,7 @@ evaluate_join_record(JOIN *join, JOIN_TAB *join_tab,
 
   join_tab->tracker->r_rows++;
 
-  if (select_cond)
+  if (select_cond && !cond_checked)
   {
     select_cond_result= MY_TEST(select_cond->val_int());
 
@@ -20975,9 +21280,59 @@ int join_init_read_record(JOIN_TAB *tab)
   if (init_read_record(&tab->read_record, tab->join->thd, tab->table,
                        tab->select, tab->filesort_result, 1,1, FALSE))
     return 1;
+  if (tab->use_read_batch())
+  {
+    if (!tab->read_batch_buff)
+    {
+      TABLE *table= tab->table;
+      tab->read_batch_records=
+        (uint) MY_MIN(READ_BATCH_MAX_RECORDS,
+                      READ_BATCH_MAX_BYTES / table->s->reclength);
+      if (!(tab->read_batch_buff= (uchar *)
+            tab->join->thd->alloc(tab->read_batch_records *
+                                  table->s->reclength)))
+        return 1;
+    }
+    init_read_record_batch(&tab->read_record, tab->read_batch_buff,
+                           tab->read_batch_records);
+  }
   return tab->read_record.read_record();
 }
 
+
+/*
+  Check whether a table scan may read the records in batches
+
+  SYNOPSIS
+    JOIN_TAB::use_read_batch()
+
+  DESCRIPTION
+    With the optimizer switch multi_row_fetch the records of a table scan
+    are read from the engine several at a time (see
+    handler::ha_rnd_next_batch()). This is only done for the tables of a
+    SELECT that are read without locking and whose current record is
+    never referred to by its position, as the handler is positioned after
+    the last record read ahead. Locking reads would lock the records read
+    ahead, and handler::unlock_row() would release the last of them
+    instead of the record rejected by the condition. Tables with BLOB
+    fields are read row by row anyway.
+
+  RETURN VALUE
+    TRUE     read the records in batches
+    FALSE    read the table row by row
+*/
+
+bool JOIN_TAB::use_read_batch()
+{
+  return (optimizer_flag(join->thd, OPTIMIZER_SWITCH_MULTI_ROW_FETCH) &&
+          join->thd->lex->sql_command == SQLCOM_SELECT &&
+          (table->reginfo.lock_type == TL_READ ||
+           table->reginfo.lock_type == TL_READ_HIGH_PRIORITY) &&
+          !keep_current_rowid && !table->s->blob_fields &&
+          !(tab_list && tab_list->is_with_table_recursive_reference()) &&
+          table->s->reclength * 2 <= READ_BATCH_MAX_BYTES);
+}
+
 int
 join_read_record_no_init(JOIN_TAB *tab)
 {
@@ -21507,22 +21862,11 @@ end_write(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
     Also applies HAVING, etc.
 */
 
-static enum_nested_loop_state
-end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
-	   bool end_of_records)
-{
-  TABLE *const table= join_tab->table;
-  ORDER   *group;
-  int	  error;
-  DBUG_ENTER("end_update");
-
-  if (end_of_records)
-    DBUG_RETURN(NESTED_LOOP_OK);
+/** Make a key of group index in tmp_table_param->group_buff */
 
-  join->found_records++;
-  copy_fields(join_tab->tmp_table_param);	// Groups are copied twice.
-  /* Make a key of group index */
-  for (group=table->group ; group ; group=group->next)
+static void make_group_key(TABLE *table)
+{
+  for (ORDER *group=table->group ; group ; group=group->next)
   {
     Item *item= *group->item;
     if (group->fast_field_copier_setup != group->field)
@@ -21539,6 +21883,23 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
     if (item->maybe_null)
       group->buff[-1]= (char) group->field->is_null();
   }
+}
+
+
+static enum_nested_loop_state
+end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
+	   bool end_of_records)
+{
+  TABLE *const table= join_tab->table;
+  int	  error;
+  DBUG_ENTER("end_update");
+
+  if (end_of_records)
+    DBUG_RETURN(NESTED_LOOP_OK);
+
+  join->found_records++;
+  copy_fields(join_tab->tmp_table_param);	// Groups are copied twice.
+  make_group_key(table);
   if (!table->file->ha_index_read_map(table->record[1],
                                       join_tab->tmp_table_param->group_buff,
                                       HA_WHOLE_KEY,
@@ -21634,6 +21995,120 @@ end_unique_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
 }
 
 
+/**
+  @brief
+    Write the groups accumulated in the GROUP BY hash table into the
+    temporary table and empty the hash table.
+
+  @param join_tab  JOIN_TAB of the temporary table
+
+  @return
+    false  ok
+    true   error
+*/
+
+static bool flush_group_hash(JOIN_TAB *join_tab)
+{
+  TABLE *table= join_tab->table;
+  Group_hash_table *group_hash= join_tab->aggr->group_hash;
+  int error;
+  DBUG_ENTER("flush_group_hash");
+  DBUG_PRINT("info", ("groups: %lu", (ulong) group_hash->elements()));
+
+  for (void *group= group_hash->first_group(); group;
+       group= group_hash->next_group(group))
+  {
+    memcpy(table->record[0], group_hash->group_record(group),
+           table->s->reclength);
+    if (unlikely((error= table->file->ha_write_tmp_row(table->record[0]))))
+    {
+      if (create_internal_tmp_table_from_heap(join_tab->join->thd, table,
+                                       join_tab->tmp_table_param->start_recinfo,
+                                              &join_tab->tmp_table_param->recinfo,
+                                              error, 0, NULL))
+        DBUG_RETURN(true);                     // Not a table_is_full error
+    }
+  }
+  group_hash->reset();
+  DBUG_RETURN(false);
+}
+
+
+/**
+  @brief
+    Perform a GROUP BY operation over rows coming in arbitrary order,
+    keeping the groups in an in-memory hash table.
+
+  @detail
+    Works like end_update(), but the records of the temporary table are
+    looked up and updated in join_tab->aggr->group_hash, so that no
+    handler calls are needed per row. The groups are written into the
+    temporary table when all rows have been read. If the hash table grows
+    over the memory limit of in-memory temporary tables, its groups are
+    written into the temporary table and the remaining rows are
+    aggregated with end_update() or end_unique_update().
+*/
+
+static enum_nested_loop_state
+end_hash_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records)
+{
+  TABLE *const table= join_tab->table;
+  Group_hash_table *group_hash= join_tab->aggr->group_hash;
+  uchar *rec;
+  bool found;
+  DBUG_ENTER("end_hash_update");
+
+  if (end_of_records)
+  {
+    if (flush_group_hash(join_tab))
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+    DBUG_RETURN(NESTED_LOOP_OK);
+  }
+
+  join->found_records++;
+  copy_fields(join_tab->tmp_table_param);	// Groups are copied twice.
+  make_group_key(table);
+  if (unlikely(!(rec= group_hash->find_or_add(join_tab->tmp_table_param->
+                                              group_buff, &found))))
+    DBUG_RETURN(NESTED_LOOP_ERROR);
+  if (found)
+  {						/* Update old record */
+    memcpy(table->record[0], rec, table->s->reclength);
+    update_tmptable_sum_func(join->sum_funcs, table);
+  }
+  else
+  {
+    init_tmptable_sum_functions(join->sum_funcs);
+    if (unlikely(copy_funcs(join_tab->tmp_table_param->items_to_copy,
+                            join->thd)))
+      DBUG_RETURN(NESTED_LOOP_ERROR);           /* purecov: inspected */
+    join_tab->send_records++;
+  }
+  memcpy(rec, table->record[0], table->s->reclength);
+
+  if (group_hash->is_full())
+  {
+    int error;
+    if (flush_group_hash(join_tab))
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+    /* Change method to update rows in the temporary table */
+    if (!table->file->inited &&
+        unlikely((error= table->file->ha_index_init(0, 0))))
+    {
+      table->file->print_error(error, MYF(0));
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+    }
+    join_tab->aggr->set_write_func(table->s->uniques ? end_unique_update :
+                                                       end_update);
+  }
+  if (unlikely(join->thd->check_killed()))
+  {
+    DBUG_RETURN(NESTED_LOOP_KILLED);             /* purecov: inspected */
+  }
+  DBUG_RETURN(NESTED_LOOP_OK);
+}
+
+
 /*
   @brief
     Perform a GROUP BY operation over a stream of rows ordered by their group.
@@ -25750,6 +26225,7 @@ bool JOIN_TAB::save_explain_data(Explain_table_access *eta,
   // psergey-todo: data for filtering!
   tracker= &eta->tracker;
   jbuf_tracker= &eta->jbuf_tracker;
+  jbuf_spill_tracker= &eta->jbuf_spill_tracker;
 
   /* Enable the table access time tracker only for "ANALYZE stmt" */
   if (thd->lex->analyze_stmt)
@@ -26162,6 +26638,12 @@ bool JOIN_TAB::save_explain_data(Explain_table_access *eta,
       if (cache->save_explain_data(&eta->bka_type))
         return 1;
     }
+
+    if (parallel_scan)
+    {
+      eta->push_extra(ET_PARALLEL_SCAN);
+      eta->parallel_workers= parallel_scan->degree;
+    }
   }
 
   /* 
@@ -28138,6 +28620,14 @@ AGGR_OP::prepare_tmp_table()
     (void) table->file->extra(HA_EXTRA_WRITE_CACHE);
     empty_record(table);
   }
+  if (group_hash)
+  {
+    THD *thd= join->thd;
+    if (group_hash->init(MY_MIN(thd->variables.tmp_memory_table_size,
+                                thd->variables.max_heap_table_size)))
+      return true;
+    group_hash->reset();
+  }
   /* If it wasn't already, start index scan for grouping using table index. */
   if (!table->file->inited && table->group &&
       join_tab->tmp_table_param->sum_func_count && table->s->keys)
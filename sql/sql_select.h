@@ -240,10 +240,78 @@ class JOIN_CACHE;
 class SJ_TMP_TABLE;
 class JOIN_TAB_RANGE;
 class AGGR_OP;
+class Group_hash_table;
+class Parallel_scan;
 class Filesort;
 struct SplM_plan_info;
 class SplM_opt_info;
 
+/* Limits for the number and the total size of the records of a Row_batch */
+#define ROW_BATCH_MAX_RECORDS 256
+#define ROW_BATCH_MAX_BYTES (128*1024)
+/* Number of vectors that Item::filter_batch() may borrow from a batch */
+#define ROW_BATCH_SCRATCH_VECTORS 12
+
+/* Limits for the records read at once by a table scan (multi_row_fetch) */
+#define READ_BATCH_MAX_RECORDS 64
+#define READ_BATCH_MAX_BYTES (32*1024)
+
+/*
+  A batch of records of a table for filtering with Item::filter_batch().
+
+  With the optimizer switch batch_cond_eval the records of the first
+  non-const table of a join are read batch by batch into 'buff' before
+  the condition attached to the table is checked (see sub_select_batch()).
+  The condition narrows down the selection vector 'sel', that holds the
+  numbers of the records that still qualify, in one pass over the batch
+  per predicate instead of one evaluation of the whole condition per row.
+*/
+
+class Row_batch :public Sql_alloc
+{
+  uint *scratch;
+  uint scratch_used;
+
+public:
+  TABLE *table;
+  uchar *buff;
+  /* Length of one record, equal to table->s->reclength */
+  size_t rec_length;
+  /* The maximum number of records and the number of records in the batch */
+  uint size;
+  uint records;
+  /* The selection vector: numbers of the records that passed so far */
+  uint *sel;
+  uint selected;
+
+  static Row_batch *create(THD *thd, TABLE *table);
+
+  uchar *record(uint i) { return buff + i * rec_length; }
+  void select_all()
+  {
+    for (uint i= 0; i < records; i++)
+      sel[i]= i;
+    selected= records;
+    scratch_used= 0;
+  }
+  /*
+    Get a vector of 'size' elements for temporary use, NULL if all are
+    taken already. free_vectors(vec) returns vec and all vectors got
+    after it.
+  */
+  uint *alloc_vector()
+  {
+    if (scratch_used == ROW_BATCH_SCRATCH_VECTORS)
+      return NULL;
+    return scratch + size * scratch_used++;
+  }
+  void free_vectors(uint *vec)
+  {
+    DBUG_ASSERT(vec >= scratch && vec < scratch + size * scratch_used);
+    scratch_used= (uint) ((vec - scratch) / size);
+  }
+};
+
 typedef struct st_join_table {
   TABLE		*table;
   TABLE_LIST    *tab_list;
@@ -303,6 +371,8 @@ typedef struct st_join_table {
   Table_access_tracker *tracker;
 
   Table_access_tracker *jbuf_tracker;
+  /* Statistics of spilling the join buffer, see JOIN_CACHE_BNLH */
+  Join_spill_tracker *jbuf_spill_tracker;
   /* 
     Bitmap of TAB_INFO_* bits that encodes special line for EXPLAIN 'Extra'
     column, or 0 if there is no info.
@@ -514,6 +584,27 @@ typedef struct st_join_table {
 
   bool preread_init_done;
 
+  /*
+    Batch for the filtering of the records of the table with select_cond,
+    set up by sub_select() on the first execution when batch_cond_eval
+    applies to the table.
+  */
+  Row_batch *cond_batch;
+  bool cond_batch_checked;
+
+  /*
+    Buffer for the records read ahead by a table scan of the table with
+    multi_row_fetch (see init_read_record_batch())
+  */
+  uchar *read_batch_buff;
+  uint read_batch_records;
+
+  /*
+    Parallel scan of the table for the aggregation of the query, set up
+    by choose_parallel_scan() when max_parallel_degree allows it
+  */
+  Parallel_scan *parallel_scan;
+
   /*
     Cost info to the range filter used when joining this join table
     (Defined when the best join order has been already chosen)
@@ -670,6 +761,7 @@ typedef struct st_join_table {
 
   bool use_order() const; ///< Use ordering provided by chosen index?
   bool sort_table();
+  bool use_read_batch();
   bool remove_duplicates();
   void add_keyuses_for_splitting();
   SplM_plan_info *choose_best_splitting(double record_count,
@@ -1038,8 +1130,10 @@ class AGGR_OP :public Sql_alloc
 {
 public:
   JOIN_TAB *join_tab;
+  /* Hash table of the groups, used by end_hash_update() */
+  Group_hash_table *group_hash;
 
-  AGGR_OP(JOIN_TAB *tab) : join_tab(tab), write_func(NULL)
+  AGGR_OP(JOIN_TAB *tab) : join_tab(tab), group_hash(NULL), write_func(NULL)
   {};
 
   enum_nested_loop_state put_record() { return put_record(false); };
@@ -1055,6 +1149,7 @@ class AGGR_OP :public Sql_alloc
   {
     write_func= new_write_func;
   }
+  Next_select_func get_write_func() const { return write_func; }
 
 private:
   /** Write function that would be used for saving records in tmp table. */
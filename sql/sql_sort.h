@@ -25,17 +25,25 @@ typedef struct st_buffpek BUFFPEK;
 struct SORT_FIELD;
 class Field;
 struct TABLE;
+class THD;
 
 /* Defines used by filesort and uniques */
 
 #define MERGEBUFF		7
 #define MERGEBUFF2		15
+/* The least memory merge_many_buff() gives a run that it merges */
+#define MERGE_MIN_RUN_BUFFER	DISK_BUFFER_SIZE
+
+/* Bytes of the lengths stored before packed sort keys and addon fields */
+#define SORT_KEY_LENGTH_BYTES	4
+#define SORT_ADDON_LENGTH_BYTES	2
 
 /*
    The structure SORT_ADDON_FIELD describes a fixed layout
    for field values appended to sorted values in records to be sorted
    in the sort buffer.
-   Only fixed layout is supported now.
+   The values may also be packed one after the other, see
+   Sort_param::using_packed_addons.
    Null bit maps for the appended values is placed before the values 
    themselves. Offsets are from the last sorted field, that is from the
    record referefence, which is still last component of sorted records.
@@ -64,6 +72,16 @@ struct BUFFPEK_COMPARE_CONTEXT
 };
 
 
+/*
+  Records of packed sort keys or packed addon fields have different
+  lengths. A packed sort key starts with its length in
+  SORT_KEY_LENGTH_BYTES bytes, packed addon fields start with their
+  length in SORT_ADDON_LENGTH_BYTES bytes, the lengths including
+  themselves. rec_length, sort_length and res_length are then the
+  maximum lengths, and the record reference follows a packed sort key
+  rather than being a part of it.
+*/
+
 class Sort_param {
 public:
   uint rec_length;            // Length of sorted records.
@@ -74,15 +92,19 @@ class Sort_param {
   uint min_dupl_count;
   ha_rows max_rows;           // Select limit, or HA_POS_ERROR if unlimited.
   ha_rows examined_rows;      // Number of examined rows.
+  ha_rows written_rows;       // Number of rows written to the runs.
   TABLE *sort_form;           // For quicker make_sortkey.
   SORT_FIELD *local_sortorder;
   SORT_FIELD *end;
   SORT_ADDON_FIELD *addon_field; // Descriptors for companion fields.
   LEX_STRING addon_buf;          // Buffer & length of added packed fields.
+  bool using_packed_sortkeys;    // Sort keys are stored with their lengths.
+  bool using_packed_addons;      // Addon fields are stored with their lengths.
 
   uchar *unique_buff;
   bool not_killable;
   char* tmp_buffer;
+  size_t compare_length;      // Argument of the memcmp() key comparison.
   // The fields below are used only by Unique class.
   qsort2_cmp compare;
   BUFFPEK_COMPARE_CONTEXT cmp_context;
@@ -93,6 +115,24 @@ class Sort_param {
   }
   void init_for_filesort(uint sortlen, TABLE *table,
                          ha_rows maxrows, bool sort_positions);
+  void try_to_pack_records(THD *thd);
+
+  bool using_packed_records() const
+  { return using_packed_sortkeys || using_packed_addons; }
+  /* The offset of the result (the addon fields or the reference) */
+  uint get_result_offset(const uchar *rec) const
+  { return using_packed_sortkeys ? uint4korr(rec) : rec_length - res_length; }
+  uint get_result_length(const uchar *res) const
+  { return using_packed_addons ? uint2korr(res) : res_length; }
+  uint get_record_length(const uchar *rec) const
+  {
+    if (!using_packed_records())
+      return rec_length;
+    uint offset= get_result_offset(rec);
+    return offset + get_result_length(rec + offset);
+  }
+  int compare_packed_keys(const uchar *a, const uchar *b) const;
+  qsort2_cmp get_compare_function(void **arg);
 };
 
 
@@ -1222,6 +1222,15 @@ static Sys_var_ulong Sys_interactive_timeout(
        CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(1, LONG_TIMEOUT), DEFAULT(NET_WAIT_TIMEOUT), BLOCK_SIZE(1));
 
+static Sys_var_uint Sys_io_cache_async_threads(
+       "io_cache_async_threads",
+       "The maximum number of threads that read ahead and write behind "
+       "the temporary files of sorts and other operations. "
+       "0 means that the files are read and written by the threads "
+       "that use them",
+       READ_ONLY GLOBAL_VAR(my_io_cache_async_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 64), DEFAULT(4), BLOCK_SIZE(1));
+
 static Sys_var_ulonglong Sys_join_buffer_size(
        "join_buffer_size",
        "The size of the buffer that is used for joins",
@@ -2332,6 +2341,13 @@ static Sys_var_ulong Sys_max_long_data_size(
        ON_CHECK(0), ON_UPDATE(0),
        DEPRECATED("'@@max_allowed_packet'"));
 
+static Sys_var_ulong Sys_max_parallel_degree(
+       "max_parallel_degree",
+       "Maximum number of threads that read a table for a query that "
+       "aggregates its rows. 1 disables the parallel reads",
+       SESSION_VAR(max_parallel_degree), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 256), DEFAULT(1), BLOCK_SIZE(1));
+
 static PolyLock_mutex PLock_prepared_stmt_count(&LOCK_prepared_stmt_count);
 static Sys_var_uint Sys_max_prepared_stmt_count(
        "max_prepared_stmt_count",
@@ -2354,6 +2370,13 @@ static Sys_var_ulong Sys_max_sort_length(
        SESSION_VAR(max_sort_length), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(4, 8192*1024L), DEFAULT(1024), BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_max_sort_threads(
+       "max_sort_threads",
+       "Maximum number of threads that sort the rows of a filesort and "
+       "merge the sorted runs. 1 disables the sort threads",
+       SESSION_VAR(max_sort_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 256), DEFAULT(1), BLOCK_SIZE(1));
+
 static Sys_var_ulong Sys_max_sp_recursion_depth(
        "max_sp_recursion_depth",
        "Maximum stored procedure recursion depth",
@@ -2598,6 +2621,10 @@ export const char *optimizer_switch_names[]=
   "condition_pushdown_for_subquery",
   "rowid_filter",
   "condition_pushdown_from_having",
+  "join_cache_spill",
+  "hash_group_by",
+  "batch_cond_eval",
+  "multi_row_fetch",
   "default", 
   NullS
 };
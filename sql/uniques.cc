@@ -105,7 +105,7 @@ Unique::Unique(qsort_cmp2 comp_func, void * comp_func_fixed_arg,
     max_elements= 1;
 
   (void) open_cached_file(&file, mysql_tmpdir,TEMP_PREFIX, DISK_BUFFER_SIZE,
-                          MYF(MY_WME));
+                          MYF(MY_WME | MY_ASYNC_IO));
 }
 
 
@@ -702,7 +702,7 @@ bool Unique::merge(TABLE *table, uchar *buff, bool without_last_merge)
   /* Open cached file for table records if it isn't open */
   if (! my_b_inited(outfile) &&
       open_cached_file(outfile,mysql_tmpdir,TEMP_PREFIX,READ_RECORD_BUFFER,
-                       MYF(MY_WME)))
+                       MYF(MY_WME | MY_ASYNC_IO)))
     return 1;
 
   bzero((char*) &sort_param,sizeof(sort_param));
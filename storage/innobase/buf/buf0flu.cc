@@ -105,14 +105,24 @@ enum page_cleaner_state_t {
 	PAGE_CLEANER_STATE_FINISHED
 };
 
-/** Page cleaner request state for each buffer pool instance */
+/** Page cleaner request state for each buffer pool instance.
+The LRU flushing and the flush_list flushing of an instance are
+separate requests, so that they can be served by different threads
+at the same time. */
 struct page_cleaner_slot_t {
-	page_cleaner_state_t	state;	/*!< state of the request.
+	page_cleaner_state_t	state;	/*!< state of the flush_list
+					request.
 					protected by page_cleaner_t::mutex
-					if the worker thread got the slot and
-					set to PAGE_CLEANER_STATE_FLUSHING,
-					n_flushed_lru and n_flushed_list can be
+					if the worker thread got the request
+					and set it to
+					PAGE_CLEANER_STATE_FLUSHING,
+					n_flushed_list can be
 					updated only by the worker thread */
+	page_cleaner_state_t	lru_state;
+					/*!< state of the LRU request,
+					protected like state; n_flushed_lru
+					can be updated only by the worker
+					thread which is flushing it */
 	/* This value is set during state==PAGE_CLEANER_STATE_NONE */
 	ulint			n_pages_requested;
 					/*!< number of requested pages
@@ -160,15 +170,16 @@ struct page_cleaner_t {
 						flushed */
 	ulint			n_slots;	/*!< total number of slots */
 	ulint			n_slots_requested;
-						/*!< number of slots
+						/*!< number of slot requests
+						(LRU or flush_list)
 						in the state
 						PAGE_CLEANER_STATE_REQUESTED */
 	ulint			n_slots_flushing;
-						/*!< number of slots
+						/*!< number of slot requests
 						in the state
 						PAGE_CLEANER_STATE_FLUSHING */
 	ulint			n_slots_finished;
-						/*!< number of slots
+						/*!< number of slot requests
 						in the state
 						PAGE_CLEANER_STATE_FINISHED */
 	ulint			flush_time;	/*!< elapsed time to flush
@@ -2705,6 +2716,7 @@ pc_request(
 		page_cleaner_slot_t* slot = &page_cleaner.slots[i];
 
 		ut_ad(slot->state == PAGE_CLEANER_STATE_NONE);
+		ut_ad(slot->lru_state == PAGE_CLEANER_STATE_NONE);
 
 		if (min_n == ULINT_MAX) {
 			slot->n_pages_requested = ULINT_MAX;
@@ -2716,9 +2728,10 @@ pc_request(
 		page_cleaner_flush_pages_recommendation() */
 
 		slot->state = PAGE_CLEANER_STATE_REQUESTED;
+		slot->lru_state = PAGE_CLEANER_STATE_REQUESTED;
 	}
 
-	page_cleaner.n_slots_requested = page_cleaner.n_slots;
+	page_cleaner.n_slots_requested = 2 * page_cleaner.n_slots;
 	page_cleaner.n_slots_flushing = 0;
 	page_cleaner.n_slots_finished = 0;
 
@@ -2728,8 +2741,11 @@ pc_request(
 }
 
 /**
-Do flush for one slot.
-@return	the number of the slots which has not been treated yet. */
+Do flush for one slot request. The LRU requests of all slots are
+handed out before any flush_list request, because a shortage of free
+blocks stalls user threads immediately, while the flush_list flushing
+only has to keep up with the redo log over the whole second.
+@return	the number of the slot requests which have not been treated yet. */
 static
 ulint
 pc_flush_slot(void)
@@ -2745,29 +2761,48 @@ pc_flush_slot(void)
 		os_event_reset(page_cleaner.is_requested);
 	} else {
 		page_cleaner_slot_t*	slot = NULL;
+		page_cleaner_state_t*	state = NULL;
 		ulint			i;
 
 		for (i = 0; i < page_cleaner.n_slots; i++) {
 			slot = &page_cleaner.slots[i];
 
-			if (slot->state == PAGE_CLEANER_STATE_REQUESTED) {
+			if (slot->lru_state == PAGE_CLEANER_STATE_REQUESTED) {
+				state = &slot->lru_state;
 				break;
 			}
 		}
 
-		/* slot should be found because
+		if (!state) {
+			for (i = 0; i < page_cleaner.n_slots; i++) {
+				slot = &page_cleaner.slots[i];
+
+				if (slot->state
+				    == PAGE_CLEANER_STATE_REQUESTED) {
+					state = &slot->state;
+					break;
+				}
+			}
+		}
+
+		/* a request should be found because
 		page_cleaner.n_slots_requested > 0 */
 		ut_a(i < page_cleaner.n_slots);
 
-		buf_pool_t* buf_pool = buf_pool_from_array(i);
+		const bool	is_lru = state == &slot->lru_state;
+		buf_pool_t*	buf_pool = buf_pool_from_array(i);
 
 		page_cleaner.n_slots_requested--;
 		page_cleaner.n_slots_flushing++;
-		slot->state = PAGE_CLEANER_STATE_FLUSHING;
+		*state = PAGE_CLEANER_STATE_FLUSHING;
 
 		if (UNIV_UNLIKELY(!page_cleaner.is_running)) {
-			slot->n_flushed_lru = 0;
-			slot->n_flushed_list = 0;
+			if (is_lru) {
+				slot->n_flushed_lru = 0;
+			} else {
+				slot->n_flushed_list = 0;
+				slot->succeeded_list = true;
+			}
 			goto finish_mutex;
 		}
 
@@ -2777,21 +2812,16 @@ pc_flush_slot(void)
 
 		mutex_exit(&page_cleaner.mutex);
 
-		lru_tm = ut_time_ms();
-
-		/* Flush pages from end of LRU if required */
-		slot->n_flushed_lru = buf_flush_LRU_list(buf_pool);
+		if (is_lru) {
+			lru_tm = ut_time_ms();
 
-		lru_tm = ut_time_ms() - lru_tm;
-		lru_pass++;
-
-		if (UNIV_UNLIKELY(!page_cleaner.is_running)) {
-			slot->n_flushed_list = 0;
-			goto finish;
-		}
+			/* Flush pages from end of LRU if required */
+			slot->n_flushed_lru = buf_flush_LRU_list(buf_pool);
 
-		/* Flush pages from flush_list if required */
-		if (page_cleaner.requested) {
+			lru_tm = ut_time_ms() - lru_tm;
+			lru_pass++;
+		} else if (page_cleaner.requested) {
+			/* Flush pages from flush_list if required */
 			flush_counters_t n;
 			memset(&n, 0, sizeof(flush_counters_t));
 			list_tm = ut_time_ms();
@@ -2810,12 +2840,12 @@ pc_flush_slot(void)
 			slot->n_flushed_list = 0;
 			slot->succeeded_list = true;
 		}
-finish:
+
 		mutex_enter(&page_cleaner.mutex);
 finish_mutex:
 		page_cleaner.n_slots_flushing--;
 		page_cleaner.n_slots_finished++;
-		slot->state = PAGE_CLEANER_STATE_FINISHED;
+		*state = PAGE_CLEANER_STATE_FINISHED;
 
 		slot->flush_lru_time += lru_tm;
 		slot->flush_list_time += list_tm;
@@ -2858,18 +2888,20 @@ pc_wait_finished(
 
 	ut_ad(page_cleaner.n_slots_requested == 0);
 	ut_ad(page_cleaner.n_slots_flushing == 0);
-	ut_ad(page_cleaner.n_slots_finished == page_cleaner.n_slots);
+	ut_ad(page_cleaner.n_slots_finished == 2 * page_cleaner.n_slots);
 
 	for (ulint i = 0; i < page_cleaner.n_slots; i++) {
 		page_cleaner_slot_t* slot = &page_cleaner.slots[i];
 
 		ut_ad(slot->state == PAGE_CLEANER_STATE_FINISHED);
+		ut_ad(slot->lru_state == PAGE_CLEANER_STATE_FINISHED);
 
 		*n_flushed_lru += slot->n_flushed_lru;
 		*n_flushed_list += slot->n_flushed_list;
 		all_succeeded &= slot->succeeded_list;
 
 		slot->state = PAGE_CLEANER_STATE_NONE;
+		slot->lru_state = PAGE_CLEANER_STATE_NONE;
 
 		slot->n_pages_requested = 0;
 	}
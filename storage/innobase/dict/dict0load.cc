@@ -182,6 +182,10 @@ dict_load_field_low(
 metadata even if it is marked as "corrupted". */
 my_bool     srv_load_corrupted;
 
+/** Whether file-per-table tablespaces are registered at startup without
+accessing the data files */
+my_bool     srv_lazy_tablespace_open;
+
 #ifdef UNIV_DEBUG
 /****************************************************************//**
 Compare the name of an index column.
@@ -1439,6 +1443,24 @@ static ulint dict_check_sys_tables()
 			continue;
 		}
 
+		if (srv_lazy_tablespace_open
+		    && !DICT_TF_HAS_DATA_DIR(flags)) {
+			/* Only register the tablespace in the default
+			location. The data file will be opened and
+			validated on the first access. */
+			if (!fil_ibd_register(FIL_TYPE_TABLESPACE, space_id,
+					      dict_tf_to_fsp_flags(flags),
+					      table_name)) {
+				ib::warn() << "Ignoring tablespace for "
+					<< table_name
+					<< " because it could not be"
+					" registered.";
+			}
+
+			max_space_id = ut_max(max_space_id, space_id);
+			goto next;
+		}
+
 		/* Set the expected filepath from the data dictionary.
 		If the file is found elsewhere (from an ISL or the default
 		location) or this path is the same file but looks different,
@@ -2961,6 +2983,7 @@ dict_load_table_one(
 	if (cached) {
 		table->can_be_evicted = true;
 		table->add_to_cache();
+		MONITOR_INC(MONITOR_TABLE_LOAD);
 	}
 
 	mem_heap_empty(heap);
@@ -113,12 +113,34 @@ where n=1..n_uniq.
 #define DEBUG_PRINTF(fmt, ...)	/* noop */
 #endif /* UNIV_STATS_DEBUG */
 
+/** Get the number of leaf pages to sample in persistent stats estimation.
+Unless STATS_SAMPLE_PAGES was specified for the table, the sample is grown
+by innodb_stats_persistent_sample_pages for every doubling of the leaf
+level beyond 1024 times that many pages, so that the n_diff estimates of
+huge indexes are not based on the same few pages as those of small ones.
+@param[in]	index	index whose stat_n_leaf_pages has been determined
+@return number of leaf pages to sample for each n-prefix */
+static
+ib_uint64_t
+dict_stats_n_sample_pages(const dict_index_t* index)
+{
+	if (index->table->stats_sample_pages) {
+		return(index->table->stats_sample_pages);
+	}
+
+	const ib_uint64_t	n = srv_stats_persistent_sample_pages;
+	ib_uint64_t		n_sample = n;
+
+	for (ib_uint64_t t = n; t && t <= index->stat_n_leaf_pages >> 10;
+	     t <<= 1) {
+		n_sample += n;
+	}
+
+	return(n_sample);
+}
+
 /* Gets the number of leaf pages to sample in persistent stats estimation */
-#define N_SAMPLE_PAGES(index)					\
-	static_cast<ib_uint64_t>(				\
-		(index)->table->stats_sample_pages != 0		\
-		? (index)->table->stats_sample_pages		\
-		: srv_stats_persistent_sample_pages)
+#define N_SAMPLE_PAGES(index)	dict_stats_n_sample_pages(index)
 
 /* number of distinct records on a given level that are required to stop
 descending to lower levels and fetch N_SAMPLE_PAGES(index) records
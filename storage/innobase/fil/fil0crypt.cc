@@ -39,6 +39,7 @@ Modified           Jan Lindström jan.lindstrom@mariadb.com
 #include "btr0scrub.h"
 #include "fsp0fsp.h"
 #include "fil0pagecompress.h"
+#include "buf0rea.h"
 #include <my_crypt.h>
 
 /** Mutex for keys */
@@ -1748,6 +1749,7 @@ fil_crypt_start_rotate_space(
 		/* FIXME: max_offset could be removed and instead
 		space->size consulted.*/
 		crypt_data->rotate_state.max_offset = state->space->size;
+		crypt_data->rotate_state.done_pages = 0;
 		crypt_data->rotate_state.end_lsn = 0;
 		crypt_data->rotate_state.min_key_version_found =
 			key_state->key_version;
@@ -2144,6 +2146,68 @@ fil_crypt_rotate_page(
 	}
 }
 
+/***********************************************************************
+Submit asynchronous reads for the pages of a batch that reside in the
+same extent as state->offset, so that the pages can be rotated one after
+another without waiting for each page read separately.
+@param[in,out]		state			Rotation state
+@param[in]		end			end of the batch
+@return end of the range for which the reads were submitted */
+static
+ulint
+fil_crypt_read_ahead(
+	rotate_thread_t*	state,
+	ulint			end)
+{
+	fil_space_t* space = state->space;
+	const ulint zip_size = space->zip_size();
+	const ulint extent_end = ut_2pow_round(state->offset,
+					       ulint(FSP_EXTENT_SIZE))
+		+ FSP_EXTENT_SIZE;
+	const ulint ra_end = std::min(end, extent_end);
+	ulint n_reads = 0;
+
+	ut_ad(space->referenced());
+
+	for (ulint offset = state->offset; offset < ra_end; offset++) {
+		if (space->is_stopping()) {
+			break;
+		}
+
+		if (space->id == TRX_SYS_SPACE
+		    && (offset == TRX_SYS_PAGE_NO
+			|| buf_dblwr_page_inside(offset))) {
+			continue;
+		}
+
+		const page_id_t page_id(space->id, offset);
+
+		if (buf_page_peek(page_id)) {
+			continue;
+		}
+
+		buf_read_page_background(page_id, zip_size, false);
+		n_reads++;
+	}
+
+	if (n_reads) {
+		os_aio_simulated_wake_handler_threads();
+		state->crypt_stat.pages_read_from_disk += n_reads;
+
+		/* Throttle the reads according to the allocated
+		innodb_encryption_rotation_iops. */
+		ulint sleeptime_ms = n_reads * 1000 / state->allocated_iops;
+
+		if (sleeptime_ms) {
+			os_event_reset(fil_crypt_throttle_sleep_event);
+			os_event_wait_time(fil_crypt_throttle_sleep_event,
+					   1000 * sleeptime_ms);
+		}
+	}
+
+	return ra_end;
+}
+
 /***********************************************************************
 Rotate a batch of pages
 @param[in,out]		key_state		Key state
@@ -2157,11 +2221,18 @@ fil_crypt_rotate_pages(
 	ulint space = state->space->id;
 	ulint end = std::min(state->offset + state->batch,
 			     state->space->free_limit);
+	ulint ra_end = state->offset;
+	const ulint start = state->offset;
 
 	ut_ad(state->space->referenced());
 
 	for (; state->offset < end; state->offset++) {
 
+		if (state->offset >= ra_end) {
+			/* Read the rest of the extent asynchronously. */
+			ra_end = fil_crypt_read_ahead(state, end);
+		}
+
 		/* we can't rotate pages in dblwr buffer as
 		* it's not possible to read those due to lots of asserts
 		* in buffer pool.
@@ -2183,6 +2254,11 @@ fil_crypt_rotate_pages(
 
 		fil_crypt_rotate_page(key_state, state);
 	}
+
+	fil_space_crypt_t* crypt_data = state->space->crypt_data;
+	mutex_enter(&crypt_data->mutex);
+	crypt_data->rotate_state.done_pages += state->offset - start;
+	mutex_exit(&crypt_data->mutex);
 }
 
 /***********************************************************************
@@ -2673,6 +2749,18 @@ fil_space_crypt_get_status(
 				crypt_data->rotate_state.next_offset;
 			status->rotate_max_page_number =
 				crypt_data->rotate_state.max_offset;
+
+			const time_t elapsed = time(0)
+				- crypt_data->rotate_state.start_time;
+
+			/* next_offset counts the pages handed out to the
+			rotation threads, not the rotated ones. */
+			if (elapsed > 0) {
+				status->rotate_bytes_per_second =
+					crypt_data->rotate_state.done_pages
+					* space->physical_size()
+					/ ulint(elapsed);
+			}
 		}
 
 		mutex_exit(&crypt_data->mutex);
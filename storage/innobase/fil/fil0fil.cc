@@ -441,6 +441,9 @@ static bool fil_comp_algo_validate(const fil_space_t* space)
 #ifdef HAVE_SNAPPY
 	case PAGE_SNAPPY_ALGORITHM:
 #endif /* HAVE_SNAPPY */
+#ifdef HAVE_ZSTD
+	case PAGE_ZSTD_ALGORITHM:
+#endif /* HAVE_ZSTD */
 		return true;
 	}
 
@@ -576,6 +579,7 @@ static bool fil_node_open_file(fil_node_t* node)
 	ut_a(node->is_open());
 
 	fil_system.n_open++;
+	MONITOR_INC(MONITOR_TABLESPACE_OPEN);
 
 	if (fil_space_belongs_in_lru(space)) {
 
@@ -589,8 +593,14 @@ static bool fil_node_open_file(fil_node_t* node)
 /** Close the file handle. */
 void fil_node_t::close()
 {
-	bool	ret;
+	bool	ret = os_file_close(detach());
+	ut_a(ret);
+}
 
+/** Detach the file handle from the node without closing it.
+@return	the detached file handle */
+pfs_os_file_t fil_node_t::detach()
+{
 	ut_ad(mutex_own(&fil_system.mutex));
 	ut_a(is_open());
 	ut_a(n_pending == 0);
@@ -601,36 +611,33 @@ void fil_node_t::close()
 	     || srv_fast_shutdown == 2
 	     || !srv_was_started);
 
-	ret = os_file_close(handle);
-	ut_a(ret);
-
-	/* printf("Closing file %s\n", name); */
+	pfs_os_file_t	old_handle = handle;
 
 	handle = OS_FILE_CLOSED;
 	ut_ad(!is_open());
 	ut_a(fil_system.n_open > 0);
 	fil_system.n_open--;
+	MONITOR_INC(MONITOR_TABLESPACE_CLOSE);
 
 	if (fil_space_belongs_in_lru(space)) {
 		ut_a(UT_LIST_GET_LEN(fil_system.LRU) > 0);
 		UT_LIST_REMOVE(fil_system.LRU, this);
 	}
+
+	return(old_handle);
 }
 
-/** Tries to close a file in the LRU list. The caller must hold the fil_sys
-mutex.
-@return true if success, false if should retry later; since i/o's
-generally complete in < 100 ms, and as InnoDB writes at most 128 pages
-from the buffer pool in a batch, and then immediately flushes the
-files, there is a good chance that the next time we find a suitable
-node from the LRU list.
+/** Detach the least recently used open file that can be closed.
+The caller must hold fil_system.mutex and is responsible for invoking
+os_file_close() on the returned handle, preferrably after releasing
+fil_system.mutex.
 @param[in] print_info	if true, prints information why it
-			cannot close a file*/
+			cannot close a file
+@return the detached file handle
+@retval OS_FILE_CLOSED if no file can be closed right now */
 static
-bool
-fil_try_to_close_file_in_LRU(
-
-	bool	print_info)
+pfs_os_file_t
+fil_detach_file_in_LRU(bool print_info)
 {
 	fil_node_t*	node;
 
@@ -649,9 +656,7 @@ fil_try_to_close_file_in_LRU(
 		    && node->n_pending_flushes == 0
 		    && !node->being_extended) {
 
-			node->close();
-
-			return(true);
+			return(node->detach());
 		}
 
 		if (!print_info) {
@@ -676,7 +681,67 @@ fil_try_to_close_file_in_LRU(
 		}
 	}
 
-	return(false);
+	return(OS_FILE_CLOSED);
+}
+
+/** Tries to close a file in the LRU list. The caller must hold the fil_sys
+mutex.
+@return true if success, false if should retry later; since i/o's
+generally complete in < 100 ms, and as InnoDB writes at most 128 pages
+from the buffer pool in a batch, and then immediately flushes the
+files, there is a good chance that the next time we find a suitable
+node from the LRU list.
+@param[in] print_info	if true, prints information why it
+			cannot close a file*/
+static
+bool
+fil_try_to_close_file_in_LRU(
+
+	bool	print_info)
+{
+	pfs_os_file_t	handle = fil_detach_file_in_LRU(print_info);
+
+	if (handle == OS_FILE_CLOSED) {
+		return(false);
+	}
+
+	bool	ret = os_file_close(handle);
+	ut_a(ret);
+	return(true);
+}
+
+/** Flush the files at the cold end of fil_system.LRU that cannot be
+closed because they contain unflushed writes.
+@return whether any tablespace was flushed */
+static
+bool
+fil_flush_LRU_tail()
+{
+	/** Maximum number of tablespaces to flush at a time */
+	static const ulint	N_FLUSH = 8;
+	ulint			space_ids[N_FLUSH];
+	ulint			n_space_ids = 0;
+
+	mutex_enter(&fil_system.mutex);
+
+	for (const fil_node_t* node = UT_LIST_GET_LAST(fil_system.LRU);
+	     node != NULL && n_space_ids < N_FLUSH;
+	     node = UT_LIST_GET_PREV(LRU, node)) {
+
+		if (node->needs_flush && !node->space->is_stopping()) {
+			space_ids[n_space_ids++] = node->space->id;
+		}
+	}
+
+	mutex_exit(&fil_system.mutex);
+
+	/* It will not hurt to call fil_flush() on a non-existing
+	space id. */
+	for (ulint i = 0; i < n_space_ids; i++) {
+		fil_flush(space_ids[i]);
+	}
+
+	return(n_space_ids != 0);
 }
 
 /** Flush any writes cached by the file system.
@@ -938,30 +1003,39 @@ fil_mutex_enter_and_prepare_for_io(
 			anything; if the space does not exist, we handle the
 			situation in the function which called this
 			function */
-		} else {
-			while (fil_system.n_open >= srv_max_n_open_files) {
-				/* Too many files are open */
-				if (fil_try_to_close_file_in_LRU(count > 1)) {
-					/* No problem */
-				} else if (count >= 2) {
-					ib::warn() << "innodb_open_files="
-						<< srv_max_n_open_files
-						<< " is exceeded ("
-						<< fil_system.n_open
-						<< ") files stay open)";
-					break;
-				} else {
-					mutex_exit(&fil_system.mutex);
+		} else if (fil_system.n_open >= srv_max_n_open_files) {
+			/* Too many files are open */
+			pfs_os_file_t	handle = fil_detach_file_in_LRU(
+				count > 1);
+
+			if (handle != OS_FILE_CLOSED) {
+				/* Closing a file may take time, and
+				other threads may want to access open
+				files meanwhile. */
+				mutex_exit(&fil_system.mutex);
+				bool	ret = os_file_close(handle);
+				ut_a(ret);
+				/* The space may have been dropped while
+				we were not holding fil_system.mutex. */
+				continue;
+			} else if (count >= 2) {
+				ib::warn() << "innodb_open_files="
+					<< srv_max_n_open_files
+					<< " is exceeded ("
+					<< fil_system.n_open
+					<< ") files stay open)";
+			} else {
+				mutex_exit(&fil_system.mutex);
+				/* Flush the least recently used files
+				so that we can close them. Only if there
+				are none, wait for pending I/O. */
+				if (!fil_flush_LRU_tail()) {
 					os_aio_simulated_wake_handler_threads();
 					os_thread_sleep(20000);
-					/* Flush tablespaces so that we can
-					close modified files in the LRU list */
-					fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
-
-					count++;
-					mutex_enter(&fil_system.mutex);
-					continue;
 				}
+
+				count++;
+				continue;
 			}
 		}
 
@@ -3473,6 +3547,72 @@ fil_ibd_open(
 	return space;
 }
 
+/** Register a file-per-table tablespace in the default location
+without accessing the data file. The file will be opened and its
+first page validated by fil_node_open_file() on the first access.
+@param[in]	purpose		FIL_TYPE_TABLESPACE
+@param[in]	id		tablespace ID
+@param[in]	flags		expected FSP_SPACE_FLAGS
+@param[in]	tablename	table name in the databasename/tablename format
+@return	tablespace
+@retval	NULL	if the tablespace could not be registered */
+fil_space_t*
+fil_ibd_register(
+	fil_type_t		purpose,
+	ulint			id,
+	ulint			flags,
+	const table_name_t&	tablename)
+{
+	ut_ad(fil_type_is_data(purpose));
+
+	/* Table flags can be ULINT_UNDEFINED if
+	dict_tf_to_fsp_flags_failure is set. */
+	if (flags == ULINT_UNDEFINED) {
+		return NULL;
+	}
+
+	ut_ad(fil_space_t::is_valid_flags(flags & ~FSP_FLAGS_MEM_MASK, id));
+	/* A tablespace in a remote location must be located via
+	the .isl file, which fil_ibd_open() takes care of. */
+	ut_ad(!FSP_FLAGS_HAS_DATA_DIR(flags));
+
+	mutex_enter(&fil_system.mutex);
+	if (fil_space_t* space = fil_space_get_by_id(id)) {
+		if (strcmp(space->name, tablename.m_name)) {
+			table_name_t space_name;
+			space_name.m_name = space->name;
+			ib::error()
+				<< "Trying to open table " << tablename
+				<< " with id " << id
+				<< ", conflicting with " << space_name;
+			space = NULL;
+		}
+
+		mutex_exit(&fil_system.mutex);
+		return space;
+	}
+	mutex_exit(&fil_system.mutex);
+
+	char* path = fil_make_filepath(NULL, tablename.m_name, IBD, false);
+	if (!path) {
+		return NULL;
+	}
+
+	/* The crypt_data will be read from the first page when the
+	file is opened for the first time. */
+	fil_space_t* space = fil_space_create(
+		tablename.m_name, id, flags, purpose, NULL);
+
+	if (space) {
+		/* We do not know the size of the file yet. It will be
+		determined by fil_node_t::read_page0(). */
+		space->add(path, OS_FILE_CLOSED, 0, false, true);
+	}
+
+	ut_free(path);
+	return space;
+}
+
 /** Looks for a pre-existing fil_space_t with the given tablespace ID
 and, if found, returns the name and filepath in newly allocated buffers
 that the caller must free.
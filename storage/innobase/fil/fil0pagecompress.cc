@@ -72,6 +72,9 @@ Updated 14/02/2015
 #ifdef HAVE_SNAPPY
 #include "snappy-c.h"
 #endif
+#ifdef HAVE_ZSTD
+#include "zstd.h"
+#endif
 
 /** Compress a page for the given compression algorithm.
 @param[in]	buf		page to be compressed
@@ -182,6 +185,22 @@ static ulint fil_page_compress_low(
 		break;
 	}
 #endif /* HAVE_SNAPPY */
+
+#ifdef HAVE_ZSTD
+	case PAGE_ZSTD_ALGORITHM: {
+		/* ZSTD_compress() fails with dstSize_tooSmall rather
+		than overrunning out_buf when the page does not shrink
+		enough, so no extra slack is needed in the buffer. */
+		size_t len = ZSTD_compress(
+			out_buf + header_len, write_size,
+			buf, srv_page_size, int(comp_level));
+
+		if (!ZSTD_isError(len) && len <= write_size) {
+			return len;
+		}
+		break;
+	}
+#endif /* HAVE_ZSTD */
 	}
 
 	return 0;
@@ -510,6 +529,12 @@ static bool fil_page_decompress_low(
 				&& olen == srv_page_size;
 		}
 #endif /* HAVE_SNAPPY */
+#ifdef HAVE_ZSTD
+	case PAGE_ZSTD_ALGORITHM:
+		return ZSTD_decompress(tmp_buf, srv_page_size,
+				       buf + header_len, actual_size)
+			== srv_page_size;
+#endif /* HAVE_ZSTD */
 	}
 
 	return false;
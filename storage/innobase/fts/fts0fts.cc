@@ -88,6 +88,10 @@ static const ulint FTS_CACHE_SIZE_UPPER_LIMIT_IN_MB = 1024;
 /** Time to sleep after DEADLOCK error before retrying operation. */
 static const ulint FTS_DEADLOCK_RETRY_WAIT = 100000;
 
+/** Multiple of innodb_ft_cache_size up to which inserts may keep
+adding to the cache while it is being synced */
+static const ulint FTS_SYNC_CACHE_GROWTH = 2;
+
 /** variable to record innodb_fts_internal_tbl_name for information
 schema table INNODB_FTS_INSERTED etc. */
 char* fts_internal_tbl_name		= NULL;
@@ -3978,17 +3982,16 @@ fts_sync_add_deleted_cache(
 }
 
 /** Write the words and ilist to disk.
-@param[in,out]	trx		transaction
+@param[in,out]	sync		sync state
 @param[in]	index_cache	index cache
-@param[in]	unlock_cache	whether unlock cache when write node
 @return DB_SUCCESS if all went well else error code */
 static MY_ATTRIBUTE((nonnull, warn_unused_result))
 dberr_t
 fts_sync_write_words(
-	trx_t*			trx,
-	fts_index_cache_t*	index_cache,
-	bool			unlock_cache)
+	fts_sync_t*		sync,
+	fts_index_cache_t*	index_cache)
 {
+	trx_t*		trx = sync->trx;
 	fts_table_t	fts_table;
 	ulint		n_nodes = 0;
 	ulint		n_words = 0;
@@ -4037,6 +4040,8 @@ fts_sync_write_words(
 
 			/*FIXME: we need to handle the error properly. */
 			if (error == DB_SUCCESS) {
+				const bool unlock_cache = sync->unlock_cache;
+
 				if (unlock_cache) {
 					rw_lock_x_unlock(
 						&table->fts->cache->lock);
@@ -4058,6 +4063,19 @@ fts_sync_write_words(
 				if (unlock_cache) {
 					rw_lock_x_lock(
 						&table->fts->cache->lock);
+
+					/* Inserts may add documents while
+					the lock is released. Keep the lock
+					for the rest of the sync once the
+					cache has grown too much, so that
+					inserts wait instead. */
+					if (table->fts->cache->total_size
+					    > FTS_SYNC_CACHE_GROWTH
+					    * fts_max_cache_size) {
+						sync->unlock_cache = false;
+						DEBUG_SYNC_C(
+							"fts_sync_cache_full");
+					}
 				}
 			}
 		}
@@ -4126,7 +4144,7 @@ fts_sync_index(
 
 	ut_ad(rbt_validate(index_cache->words));
 
-	return(fts_sync_write_words(trx, index_cache, sync->unlock_cache));
+	return(fts_sync_write_words(sync, index_cache));
 }
 
 /** Check if index cache has been synced completely
@@ -4316,6 +4334,7 @@ fts_sync(
 	}
 
 	ulint		i;
+	ulint		n_passes = 0;
 	dberr_t		error = DB_SUCCESS;
 	fts_cache_t*	cache = sync->table->fts->cache;
 
@@ -4349,10 +4368,14 @@ fts_sync(
 	}
 
 begin_sync:
-	if (cache->total_size > fts_max_cache_size) {
+	if (n_passes++ && cache->total_size > fts_max_cache_size) {
 		/* Avoid the case: sync never finish when
-		insert/update keeps comming. */
-		ut_ad(sync->unlock_cache);
+		insert/update keeps comming. The first pass
+		releases the cache lock while writing, so that
+		inserts can keep filling the cache up to
+		FTS_SYNC_CACHE_GROWTH * fts_max_cache_size; only
+		the nodes that were added meanwhile are written
+		with the lock held. */
 		sync->unlock_cache = false;
 	}
 
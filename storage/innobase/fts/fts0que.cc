@@ -3196,6 +3196,26 @@ fts_query_find_doc_id(
 }
 #endif
 
+/*******************************************************************//**
+Find the first doc id in a set of fts_ranking_t that is not less than
+the given doc id.
+@return the node, or NULL if all doc ids are smaller */
+static
+const ib_rbt_node_t*
+fts_query_doc_ids_lower_bound(
+/*==========================*/
+	const ib_rbt_t*	doc_ids,	/*!< in: rb tree of fts_ranking_t */
+	doc_id_t	doc_id)		/*!< in: doc id to look for */
+{
+	ib_rbt_bound_t	parent;
+
+	if (rbt_search(doc_ids, &parent, &doc_id) > 0 && parent.last) {
+		return(rbt_next(doc_ids, parent.last));
+	}
+
+	return(parent.last);
+}
+
 /*****************************************************************//**
 Read and filter nodes.
 @return DB_SUCCESS if all go well,
@@ -3216,6 +3236,23 @@ fts_query_filter_doc_ids(
 	doc_id_t	doc_id = 0;
 	ulint		decoded = 0;
 	ib_rbt_t*	doc_freqs = word_freq->doc_freqs;
+	const ib_rbt_node_t*	next = NULL;
+
+	/* For '+a +b', only the doc ids that are already in the query
+	set can end up in the intersection. Both the ilist and the set
+	are sorted by doc id, so walk them in step and skip the other
+	doc ids without touching any rb tree. */
+	const bool	merge = query->oper == FTS_EXIST
+		&& query->multi_exist
+		&& query->intersection != NULL
+		&& query->flags != FTS_OPT_RANKING
+		&& !query->collect_positions
+		&& !rbt_empty(query->doc_ids);
+
+	if (merge) {
+		next = fts_query_doc_ids_lower_bound(
+			query->doc_ids, node->first_doc_id);
+	}
 
 	/* Decode the ilist and add the doc ids to the query doc_id set. */
 	while (decoded < len) {
@@ -3237,6 +3274,28 @@ fts_query_filter_doc_ids(
 			word_freq->doc_count++;
 		}
 
+		if (merge) {
+			while (next != NULL
+			       && rbt_value(fts_ranking_t, next)->doc_id
+			       < doc_id) {
+				next = rbt_next(query->doc_ids, next);
+			}
+
+			if (next == NULL
+			    || rbt_value(fts_ranking_t, next)->doc_id
+			    != doc_id) {
+				/* Skip the positions and the end of
+				word position marker. */
+				while (*ptr) {
+					fts_decode_vlc(&ptr);
+				}
+
+				++ptr;
+				decoded = ulint(ptr - (byte*) data);
+				continue;
+			}
+		}
+
 		/* We simply collect the matching instances here. */
 		if (query->collect_positions) {
 			ib_alloc_t*	heap_alloc;
@@ -86,6 +86,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "ibuf0ibuf.h"
 #include "lock0lock.h"
 #include "log0crypt.h"
+#include "log0online.h"
 #include "mtr0mtr.h"
 #include "os0file.h"
 #include "page0zip.h"
@@ -898,6 +899,7 @@ static ibool innodb_have_lz4=IF_LZ4(1, 0);
 static ibool innodb_have_lzma=IF_LZMA(1, 0);
 static ibool innodb_have_bzip2=IF_BZIP2(1, 0);
 static ibool innodb_have_snappy=IF_SNAPPY(1, 0);
+static ibool innodb_have_zstd=IF_ZSTD(1, 0);
 static ibool innodb_have_punch_hole=IF_PUNCH_HOLE(1, 0);
 
 static
@@ -1090,6 +1092,8 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &innodb_have_bzip2,		  SHOW_BOOL},
   {"have_snappy",
   (char*) &innodb_have_snappy,		  SHOW_BOOL},
+  {"have_zstd",
+  (char*) &innodb_have_zstd,		  SHOW_BOOL},
   {"have_punch_hole",
   (char*) &innodb_have_punch_hole,	  SHOW_BOOL},
 
@@ -3792,6 +3796,15 @@ static int innodb_init_params()
 	}
 #endif
 
+#ifndef HAVE_ZSTD
+	if (innodb_compression_algorithm == PAGE_ZSTD_ALGORITHM) {
+		sql_print_error("InnoDB: innodb_compression_algorithm = %lu unsupported.\n"
+				"InnoDB: libzstd is not installed. \n",
+				innodb_compression_algorithm);
+		DBUG_RETURN(HA_ERR_INITIALIZATION);
+	}
+#endif
+
 	if ((srv_encrypt_tables || srv_encrypt_log)
 	     && !encryption_key_id_exists(FIL_DEFAULT_ENCRYPTION_KEY)) {
 		sql_print_error("InnoDB: cannot enable encryption, "
@@ -3932,6 +3945,14 @@ static int innodb_init_params()
 		DBUG_RETURN(HA_ERR_INITIALIZATION);
 	}
 
+	if (srv_log_archive_dir) {
+		if (!*srv_log_archive_dir) {
+			srv_log_archive_dir = NULL;
+		} else {
+			os_normalize_path(srv_log_archive_dir);
+		}
+	}
+
 	if (srv_n_log_files * srv_log_file_size
 	    >= 512ULL * 1024ULL * 1024ULL * 1024ULL) {
 		/* log_block_convert_lsn_to_no() limits the returned block
@@ -6519,6 +6540,45 @@ ha_innobase::clone(
 	DBUG_RETURN(new_handler);
 }
 
+/** Check whether the table may be read by the threads of a parallel
+scan. Every thread reads in a transaction of its own, which can only share
+the read view of the statement for consistent reads.
+@return whether the table can be read by several threads */
+bool
+ha_innobase::can_read_parallel()
+{
+	return(m_prebuilt->select_lock_type == LOCK_NONE
+	       && !m_prebuilt->table->is_temporary());
+}
+
+/** Make the transaction of a thread of a parallel scan see the same data
+as the statement. The read view of the statement is copied, so that its
+own changes are visible, too.
+@param[in]	from	handler of the statement
+@return 0 */
+int
+ha_innobase::start_parallel_read(handler* from)
+{
+	const trx_t*	from_trx = static_cast<ha_innobase*>(from)
+		->m_prebuilt->trx;
+	trx_t*		trx = m_prebuilt->trx;
+
+	DBUG_ENTER("ha_innobase::start_parallel_read");
+
+	ut_ad(trx != from_trx);
+	ut_ad(trx == thd_to_trx(m_user_thd));
+	ut_ad(m_prebuilt->select_lock_type == LOCK_NONE);
+
+	trx->isolation_level = from_trx->isolation_level;
+	trx_start_if_not_started(trx, false);
+
+	if (from_trx->read_view.get_state() == READ_VIEW_STATE_OPEN) {
+		trx->read_view.open_as(from_trx->read_view);
+	}
+
+	DBUG_RETURN(0);
+}
+
 
 uint
 ha_innobase::max_supported_key_part_length() const
@@ -9361,11 +9421,9 @@ ha_innobase::index_read(
 		error = 0;
 		table->status = 0;
 		if (m_prebuilt->table->is_system_db) {
-			srv_stats.n_system_rows_read.add(
-				thd_get_thread_id(m_prebuilt->trx->mysql_thd), 1);
+			srv_stats.n_system_rows_read.inc();
 		} else {
-			srv_stats.n_rows_read.add(
-				thd_get_thread_id(m_prebuilt->trx->mysql_thd), 1);
+			srv_stats.n_rows_read.inc();
 		}
 		break;
 
@@ -9623,11 +9681,9 @@ ha_innobase::general_fetch(
 		error = 0;
 		table->status = 0;
 		if (m_prebuilt->table->is_system_db) {
-			srv_stats.n_system_rows_read.add(
-				thd_get_thread_id(trx->mysql_thd), 1);
+			srv_stats.n_system_rows_read.inc();
 		} else {
-			srv_stats.n_rows_read.add(
-				thd_get_thread_id(trx->mysql_thd), 1);
+			srv_stats.n_rows_read.inc();
 		}
 		break;
 	case DB_RECORD_NOT_FOUND:
@@ -9827,6 +9883,48 @@ ha_innobase::rnd_next(
 	DBUG_RETURN(error);
 }
 
+/** Read the next rows in a table scan. The rows that are in the prefetch
+cache of the scan are returned without a call to row_search_mvcc() for
+each of them.
+@see handler::rnd_next_batch()
+@param[out]	buf		buffer for max_rows rows in MySQL format
+@param[in]	max_rows	maximum number of rows to read
+@param[out]	rows		number of rows read
+@return 0, HA_ERR_END_OF_FILE, or error number */
+int
+ha_innobase::rnd_next_batch(uchar* buf, uint max_rows, uint* rows)
+{
+	const ulint	rec_len = table->s->reclength;
+	int		error = 0;
+
+	DBUG_ENTER("rnd_next_batch");
+
+	for (*rows = 0; *rows < max_rows; ) {
+		uchar*	rec = buf + *rows * rec_len;
+		ulint	n = m_start_of_scan
+			? 0
+			: row_search_pop_cached(rec, rec_len,
+						max_rows - *rows,
+						ROW_SEL_NEXT, m_prebuilt);
+
+		if (n > 0) {
+			*rows += uint(n);
+
+			if (m_prebuilt->table->is_system_db) {
+				srv_stats.n_system_rows_read.add(n);
+			} else {
+				srv_stats.n_rows_read.add(n);
+			}
+		} else if ((error = rnd_next(rec)) != 0) {
+			break;
+		} else {
+			(*rows)++;
+		}
+	}
+
+	DBUG_RETURN(error);
+}
+
 /**********************************************************************//**
 Fetches a row from the table based on a row reference.
 @return 0, HA_ERR_KEY_NOT_FOUND, or error code */
@@ -18496,6 +18594,22 @@ buffer_pool_load_abort(
 	}
 }
 
+/** Dummy value of innodb_flush_changed_page_bitmaps, which is never read */
+static my_bool	innodb_flush_changed_page_bitmaps;
+
+/** Write the changed page bitmaps up to the current log checkpoint if
+innodb_flush_changed_page_bitmaps is set to ON.
+@param[in]	save	immediate result from check function */
+static
+void
+flush_changed_page_bitmaps_set(THD*, st_mysql_sys_var*, void*,
+			       const void* save)
+{
+	if (*(my_bool*) save) {
+		log_online_follow_wait();
+	}
+}
+
 /****************************************************************//**
 Update the system variable innodb_log_write_ahead_size using the "saved"
 value. This function is registered as a callback with MySQL. */
@@ -18965,6 +19079,12 @@ static MYSQL_SYSVAR_BOOL(force_load_corrupted, srv_load_corrupted,
   "Force InnoDB to load metadata of corrupted table.",
   NULL, NULL, FALSE);
 
+static MYSQL_SYSVAR_BOOL(lazy_tablespace_open, srv_lazy_tablespace_open,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Register file-per-table tablespaces at startup without opening"
+  " the data files; each file is opened and validated on first access.",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_BOOL(locks_unsafe_for_binlog, innobase_locks_unsafe_for_binlog,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
   "DEPRECATED. This option may be removed in future releases."
@@ -18976,6 +19096,38 @@ static MYSQL_SYSVAR_STR(log_group_home_dir, srv_log_group_home_dir,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "Path to InnoDB log files.", NULL, NULL, NULL);
 
+static MYSQL_SYSVAR_STR(log_archive_dir, srv_log_archive_dir,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Directory where every redo log block is also written, into segments of"
+  " innodb_log_file_size bytes named by their start LSN"
+  " (default: no archiving)",
+  NULL, NULL, NULL);
+
+static MYSQL_SYSVAR_ULONG(log_archive_expire_sec, srv_log_archive_expire_sec,
+  PLUGIN_VAR_RQCMDARG,
+  "Delete the segments in innodb_log_archive_dir that were completed and"
+  " last written this many seconds ago (default 0: keep all segments)",
+  NULL, NULL, 0, 0, UINT_MAX32, 0);
+
+static MYSQL_SYSVAR_BOOL(track_changed_pages, srv_track_changed_pages,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Track the pages that are modified, for mariabackup --incremental,"
+  " in the ib_modified_log_*.xdb bitmap files in innodb_data_home_dir",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_ULONG(track_changed_pages_expire_sec,
+  srv_track_changed_pages_expire_sec,
+  PLUGIN_VAR_RQCMDARG,
+  "Delete the changed page bitmap files that were completed and last"
+  " written this many seconds ago (default 0: keep all files)",
+  NULL, NULL, 0, 0, UINT_MAX32, 0);
+
+static MYSQL_SYSVAR_BOOL(flush_changed_page_bitmaps,
+  innodb_flush_changed_page_bitmaps,
+  PLUGIN_VAR_OPCMDARG,
+  "Write the changed page bitmaps up to the latest log checkpoint",
+  NULL, flush_changed_page_bitmaps_set, FALSE);
+
 /** Update innodb_page_cleaners.
 @param[in]	save	the new value of innodb_page_cleaners */
 static
@@ -19083,7 +19235,8 @@ static MYSQL_SYSVAR_ULONGLONG(stats_persistent_sample_pages,
   srv_stats_persistent_sample_pages,
   PLUGIN_VAR_RQCMDARG,
   "The number of leaf index pages to sample when calculating persistent"
-  " statistics (by ANALYZE, default 20)",
+  " statistics (by ANALYZE, default 20); indexes of more than 1024 times"
+  " as many leaf pages get a larger sample",
   NULL, NULL, 20, 1, ~0ULL, 0);
 
 static MYSQL_SYSVAR_ULONGLONG(stats_modified_counter, srv_stats_modified_counter,
@@ -19830,7 +19983,7 @@ static MYSQL_SYSVAR_BOOL(force_primary_key,
   "Do not allow to create table without primary key (off by default)",
   NULL, NULL, FALSE);
 
-static const char *page_compression_algorithms[]= { "none", "zlib", "lz4", "lzo", "lzma", "bzip2", "snappy", 0 };
+static const char *page_compression_algorithms[]= { "none", "zlib", "lz4", "lzo", "lzma", "bzip2", "snappy", "zstd", 0 };
 static TYPELIB page_compression_algorithms_typelib=
 {
   array_elements(page_compression_algorithms) - 1, 0,
@@ -19838,7 +19991,7 @@ static TYPELIB page_compression_algorithms_typelib=
 };
 static MYSQL_SYSVAR_ENUM(compression_algorithm, innodb_compression_algorithm,
   PLUGIN_VAR_OPCMDARG,
-  "Compression algorithm used on page compression. One of: none, zlib, lz4, lzo, lzma, or bzip2",
+  "Compression algorithm used on page compression. One of: none, zlib, lz4, lzo, lzma, bzip2, snappy, or zstd",
   innodb_compression_algorithm_validate, NULL,
   /* We use here the largest number of supported compression method to
   enable all those methods that are available. Availability of compression
@@ -20020,6 +20173,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(ft_sort_pll_degree),
   MYSQL_SYSVAR(large_prefix), /* deprecated in MariaDB 10.2; no effect */
   MYSQL_SYSVAR(force_load_corrupted),
+  MYSQL_SYSVAR(lazy_tablespace_open),
   MYSQL_SYSVAR(lock_schedule_algorithm),
   MYSQL_SYSVAR(locks_unsafe_for_binlog),
   MYSQL_SYSVAR(lock_wait_timeout),
@@ -20030,6 +20184,11 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(log_files_in_group),
   MYSQL_SYSVAR(log_write_ahead_size),
   MYSQL_SYSVAR(log_group_home_dir),
+  MYSQL_SYSVAR(log_archive_dir),
+  MYSQL_SYSVAR(log_archive_expire_sec),
+  MYSQL_SYSVAR(track_changed_pages),
+  MYSQL_SYSVAR(track_changed_pages_expire_sec),
+  MYSQL_SYSVAR(flush_changed_page_bitmaps),
   MYSQL_SYSVAR(log_compressed_pages),
   MYSQL_SYSVAR(log_optimize_ddl),
   MYSQL_SYSVAR(max_dirty_pages_pct),
@@ -21285,6 +21444,17 @@ innodb_compression_algorithm_validate(
 		DBUG_RETURN(1);
 	}
 #endif
+
+#ifndef HAVE_ZSTD
+	if (compression_algorithm == PAGE_ZSTD_ALGORITHM) {
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    HA_ERR_UNSUPPORTED,
+				    "InnoDB: innodb_compression_algorithm = %lu unsupported.\n"
+				    "InnoDB: libzstd is not installed. \n",
+				    compression_algorithm);
+		DBUG_RETURN(1);
+	}
+#endif
 	DBUG_RETURN(0);
 }
 
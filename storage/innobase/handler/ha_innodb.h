@@ -106,6 +106,10 @@ class ha_innobase: public handler
 
 	handler* clone(const char *name, MEM_ROOT *mem_root);
 
+	bool can_read_parallel();
+
+	int start_parallel_read(handler* from);
+
 	int close(void);
 
 	double scan_time();
@@ -158,6 +162,8 @@ class ha_innobase: public handler
 
 	int rnd_next(uchar *buf);
 
+	int rnd_next_batch(uchar* buf, uint max_rows, uint* rows);
+
 	int rnd_pos(uchar * buf, uchar *pos);
 
 	int ft_init();
@@ -1588,7 +1588,16 @@ static ST_FIELD_INFO	i_s_cmp_per_index_fields_info[] =
 	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
-#define IDX_COMPRESS_TIME	5
+#define IDX_COMPRESS_OPS_SKIPPED	5
+	{STRUCT_FLD(field_name,		"compress_ops_skipped"),
+	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_COMPRESS_TIME	6
 	{STRUCT_FLD(field_name,		"compress_time"),
 	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
 	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
@@ -1597,7 +1606,7 @@ static ST_FIELD_INFO	i_s_cmp_per_index_fields_info[] =
 	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
-#define IDX_UNCOMPRESS_OPS	6
+#define IDX_UNCOMPRESS_OPS	7
 	{STRUCT_FLD(field_name,		"uncompress_ops"),
 	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
 	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
@@ -1606,7 +1615,7 @@ static ST_FIELD_INFO	i_s_cmp_per_index_fields_info[] =
 	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
-#define IDX_UNCOMPRESS_TIME	7
+#define IDX_UNCOMPRESS_TIME	8
 	{STRUCT_FLD(field_name,		"uncompress_time"),
 	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
 	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
@@ -1695,6 +1704,8 @@ i_s_cmp_per_index_fill_low(
 			    iter->second.compressed, true)
 		    || fields[IDX_COMPRESS_OPS_OK]->store(
 			    iter->second.compressed_ok, true)
+		    || fields[IDX_COMPRESS_OPS_SKIPPED]->store(
+			    iter->second.compressed_skipped, true)
 		    || fields[IDX_COMPRESS_TIME]->store(
 			    iter->second.compressed_usec / 1000000, true)
 		    || fields[IDX_UNCOMPRESS_OPS]->store(
@@ -8492,6 +8503,15 @@ static ST_FIELD_INFO	innodb_tablespaces_encryption_fields_info[] =
 	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
+#define TABLESPACES_ENCRYPTION_KEY_ROTATION_BYTES_PER_SECOND 10
+	{STRUCT_FLD(field_name,		"KEY_ROTATION_BYTES_PER_SECOND"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED | MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
 	END_OF_ST_FIELD_INFO
 };
 
@@ -8549,11 +8569,16 @@ i_s_dict_fill_tablespaces_encryption(
 		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_MAX_PAGE_NUMBER]->set_notnull();
 		OK(fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_MAX_PAGE_NUMBER]->store(
 			   status.rotate_max_page_number, true));
+		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_BYTES_PER_SECOND]->set_notnull();
+		OK(fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_BYTES_PER_SECOND]->store(
+			   status.rotate_bytes_per_second, true));
 	} else {
 		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_PAGE_NUMBER]
 			->set_null();
 		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_MAX_PAGE_NUMBER]
 			->set_null();
+		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_BYTES_PER_SECOND]
+			->set_null();
 	}
 
 	OK(schema_table_store_record(thd, table_to_fill));
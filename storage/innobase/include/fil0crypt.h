@@ -87,6 +87,7 @@ struct fil_space_rotate_state_t
 	ulint active_threads;	/*!< active threads in space */
 	ulint next_offset;	/*!< next "free" offset */
 	ulint max_offset;	/*!< max offset needing to be rotated */
+	ulint done_pages;	/*!< pages whose rotation has completed */
 	uint  min_key_version_found; /*!< min key version found but not
 				     rotated */
 	lsn_t end_lsn;		/*!< max lsn created when rotating this
@@ -212,6 +213,7 @@ struct fil_space_crypt_status_t {
 	bool flushing;           /*!< is flush at end of rotation ongoing */
 	ulint rotate_next_page_number; /*!< next page if key rotating */
 	ulint rotate_max_page_number;  /*!< max page if key rotating */
+	ulint rotate_bytes_per_second; /*!< average rotation rate */
 };
 
 /** Statistics about encryption key rotation */
@@ -380,6 +380,7 @@ struct fil_space_t {
 		case PAGE_LZ4_ALGORITHM:
 		case PAGE_LZO_ALGORITHM:
 		case PAGE_SNAPPY_ALGORITHM:
+		case PAGE_ZSTD_ALGORITHM:
 			return true;
 		}
 		return false;
@@ -603,6 +604,11 @@ struct fil_node_t {
 
 	/** Close the file handle. */
 	void close();
+	/** Detach the file handle from the node without closing it,
+	so that os_file_close() can be invoked without holding
+	fil_system.mutex.
+	@return	the detached file handle */
+	pfs_os_file_t detach();
 };
 
 /** Value of fil_node_t::magic_n */
@@ -1300,6 +1306,25 @@ fil_ibd_open(
 	dberr_t*		err = NULL)
 	MY_ATTRIBUTE((warn_unused_result));
 
+/** Register a file-per-table tablespace in the default location
+without accessing the data file. The file will be opened and its
+first page validated by fil_node_open_file() on the first access.
+This is used at startup, so that the startup time does not depend on
+the number of tables.
+@param[in]	purpose		FIL_TYPE_TABLESPACE
+@param[in]	id		tablespace ID
+@param[in]	flags		expected FSP_SPACE_FLAGS
+@param[in]	tablename	table name in the databasename/tablename format
+@return	tablespace
+@retval	NULL	if the tablespace could not be registered */
+fil_space_t*
+fil_ibd_register(
+	fil_type_t		purpose,
+	ulint			id,
+	ulint			flags,
+	const table_name_t&	tablename)
+	MY_ATTRIBUTE((warn_unused_result));
+
 enum fil_load_status {
 	/** The tablespace file(s) were found and valid. */
 	FIL_LOAD_OK,
@@ -0,0 +1,64 @@
+/*****************************************************************************
+
+Copyright (c) 2019, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/log0arch.h
+Redo log archiving.
+
+A background thread copies the redo log blocks that have been written to
+ib_logfile* into segment files of innodb_log_file_size bytes in
+innodb_log_archive_dir. A segment is named ib_logarch.<start LSN>, and
+the byte at LSN x is at offset x - start LSN of the segment. Completed
+segments are deleted innodb_log_archive_expire_sec seconds after they
+were last written.
+*******************************************************/
+
+#ifndef log0arch_h
+#define log0arch_h
+
+#include "log0types.h"
+
+/** Initialize the redo log archiving, before crash recovery is started.
+Does nothing unless innodb_log_archive_dir is set. */
+void log_archive_init();
+
+/** Start the redo log archiving thread, if innodb_log_archive_dir is set.
+Archiving resumes at the end of the last segment if the redo log still
+contains that LSN, or starts at the latest log checkpoint. */
+void log_archive_create_thread();
+
+/** Determine how far the redo log archiving is behind.
+@param[in]	lsn	the current LSN
+@return	the number of bytes of redo log that have not been archived,
+or 0 if the redo log archiving is not active */
+lsn_t log_archive_age(lsn_t lsn);
+
+/** Wake up the redo log archiving thread. */
+void log_archive_wake();
+
+/** Wait for the redo log to be archived up to the last log write. */
+void log_archive_follow_wait();
+
+/** Archive the redo log up to the last log write,
+and stop the redo log archiving thread. */
+void log_archive_shutdown();
+
+/** Close the redo log archiving at shutdown. */
+void log_archive_close();
+
+#endif /* log0arch_h */
@@ -0,0 +1,69 @@
+/*****************************************************************************
+
+Copyright (c) 2011-2012, Percona Inc. All Rights Reserved.
+Copyright (c) 2019, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/log0online.h
+Changed page tracking for incremental backups.
+
+A background thread parses the redo log up to each log checkpoint and
+writes the pages that were modified as a run of bitmap blocks to the
+ib_modified_log_<seq>_<lsn>.xdb files in innodb_data_home_dir.
+The file format is the one of the XtraDB changed page bitmaps, which
+mariabackup --incremental reads in extra/mariabackup/changed_page_bitmap.cc.
+*******************************************************/
+
+#ifndef log0online_h
+#define log0online_h
+
+#include "log0types.h"
+
+/** Initialize the changed page tracking, before crash recovery is started.
+Does nothing unless innodb_track_changed_pages is set. */
+void log_online_init();
+
+/** Set the LSN from which the changed pages are being tracked.
+If the last run ended before it, the tracking resumes from there.
+@param[in]	lsn	the checkpoint LSN from which crash recovery starts */
+void log_online_start(lsn_t lsn);
+
+/** Start the changed page tracking thread,
+if innodb_track_changed_pages is set. */
+void log_online_create_thread();
+
+/** Determine how far the changed page tracking is behind.
+@param[in]	lsn	the current LSN
+@return	the number of bytes of redo log that have not been tracked,
+or 0 if the changed page tracking is not active */
+lsn_t log_online_age(lsn_t lsn);
+
+/** Wake up the changed page tracking thread. */
+void log_online_wake();
+
+/** Wait for the changed page bitmaps to be written up to
+the latest log checkpoint. */
+void log_online_follow_wait();
+
+/** Write the changed page bitmaps up to the latest log checkpoint,
+and stop the changed page tracking thread. */
+void log_online_shutdown();
+
+/** Close the changed page tracking at shutdown. */
+void log_online_close();
+
+#endif /* log0online_h */
@@ -131,6 +131,24 @@ hash table to wait merging to file pages.
 or corruption was noticed */
 bool recv_parse_log_recs(lsn_t checkpoint_lsn, store_t store, bool apply);
 
+/** Parse the page identifier and the length of a redo log record, for
+the changed page tracking. Unlike recv_parse_log_rec(), this does not
+process any MLOG_FILE_ record.
+@param[in]	ptr	start of the record
+@param[in]	end_ptr	end of the buffer
+@param[out]	type	log record type
+@param[out]	space	tablespace identifier
+@param[out]	page_no	page number
+@return length of the record, or 0 if the record was not complete
+or it was corrupted */
+ulint
+recv_parse_log_rec_page_id(
+	byte*		ptr,
+	byte*		end_ptr,
+	mlog_id_t*	type,
+	ulint*		space,
+	ulint*		page_no);
+
 /** Moves the parsing buffer data left to the buffer start. */
 void recv_sys_justify_left_parsing_buf();
 
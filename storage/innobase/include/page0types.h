@@ -111,6 +111,9 @@ struct page_zip_stat_t {
 	ulint		compressed;
 	/** Number of successful page compressions */
 	ulint		compressed_ok;
+	/** Number of page compressions that were not attempted
+	because they were predicted to fail */
+	ulint		compressed_skipped;
 	/** Number of page decompressions */
 	ulint		decompressed;
 	/** Duration of page compressions in microseconds */
@@ -123,6 +126,7 @@ struct page_zip_stat_t {
 		exist it gets inserted with zeroed members. */
 		compressed(0),
 		compressed_ok(0),
+		compressed_skipped(0),
 		decompressed(0),
 		compressed_usec(0),
 		decompressed_usec(0)
@@ -145,6 +145,22 @@ page_zip_compress(
 	mtr_t*			mtr);		/*!< in/out: mini-transaction,
 						or NULL */
 
+/** Determine whether page_zip_compress() is bound to fail after
+inserting a record of the given size into a freshly compressed leaf
+page. The compressed stream is assumed to grow by the record size
+times the compression ratio of the page.
+@param[in]	page_zip	compressed page
+@param[in]	page		uncompressed page
+@param[in]	index		index of the B-tree node
+@param[in]	rec_size	size of the record that is to be inserted
+@return whether the compression should not be attempted */
+bool
+page_zip_compress_is_futile(
+	const page_zip_des_t*	page_zip,
+	const page_t*		page,
+	const dict_index_t*	index,
+	ulint			rec_size);
+
 /**********************************************************************//**
 Write the index information for the compressed page.
 @return used size of buf */
@@ -137,6 +137,18 @@ class ReadView
   void open(trx_t *trx);
 
 
+  /**
+    Opens a read view that sees exactly what another open view sees.
+
+    This is used by the threads of a parallel scan, whose transactions must
+    see the same data as the transaction of the statement, including its
+    own changes.
+
+    @param[in] other  open view of another transaction
+  */
+  void open_as(const ReadView &other);
+
+
   /**
     Closes the view.
 
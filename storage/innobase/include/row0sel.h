@@ -194,6 +194,23 @@ row_search_mvcc(
 	ulint		direction)
 	MY_ATTRIBUTE((warn_unused_result));
 
+/** Pop the rows of a cursor from its prefetch cache, without searching
+the index.
+@param[out]	buf		buffer for at most n rows in MySQL format
+@param[in]	rec_len		distance of the rows in buf
+@param[in]	n		maximum number of rows to pop
+@param[in]	direction	ROW_SEL_NEXT or ROW_SEL_PREV
+@param[in,out]	prebuilt	prebuilt struct for the table handler
+@return number of rows copied to buf; 0 if the cache is empty or it
+was filled while moving in the other direction */
+ulint
+row_search_pop_cached(
+	byte*		buf,
+	ulint		rec_len,
+	ulint		n,
+	ulint		direction,
+	row_prebuilt_t*	prebuilt);
+
 /********************************************************************//**
 Count rows in a R-Tree leaf level.
 @return DB_SUCCESS if successful */
@@ -136,6 +136,9 @@ enum monitor_id_t {
 	MONITOR_TABLE_OPEN,
 	MONITOR_TABLE_CLOSE,
 	MONITOR_TABLE_REFERENCE,
+	MONITOR_TABLE_LOAD,
+	MONITOR_TABLESPACE_OPEN,
+	MONITOR_TABLESPACE_CLOSE,
 
 	/* Lock manager related counters */
 	MONITOR_MODULE_LOCK,
@@ -337,6 +340,7 @@ enum monitor_id_t {
 	MONITOR_MODULE_PAGE,
 	MONITOR_PAGE_COMPRESS,
 	MONITOR_PAGE_DECOMPRESS,
+	MONITOR_PAGE_COMPRESS_SKIPPED,
 	MONITOR_PAD_INCREMENTS,
 	MONITOR_PAD_DECREMENTS,
 	/* New monitor variables for page compression */
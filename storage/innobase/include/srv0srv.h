@@ -332,6 +332,18 @@ extern my_bool	srv_prefix_index_cluster_optimization;
 extern const ulint	SRV_UNDO_TABLESPACE_SIZE_IN_PAGES;
 
 extern char*	srv_log_group_home_dir;
+/** Directory where a copy of every redo log block is archived,
+or NULL if innodb_log_archive_dir is not set */
+extern char*	srv_log_archive_dir;
+/** Number of seconds after the last write of a redo log archive segment
+when it is deleted, or 0 to keep the segments */
+extern ulong	srv_log_archive_expire_sec;
+/** innodb_track_changed_pages: whether to write changed page bitmaps
+for incremental backups */
+extern my_bool	srv_track_changed_pages;
+/** Number of seconds after the last write of a changed page bitmap file
+when it is deleted, or 0 to keep the files */
+extern ulong	srv_track_changed_pages_expire_sec;
 
 extern ulong	srv_n_log_files;
 /** The InnoDB redo log file size, or 0 when changing the redo log format
@@ -354,6 +366,10 @@ even if they are marked as "corrupted". Mostly it is for DBA to process
 corrupted index and table */
 extern my_bool	srv_load_corrupted;
 
+/** Whether file-per-table tablespaces are registered at startup without
+accessing the data files; the files are opened and validated on first use */
+extern my_bool	srv_lazy_tablespace_open;
+
 /** Requested size in bytes */
 extern ulint		srv_buf_pool_size;
 /** Minimum pool size in bytes */
@@ -31,6 +31,10 @@ Created 2012/04/12 by Sunny Bains
 #include "os0thread.h"
 #include "my_rdtsc.h"
 
+#ifdef HAVE_SCHED_GETCPU
+#include <sched.h>
+#endif /* HAVE_SCHED_GETCPU */
+
 /** CPU cache line size */
 #ifdef CPU_LEVEL1_DCACHE_LINESIZE
 # define CACHE_LINE_SIZE	CPU_LEVEL1_DCACHE_LINESIZE
@@ -65,6 +69,24 @@ get_rnd_value()
 #endif /* !_WIN32 */
 }
 
+/** @return the slot of ib_counter_t to use for the calling thread:
+the number of the CPU that it is running on, so that concurrent
+updates from different CPUs never share a cache line, or a random
+value if that is not known */
+static inline size_t
+get_counter_slot()
+{
+#ifdef HAVE_SCHED_GETCPU
+	int cpu = sched_getcpu();
+
+	if (cpu >= 0) {
+		return static_cast<size_t>(cpu);
+	}
+#endif /* HAVE_SCHED_GETCPU */
+
+	return get_rnd_value();
+}
+
 /** Class for using fuzzy counters. The counter is multi-instance relaxed atomic
 so the results are not guaranteed to be 100% accurate but close
 enough. Creates an array of counters and separates each element by the
@@ -80,7 +102,7 @@ struct ib_counter_t {
 
 	/** Add to the counter.
 	@param[in]	n	amount to be added */
-	void add(Type n) { add(get_rnd_value(), n); }
+	void add(Type n) { add(get_counter_slot(), n); }
 
 	/** Add to the counter.
 	@param[in]	index	a reasonably thread-unique identifier
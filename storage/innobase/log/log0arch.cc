@@ -0,0 +1,528 @@
+/*****************************************************************************
+
+Copyright (c) 2019, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file log/log0arch.cc
+Redo log archiving.
+
+Like the changed page tracking in log0online.cc, a background thread
+reads the redo log blocks back from ib_logfile*, up to log_sys.write_lsn,
+and copies them to the archive segments. The write-ahead padding after
+write_lsn is never copied, and nothing is done when the log is written;
+log_check_margins() only waits for the thread if it falls so far behind
+that the log would be overwritten before it was copied.
+*******************************************************/
+
+#include "log0arch.h"
+#include "buf0buf.h"
+#include "log0log.h"
+#include "fil0fil.h"
+#include "os0file.h"
+#include "os0thread.h"
+#include "srv0srv.h"
+#include "ut0new.h"
+
+#include <atomic>
+#include <vector>
+
+/** File name stem of the archive segments */
+static const char log_archive_file_stem[] = "ib_logarch";
+
+/** Size of a redo log read, in bytes */
+static const ulint log_archive_read_size = 1 << 20;
+
+/** The redo log archiver */
+static struct
+{
+	/** whether log_archive_init() was completed */
+	bool			initialised;
+	/** whether log_archive_thread is running */
+	std::atomic<bool>	active;
+	/** whether log_archive_thread should exit after a final pass */
+	std::atomic<bool>	stop;
+	/** wakes up log_archive_thread */
+	os_event_t		event;
+	/** set by log_archive_thread after each pass */
+	os_event_t		archived_event;
+	/** LSN up to which the archive has been durably written */
+	std::atomic<lsn_t>	archived_lsn;
+	/** end LSN of the last segment that was found by
+	log_archive_init(), or 0 */
+	lsn_t			resume_lsn;
+
+	/* The following are only accessed by log_archive_thread
+	while it is active. */
+
+	/** memory for read_buf */
+	byte*			read_buf_unaligned;
+	/** buffer for redo log reads, of log_archive_read_size bytes */
+	byte*			read_buf;
+	/** the segment being written, or OS_FILE_CLOSED */
+	pfs_os_file_t		file;
+	/** name of file */
+	char			name[OS_FILE_MAX_PATH];
+	/** start LSN of file */
+	lsn_t			start_lsn;
+} log_archive;
+
+/** Find the end of the archive that was written before the restart.
+@return	the LSN of the last block of the last segment, which may have
+been partially filled, or 0 if there are no segments */
+static lsn_t log_archive_find_end()
+{
+	os_file_dir_t	dir = os_file_opendir(srv_log_archive_dir, false);
+
+	if (!dir) {
+		return 0;
+	}
+
+	lsn_t		end_lsn = 0;
+	os_file_stat_t	info;
+
+	while (!os_file_readdir_next_file(srv_log_archive_dir, dir, &info)) {
+		char	stem[sizeof log_archive_file_stem];
+		lsn_t	lsn;
+
+		if (info.type == OS_FILE_TYPE_FILE
+		    && sscanf(info.name, "%10[a-z_]." LSN_PF,
+			      stem, &lsn) == 2
+		    && !strcmp(stem, log_archive_file_stem)) {
+			const os_offset_t size = ut_uint64_align_down(
+				info.size, OS_FILE_LOG_BLOCK_SIZE);
+			lsn += size ? size - OS_FILE_LOG_BLOCK_SIZE : 0;
+			end_lsn = std::max(end_lsn, lsn);
+		}
+	}
+
+	os_file_closedir(dir);
+	return end_lsn;
+}
+
+/** Initialize the redo log archiving, before crash recovery is started.
+Does nothing unless innodb_log_archive_dir is set. */
+void log_archive_init()
+{
+	ut_ad(!log_archive.initialised);
+
+	if (!srv_log_archive_dir) {
+		return;
+	}
+
+	if (srv_read_only_mode || srv_operation != SRV_OPERATION_NORMAL) {
+		srv_log_archive_dir = NULL;
+		return;
+	}
+
+	log_archive.resume_lsn = log_archive_find_end();
+	log_archive.event = os_event_create(0);
+	log_archive.archived_event = os_event_create(0);
+	log_archive.read_buf_unaligned = static_cast<byte*>(
+		ut_malloc_nokey(log_archive_read_size + srv_page_size));
+	log_archive.read_buf = static_cast<byte*>(
+		ut_align(log_archive.read_buf_unaligned, srv_page_size));
+	log_archive.archived_lsn = 0;
+	log_archive.active = false;
+	log_archive.stop = false;
+	log_archive.file = OS_FILE_CLOSED;
+	log_archive.start_lsn = 0;
+	log_archive.initialised = true;
+}
+
+/** Read log blocks to read_buf, as they are stored in ib_logfile*.
+@param[in]	start_lsn	LSN of the first block
+@param[in]	offset		file offset of start_lsn
+@param[in]	len		number of bytes to read
+@return	the length of the valid blocks at the start of read_buf */
+static ulint log_archive_read_blocks(lsn_t start_lsn, lsn_t offset, ulint len)
+{
+	const byte*	buf = log_archive.read_buf;
+
+	if (fil_io(IORequestLogRead, true,
+		   page_id_t(SRV_LOG_SPACE_FIRST_ID,
+			     ulint(offset >> srv_page_size_shift)),
+		   0, ulint(offset & (srv_page_size - 1)), len,
+		   log_archive.read_buf, NULL)
+	    != DB_SUCCESS) {
+		return 0;
+	}
+
+	ulint	l = 0;
+
+	for (; l < len; l += OS_FILE_LOG_BLOCK_SIZE,
+		     buf += OS_FILE_LOG_BLOCK_SIZE) {
+		if (log_block_get_hdr_no(buf)
+		    != log_block_convert_lsn_to_no(start_lsn + l)) {
+			break;
+		}
+
+		if ((innodb_log_checksums || log_sys.is_encrypted())
+		    && log_block_calc_checksum_crc32(buf)
+		    != log_block_get_checksum(buf)) {
+			break;
+		}
+	}
+
+	return l;
+}
+
+/** Close the segment that is being written, after durably writing it.
+@return	whether the segment was durably written */
+static bool log_archive_close_segment()
+{
+	if (log_archive.file == OS_FILE_CLOSED) {
+		return true;
+	}
+
+	const bool	success = os_file_flush(log_archive.file);
+	os_file_close(log_archive.file);
+	log_archive.file = OS_FILE_CLOSED;
+	return success;
+}
+
+/** Copy log blocks to the archive segments.
+@param[in]	buf		log blocks
+@param[in]	len		length of buf, in bytes
+@param[in]	start_lsn	LSN of the first block in buf
+@return	whether the blocks were written */
+static bool log_archive_write(const byte* buf, ulint len, lsn_t start_lsn)
+{
+	while (len) {
+		const lsn_t	seg_start = start_lsn
+			- start_lsn % srv_log_file_size;
+
+		if (log_archive.file == OS_FILE_CLOSED
+		    || log_archive.start_lsn != seg_start) {
+			bool	success;
+
+			if (!log_archive_close_segment()) {
+				return false;
+			}
+
+			snprintf(log_archive.name, sizeof log_archive.name,
+				 "%s%c%s." LSN_PF,
+				 srv_log_archive_dir, OS_PATH_SEPARATOR,
+				 log_archive_file_stem, seg_start);
+
+			log_archive.file
+				= os_file_create_simple_no_error_handling(
+					innodb_log_file_key, log_archive.name,
+					OS_FILE_OPEN, OS_FILE_READ_WRITE,
+					false, &success);
+			if (!success) {
+				log_archive.file
+					= os_file_create_simple_no_error_handling(
+						innodb_log_file_key,
+						log_archive.name,
+						OS_FILE_CREATE,
+						OS_FILE_READ_WRITE,
+						false, &success);
+			}
+
+			if (!success) {
+				log_archive.file = OS_FILE_CLOSED;
+				ib::error() << "Cannot open redo log archive "
+					<< log_archive.name;
+				return false;
+			}
+
+			log_archive.start_lsn = seg_start;
+		}
+
+		const ulint	n = ulint(std::min<lsn_t>(
+				  len, seg_start + srv_log_file_size
+				  - start_lsn));
+
+		if (os_file_write(IORequestWrite, log_archive.name,
+				  log_archive.file, buf,
+				  start_lsn - seg_start, n) != DB_SUCCESS) {
+			return false;
+		}
+
+		buf += n;
+		len -= n;
+		start_lsn += n;
+	}
+
+	return true;
+}
+
+/** Delete the completed segments that were last written more than
+innodb_log_archive_expire_sec seconds ago. */
+static void log_archive_purge()
+{
+	if (!srv_log_archive_expire_sec) {
+		return;
+	}
+
+	os_file_dir_t	dir = os_file_opendir(srv_log_archive_dir, false);
+
+	if (!dir) {
+		return;
+	}
+
+	std::vector<lsn_t>	expired;
+	const time_t		now = time(NULL);
+	os_file_stat_t		info;
+
+	while (!os_file_readdir_next_file(srv_log_archive_dir, dir, &info)) {
+		char		stem[sizeof log_archive_file_stem];
+		lsn_t		lsn;
+		os_file_stat_t	stat_info;
+		char		name[OS_FILE_MAX_PATH];
+
+		if (info.type != OS_FILE_TYPE_FILE
+		    || sscanf(info.name, "%10[a-z_]." LSN_PF,
+			      stem, &lsn) != 2
+		    || strcmp(stem, log_archive_file_stem)
+		    || lsn + srv_log_file_size > log_archive.start_lsn) {
+			continue;
+		}
+
+		snprintf(name, sizeof name, "%s%c%s",
+			 srv_log_archive_dir, OS_PATH_SEPARATOR, info.name);
+
+		if (os_file_get_status(name, &stat_info, false, true)
+		    == DB_SUCCESS
+		    && difftime(now, stat_info.mtime)
+		    >= double(srv_log_archive_expire_sec)) {
+			expired.push_back(lsn);
+		}
+	}
+
+	os_file_closedir(dir);
+
+	for (std::vector<lsn_t>::const_iterator it = expired.begin();
+	     it != expired.end(); ++it) {
+		char	name[OS_FILE_MAX_PATH];
+
+		snprintf(name, sizeof name, "%s%c%s." LSN_PF,
+			 srv_log_archive_dir, OS_PATH_SEPARATOR,
+			 log_archive_file_stem, *it);
+		os_file_delete_if_exists(innodb_log_file_key, name, NULL);
+	}
+}
+
+/** Copy the redo log up to the last log write to the archive.
+@return	whether archiving can continue */
+static bool log_archive_follow_redo()
+{
+	log_write_mutex_enter();
+	const lsn_t	end_lsn = log_sys.write_lsn;
+	log_write_mutex_exit();
+
+	lsn_t		lsn = log_archive.archived_lsn;
+
+	while (lsn < end_lsn) {
+		const lsn_t	start_lsn = ut_uint64_align_down(
+			lsn, OS_FILE_LOG_BLOCK_SIZE);
+		ulint		len = ulint(std::min<lsn_t>(
+			ut_uint64_align_up(end_lsn, OS_FILE_LOG_BLOCK_SIZE)
+			- start_lsn, log_archive_read_size));
+
+		log_mutex_enter();
+		const lsn_t	offset = log_sys.log.calc_lsn_offset(
+			start_lsn);
+		const lsn_t	file_size = log_sys.log.file_size;
+		const lsn_t	checkpoint_lsn = log_sys.last_checkpoint_lsn;
+		log_mutex_exit();
+
+		if (offset % file_size + len > file_size) {
+			len = ulint(file_size - offset % file_size);
+		}
+
+		/* The block that contains end_lsn can be rewritten by
+		log_write_up_to() while we are reading it. */
+		ulint	valid = 0;
+
+		for (uint retries = 0; retries < 3 && !valid; retries++) {
+			valid = log_archive_read_blocks(start_lsn, offset,
+							len);
+		}
+
+		if (!valid) {
+			if (lsn >= checkpoint_lsn) {
+				ib::error() << "Cannot read the redo log at"
+					" LSN=" << lsn;
+				return false;
+			}
+
+			/* The log from before the restart was
+			overwritten or rebuilt. */
+			ib::warn() << "Cannot read the redo log at LSN="
+				<< lsn << "; the redo log archive will not"
+				" contain the LSN range " << lsn << " to "
+				<< checkpoint_lsn;
+			lsn = checkpoint_lsn;
+			continue;
+		}
+
+		if (!log_archive_write(log_archive.read_buf, valid,
+				       start_lsn)) {
+			return false;
+		}
+
+		lsn = std::min(start_lsn + valid, end_lsn);
+	}
+
+	if (log_archive.file != OS_FILE_CLOSED
+	    && !os_file_flush(log_archive.file)) {
+		return false;
+	}
+
+	log_archive.archived_lsn = lsn;
+	log_archive_purge();
+	return true;
+}
+
+/** The redo log archiving thread. Copies the written redo log to the
+archive every second, or when woken up by log_archive_wake(). */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(log_archive_thread)(void*)
+{
+	my_thread_init();
+
+	for (;;) {
+		/* The final pass must start after the final
+		checkpoint was written. */
+		const bool	stop = log_archive.stop;
+		const int64_t	sig = os_event_reset(log_archive.event);
+
+		if (!log_archive_follow_redo()) {
+			ib::error() << "Stopped archiving the redo log to "
+				<< srv_log_archive_dir << " at LSN="
+				<< log_archive.archived_lsn;
+			break;
+		}
+
+		os_event_set(log_archive.archived_event);
+
+		if (stop) {
+			break;
+		}
+
+		os_event_wait_time_low(log_archive.event, 1000000, sig);
+	}
+
+	log_archive.active = false;
+	os_event_set(log_archive.archived_event);
+
+	my_thread_end();
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Start the redo log archiving thread, if innodb_log_archive_dir is set.
+Archiving resumes at the end of the last segment if the redo log still
+contains that LSN, or starts at the latest log checkpoint. */
+void log_archive_create_thread()
+{
+	if (!srv_log_archive_dir) {
+		return;
+	}
+
+	ut_ad(log_archive.initialised);
+	ut_ad(srv_log_file_size);
+
+	log_mutex_enter();
+	lsn_t	lsn = log_sys.last_checkpoint_lsn;
+	if (log_archive.resume_lsn && log_archive.resume_lsn <= log_sys.lsn) {
+		lsn = log_archive.resume_lsn;
+	}
+	log_mutex_exit();
+
+	log_archive.archived_lsn = lsn;
+	log_archive.active = true;
+	os_thread_create(log_archive_thread, NULL, NULL);
+}
+
+/** Determine how far the redo log archiving is behind.
+@param[in]	lsn	the current LSN
+@return	the number of bytes of redo log that have not been archived,
+or 0 if the redo log archiving is not active */
+lsn_t log_archive_age(lsn_t lsn)
+{
+	return log_archive.active ? lsn - log_archive.archived_lsn : 0;
+}
+
+/** Wake up the redo log archiving thread. */
+void log_archive_wake()
+{
+	if (log_archive.active) {
+		os_event_set(log_archive.event);
+	}
+}
+
+/** Wait for the redo log to be archived up to the last log write. */
+void log_archive_follow_wait()
+{
+	log_write_mutex_enter();
+	const lsn_t	lsn = log_sys.write_lsn;
+	log_write_mutex_exit();
+
+	while (log_archive.active && log_archive.archived_lsn < lsn) {
+		const int64_t	sig = os_event_reset(
+			log_archive.archived_event);
+
+		if (!log_archive.active || log_archive.archived_lsn >= lsn) {
+			break;
+		}
+
+		os_event_set(log_archive.event);
+		os_event_wait_low(log_archive.archived_event, sig);
+	}
+}
+
+/** Archive the redo log up to the last log write,
+and stop the redo log archiving thread. */
+void log_archive_shutdown()
+{
+	if (!log_archive.active) {
+		return;
+	}
+
+	log_archive.stop = true;
+	os_event_set(log_archive.event);
+
+	while (log_archive.active) {
+		const int64_t	sig = os_event_reset(
+			log_archive.archived_event);
+
+		if (!log_archive.active) {
+			break;
+		}
+
+		os_event_wait_low(log_archive.archived_event, sig);
+	}
+}
+
+/** Close the redo log archiving at shutdown. */
+void log_archive_close()
+{
+	if (!log_archive.initialised) {
+		return;
+	}
+
+	log_archive_shutdown();
+	log_archive_close_segment();
+	os_event_destroy(log_archive.event);
+	os_event_destroy(log_archive.archived_event);
+	ut_free(log_archive.read_buf_unaligned);
+	log_archive.initialised = false;
+}
@@ -37,6 +37,8 @@ Created 12/9/1995 Heikki Tuuri
 
 #include "log0log.h"
 #include "log0crypt.h"
+#include "log0online.h"
+#include "log0arch.h"
 #include "mem0mem.h"
 #include "buf0buf.h"
 #include "buf0flu.h"
@@ -513,6 +515,13 @@ log_close(void)
 		}
 	}
 
+	if (log_online_age(lsn) > log_sys.max_checkpoint_age_async
+	    || log_archive_age(lsn) > log_sys.max_checkpoint_age_async) {
+		/* The changed page tracking and the redo log archiving
+		must read the log before it is overwritten. */
+		log_sys.check_flush_or_checkpoint = true;
+	}
+
 	if (checkpoint_age <= log_sys.max_modified_age_sync) {
 		goto function_exit;
 	}
@@ -1609,6 +1618,17 @@ log_checkpoint_margin(void)
 		log_sys.check_flush_or_checkpoint = false;
 	}
 
+	const lsn_t	tracking_age = log_online_age(log_sys.lsn);
+	const bool	tracking_sync = tracking_age
+		> log_sys.max_checkpoint_age;
+	const lsn_t	archive_age = log_archive_age(log_sys.lsn);
+	const bool	archive_sync = archive_age
+		> log_sys.max_checkpoint_age;
+
+	if (tracking_sync || archive_sync) {
+		log_sys.check_flush_or_checkpoint = true;
+	}
+
 	log_mutex_exit();
 
 	if (advance) {
@@ -1635,6 +1655,23 @@ log_checkpoint_margin(void)
 			goto loop;
 		}
 	}
+
+	if (tracking_sync) {
+		/* The log could be overwritten before the changed page
+		tracking has read it: wait for it synchronously */
+		log_online_follow_wait();
+		goto loop;
+	} else if (tracking_age > log_sys.max_checkpoint_age_async) {
+		log_online_wake();
+	}
+
+	if (archive_sync) {
+		/* The log could be overwritten before it is archived */
+		log_archive_follow_wait();
+		goto loop;
+	} else if (archive_age > log_sys.max_checkpoint_age_async) {
+		log_archive_wake();
+	}
 }
 
 /**
@@ -1866,6 +1903,8 @@ logs_empty_and_mark_files_at_shutdown(void)
 			log_buffer_flush_to_disk();
 		}
 
+		log_online_shutdown();
+		log_archive_shutdown();
 		srv_shutdown_state = SRV_SHUTDOWN_LAST_PHASE;
 
 		if (fil_system.is_initialised()) {
@@ -1895,6 +1934,13 @@ logs_empty_and_mark_files_at_shutdown(void)
 		/* Ensure that all buffered changes are written to the
 		redo log before fil_close_all_files(). */
 		fil_flush_file_spaces(FIL_TYPE_LOG);
+
+		/* Cover the shutdown LSN in the changed page bitmaps,
+		so that tracking can continue seamlessly on restart. */
+		log_online_shutdown();
+		/* Archive the log up to the shutdown LSN, for the same
+		reason. */
+		log_archive_shutdown();
 	} else {
 		lsn = srv_start_lsn;
 	}
@@ -0,0 +1,787 @@
+/*****************************************************************************
+
+Copyright (c) 2011-2012, Percona Inc. All Rights Reserved.
+Copyright (c) 2019, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file log/log0online.cc
+Changed page tracking for incremental backups.
+
+Like the XtraDB changed page tracking, a background thread parses the
+redo log up to the latest log checkpoint and sets a bit for every page
+that a log record refers to. Because every page that was modified before
+the checkpoint LSN has been written to the redo log before that LSN, the
+bitmap blocks can then be written out as one run covering the LSN range
+from the previous run to the checkpoint. Nothing is done when a
+mini-transaction is committed; log_check_margins() only waits for the
+thread if it falls so far behind that the log would be overwritten
+before it was read.
+*******************************************************/
+
+#include "log0online.h"
+#include "buf0buf.h"
+#include "log0log.h"
+#include "log0crypt.h"
+#include "log0recv.h"
+#include "fil0fil.h"
+#include "mach0data.h"
+#include "os0file.h"
+#include "os0thread.h"
+#include "srv0srv.h"
+#include "fsp0types.h"
+#include "ut0new.h"
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+/** File name stem of the bitmap files */
+static const char log_online_file_stem[] = "ib_modified_log_";
+
+/** Size after which a new bitmap file is started */
+static const os_offset_t log_online_max_file_size = 100 << 20;
+
+/** The bitmap file block size in bytes. All writes are multiples of this. */
+enum { MODIFIED_PAGE_BLOCK_SIZE = 4096 };
+
+/** Offsets in a bitmap block */
+enum {
+	/** 1 if last block in the current run, 0 otherwise */
+	MODIFIED_PAGE_IS_LAST_BLOCK = 0,
+	/** The starting tracked LSN of this and the other blocks of the run */
+	MODIFIED_PAGE_START_LSN = 4,
+	/** The ending tracked LSN of this and the other blocks of the run */
+	MODIFIED_PAGE_END_LSN = 12,
+	/** The space ID of the tracked pages in this block */
+	MODIFIED_PAGE_SPACE_ID = 20,
+	/** The page number of the first tracked page in this block */
+	MODIFIED_PAGE_1ST_PAGE_ID = 24,
+	/** Start of the bitmap itself */
+	MODIFIED_PAGE_BLOCK_BITMAP = 32,
+	/** Unused, to align the end of the bitmap at 8 bytes */
+	MODIFIED_PAGE_BLOCK_UNUSED_2 = MODIFIED_PAGE_BLOCK_SIZE - 8,
+	/** The checksum of the block */
+	MODIFIED_PAGE_BLOCK_CHECKSUM = MODIFIED_PAGE_BLOCK_SIZE - 4
+};
+
+/** Number of pages that are covered by one block */
+enum { MODIFIED_PAGE_BLOCK_ID_COUNT
+       = (MODIFIED_PAGE_BLOCK_UNUSED_2 - MODIFIED_PAGE_BLOCK_BITMAP) * 8 };
+
+
+/** Bitmap blocks of the pages modified since the last run, ordered by
+(space id, first page number). Only the space id, the first page number
+and the bitmap of each block are filled in. */
+typedef std::map<
+	ib_uint64_t, byte*, std::less<ib_uint64_t>,
+	ut_allocator<std::pair<const ib_uint64_t, byte*> > >
+	log_online_blocks_t;
+
+/** Size of a redo log read, in bytes. A log record is never longer. */
+static const ulint log_online_read_size = 1 << 20;
+
+/** The changed page tracker */
+static struct
+{
+	/** whether log_online_init() was completed */
+	bool			initialised;
+	/** whether log_online_thread is running */
+	std::atomic<bool>	active;
+	/** whether log_online_thread should exit after a final pass */
+	std::atomic<bool>	stop;
+	/** wakes up log_online_thread */
+	os_event_t		event;
+	/** set by log_online_thread after each pass */
+	os_event_t		tracked_event;
+	/** end LSN of the last written run */
+	std::atomic<lsn_t>	tracked_lsn;
+	/** end LSN of the last run that was found by log_online_init(),
+	or 0 */
+	lsn_t			resume_lsn;
+
+	/* The following are only accessed by log_online_thread
+	while it is active. */
+
+	/** pages modified between tracked_lsn and read_lsn */
+	log_online_blocks_t	blocks;
+	/** LSN up to which the redo log has been copied to parse_buf */
+	lsn_t			read_lsn;
+	/** memory for read_buf */
+	byte*			read_buf_unaligned;
+	/** buffer for redo log reads, of log_online_read_size bytes */
+	byte*			read_buf;
+	/** payload of the log blocks that has not been parsed, of
+	2 * log_online_read_size bytes */
+	byte*			parse_buf;
+	/** number of bytes in parse_buf */
+	ulint			parse_len;
+	/** directory of the bitmap files, without a trailing separator */
+	char			dir[OS_FILE_MAX_PATH];
+	/** sequence number of the last bitmap file */
+	ulong			seq_num;
+	/** the bitmap file being written, or OS_FILE_CLOSED */
+	pfs_os_file_t		file;
+	/** name of file */
+	char			name[OS_FILE_MAX_PATH];
+	/** size of file */
+	os_offset_t		offset;
+} log_online;
+
+/** Calculate a bitmap block checksum, like log_block_calc_checksum().
+@param[in]	block	bitmap block
+@return checksum */
+static ulint log_online_calc_checksum(const byte* block)
+{
+	ulint	sum = 1;
+	ulint	sh = 0;
+
+	for (ulint i = 0; i < MODIFIED_PAGE_BLOCK_CHECKSUM; i++) {
+		ulint	b = block[i];
+		sum &= 0x7FFFFFFFUL;
+		sum += b;
+		sum += b << sh;
+		if (++sh > 24) {
+			sh = 0;
+		}
+	}
+
+	return sum;
+}
+
+/** Free the bitmap blocks that are being collected. */
+static void log_online_free_blocks()
+{
+	for (log_online_blocks_t::iterator it = log_online.blocks.begin();
+	     it != log_online.blocks.end(); ++it) {
+		ut_free(it->second);
+	}
+
+	log_online.blocks.clear();
+}
+
+/** Read the end LSN of the last run in the last bitmap file.
+@return	the end LSN, or 0 if the file cannot be read */
+static lsn_t log_online_read_resume_lsn()
+{
+	bool		success;
+	pfs_os_file_t	file = os_file_create_simple_no_error_handling(
+		innodb_log_file_key, log_online.name, OS_FILE_OPEN,
+		OS_FILE_READ_ONLY, true, &success);
+
+	if (!success) {
+		return 0;
+	}
+
+	lsn_t		lsn = 0;
+	const os_offset_t size = os_file_get_size(file);
+	byte*		block = static_cast<byte*>(
+		ut_malloc_nokey(MODIFIED_PAGE_BLOCK_SIZE));
+
+	if (size != os_offset_t(-1) && size >= MODIFIED_PAGE_BLOCK_SIZE
+	    && os_file_read(IORequestRead, file, block,
+			    ut_uint64_align_down(size,
+						 MODIFIED_PAGE_BLOCK_SIZE)
+			    - MODIFIED_PAGE_BLOCK_SIZE,
+			    MODIFIED_PAGE_BLOCK_SIZE) == DB_SUCCESS
+	    && mach_read_from_4(block + MODIFIED_PAGE_IS_LAST_BLOCK)
+	    && mach_read_from_4(block + MODIFIED_PAGE_BLOCK_CHECKSUM)
+	    == log_online_calc_checksum(block)) {
+		lsn = mach_read_from_8(block + MODIFIED_PAGE_END_LSN);
+	}
+
+	ut_free(block);
+	os_file_close(file);
+	return lsn;
+}
+
+/** Initialize the changed page tracking, before crash recovery is started.
+Does nothing unless innodb_track_changed_pages is set. */
+void log_online_init()
+{
+	ut_ad(!log_online.initialised);
+
+	if (!srv_track_changed_pages) {
+		return;
+	}
+
+	if (srv_read_only_mode || srv_operation != SRV_OPERATION_NORMAL) {
+		srv_track_changed_pages = FALSE;
+		return;
+	}
+
+	size_t	len = strlen(srv_data_home);
+
+	while (len > 1 && srv_data_home[len - 1] == OS_PATH_SEPARATOR) {
+		len--;
+	}
+
+	if (!len) {
+		strcpy(log_online.dir, ".");
+	} else {
+		snprintf(log_online.dir, sizeof log_online.dir, "%.*s",
+			 int(len), srv_data_home);
+	}
+
+	/* Continue the sequence numbers of the existing bitmap files,
+	and the LSN range of the last run. */
+	log_online.seq_num = 0;
+	log_online.resume_lsn = 0;
+
+	if (os_file_dir_t dir = os_file_opendir(log_online.dir, false)) {
+		os_file_stat_t	info;
+
+		while (!os_file_readdir_next_file(log_online.dir, dir,
+						  &info)) {
+			char	stem[sizeof log_online_file_stem];
+			ulong	seq_num;
+			lsn_t	lsn;
+
+			if (sscanf(info.name, "%16[a-z_]%lu_" LSN_PF ".xdb",
+				   stem, &seq_num, &lsn) == 3
+			    && !strcmp(stem, log_online_file_stem)
+			    && seq_num > log_online.seq_num) {
+				log_online.seq_num = seq_num;
+				snprintf(log_online.name,
+					 sizeof log_online.name, "%s%c%s",
+					 log_online.dir, OS_PATH_SEPARATOR,
+					 info.name);
+			}
+		}
+
+		os_file_closedir(dir);
+	}
+
+	if (log_online.seq_num) {
+		log_online.resume_lsn = log_online_read_resume_lsn();
+	}
+
+	log_online.event = os_event_create(0);
+	log_online.tracked_event = os_event_create(0);
+	log_online.read_buf_unaligned = static_cast<byte*>(
+		ut_malloc_nokey(log_online_read_size + srv_page_size));
+	log_online.read_buf = static_cast<byte*>(
+		ut_align(log_online.read_buf_unaligned, srv_page_size));
+	log_online.parse_buf = static_cast<byte*>(
+		ut_malloc_nokey(2 * log_online_read_size));
+	log_online.parse_len = 0;
+	log_online.tracked_lsn = 0;
+	log_online.read_lsn = 0;
+	log_online.active = false;
+	log_online.stop = false;
+	log_online.file = OS_FILE_CLOSED;
+	log_online.offset = 0;
+	log_online.initialised = true;
+}
+
+/** Set the LSN from which the changed pages are being tracked.
+If the last run ended before it, the tracking resumes from there.
+@param[in]	lsn	the checkpoint LSN from which crash recovery starts */
+void log_online_start(lsn_t lsn)
+{
+	if (srv_track_changed_pages) {
+		ut_ad(log_online.initialised);
+
+		if (log_online.resume_lsn && log_online.resume_lsn <= lsn) {
+			lsn = log_online.resume_lsn;
+		}
+
+		log_online.tracked_lsn = lsn;
+		log_online.read_lsn = lsn;
+	}
+}
+
+/** Note that a page was modified.
+@param[in]	space	tablespace identifier
+@param[in]	page_no	page number */
+static void log_online_note_page(ulint space, ulint page_no)
+{
+	if (fsp_is_system_temporary(space)) {
+		return;
+	}
+
+	const ulint		bit = page_no % MODIFIED_PAGE_BLOCK_ID_COUNT;
+	const ib_uint64_t	key = ib_uint64_t(space) << 32
+		| page_no / MODIFIED_PAGE_BLOCK_ID_COUNT;
+
+	byte*&	b = log_online.blocks[key];
+
+	if (!b) {
+		b = static_cast<byte*>(
+			ut_zalloc_nokey(MODIFIED_PAGE_BLOCK_SIZE));
+		mach_write_to_4(b + MODIFIED_PAGE_SPACE_ID, space);
+		mach_write_to_4(b + MODIFIED_PAGE_1ST_PAGE_ID, page_no - bit);
+	}
+
+	reinterpret_cast<ib_uint64_t*>(b + MODIFIED_PAGE_BLOCK_BITMAP)
+		[bit >> 6] |= 1ULL << (bit & 63);
+}
+
+/** Note the pages of the complete log records in parse_buf,
+and keep the incomplete last record there.
+@return	whether the log records could be parsed */
+static bool log_online_parse()
+{
+	byte*		ptr = log_online.parse_buf;
+	byte* const	end = ptr + log_online.parse_len;
+	mlog_id_t	type = MLOG_DUMMY_RECORD;
+	ulint		space = 0;
+	ulint		page_no = 0;
+
+	/* recv_parse_log_rec_page_id() can flag a corrupted record in
+	recv_sys->found_corrupt_log, which belongs to crash recovery.
+	Keep that as it was, and only note the failure here. */
+	const bool	found_corrupt_log = recv_sys->found_corrupt_log;
+	recv_sys->found_corrupt_log = false;
+
+	while (ulint len = recv_parse_log_rec_page_id(ptr, end, &type,
+						      &space, &page_no)) {
+		switch (type) {
+		case MLOG_MULTI_REC_END:
+		case MLOG_DUMMY_RECORD:
+		case MLOG_CHECKPOINT:
+		case MLOG_FILE_NAME:
+		case MLOG_FILE_DELETE:
+		case MLOG_FILE_CREATE2:
+		case MLOG_FILE_RENAME2:
+			break;
+		default:
+			log_online_note_page(space, page_no);
+		}
+
+		ptr += len;
+	}
+
+	const bool	corrupt = recv_sys->found_corrupt_log;
+	recv_sys->found_corrupt_log = found_corrupt_log;
+
+	log_online.parse_len = ulint(end - ptr);
+	memmove(log_online.parse_buf, ptr, log_online.parse_len);
+
+	/* If the incomplete record is longer than any log record can be,
+	the log is corrupted. */
+	return !corrupt && log_online.parse_len < log_online_read_size;
+}
+
+/** Read log blocks to read_buf, and decrypt them.
+@param[in]	start_lsn	LSN of the first block
+@param[in]	offset		file offset of start_lsn
+@param[in]	len		number of bytes to read
+@return	whether the blocks were valid */
+static bool log_online_read_blocks(lsn_t start_lsn, lsn_t offset, ulint len)
+{
+	byte*	buf = log_online.read_buf;
+
+	if (fil_io(IORequestLogRead, true,
+		   page_id_t(SRV_LOG_SPACE_FIRST_ID,
+			     ulint(offset >> srv_page_size_shift)),
+		   0, ulint(offset & (srv_page_size - 1)), len, buf, NULL)
+	    != DB_SUCCESS) {
+		return false;
+	}
+
+	for (ulint l = 0; l < len; l += OS_FILE_LOG_BLOCK_SIZE,
+		     buf += OS_FILE_LOG_BLOCK_SIZE) {
+		const lsn_t	lsn = start_lsn + l;
+
+		if (log_block_get_hdr_no(buf)
+		    != log_block_convert_lsn_to_no(lsn)) {
+			return false;
+		}
+
+		if ((innodb_log_checksums || log_sys.is_encrypted())
+		    && log_block_calc_checksum_crc32(buf)
+		    != log_block_get_checksum(buf)) {
+			return false;
+		}
+
+		if (log_sys.is_encrypted()
+		    && !log_crypt(buf, lsn, OS_FILE_LOG_BLOCK_SIZE,
+				  LOG_DECRYPT)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/** Read and parse the redo log up to an LSN.
+@param[in]	end_lsn	the latest checkpoint LSN
+@return	whether the log was parsed up to end_lsn */
+static bool log_online_read(lsn_t end_lsn)
+{
+	while (log_online.read_lsn < end_lsn) {
+		const lsn_t	start_lsn = ut_uint64_align_down(
+			log_online.read_lsn, OS_FILE_LOG_BLOCK_SIZE);
+		ulint		len = ulint(std::min<lsn_t>(
+			ut_uint64_align_up(end_lsn, OS_FILE_LOG_BLOCK_SIZE)
+			- start_lsn, log_online_read_size));
+
+		log_mutex_enter();
+		const lsn_t	offset = log_sys.log.calc_lsn_offset(
+			start_lsn);
+		const lsn_t	file_size = log_sys.log.file_size;
+		log_mutex_exit();
+
+		if (offset % file_size + len > file_size) {
+			len = ulint(file_size - offset % file_size);
+		}
+
+		/* The block that contains end_lsn can be rewritten by
+		log_write_up_to() while we are reading it. */
+		for (uint retries = 0;
+		     !log_online_read_blocks(start_lsn, offset, len); ) {
+			if (++retries == 3) {
+				return false;
+			}
+		}
+
+		const byte*	buf = log_online.read_buf;
+
+		for (ulint l = 0; l < len; l += OS_FILE_LOG_BLOCK_SIZE,
+			     buf += OS_FILE_LOG_BLOCK_SIZE) {
+			const lsn_t	lsn = start_lsn + l;
+			ulint		from = LOG_BLOCK_HDR_SIZE;
+			ulint		to = log_sys.trailer_offset();
+
+			if (log_online.read_lsn > lsn + from) {
+				from = ulint(log_online.read_lsn - lsn);
+			}
+
+			if (end_lsn < lsn + to) {
+				to = ulint(end_lsn - lsn);
+			}
+
+			if (from < to) {
+				memcpy(log_online.parse_buf
+				       + log_online.parse_len,
+				       buf + from, to - from);
+				log_online.parse_len += to - from;
+			}
+		}
+
+		log_online.read_lsn = std::min(start_lsn + len, end_lsn);
+
+		if (!log_online_parse()) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/** Append a run of bitmap blocks to the current bitmap file.
+@param[in]	buf		bitmap blocks
+@param[in]	len		length of buf in bytes
+@param[in]	start_lsn	start LSN of the run
+@return whether the run was durably written */
+static bool log_online_write(const byte* buf, ulint len, lsn_t start_lsn)
+{
+	if (log_online.file != OS_FILE_CLOSED
+	    && log_online.offset >= log_online_max_file_size) {
+		os_file_close(log_online.file);
+		log_online.file = OS_FILE_CLOSED;
+	}
+
+	if (log_online.file == OS_FILE_CLOSED) {
+		bool	success;
+
+		snprintf(log_online.name, sizeof log_online.name,
+			 "%s%c%s%lu_" LSN_PF ".xdb",
+			 log_online.dir, OS_PATH_SEPARATOR,
+			 log_online_file_stem, ++log_online.seq_num,
+			 start_lsn);
+
+		log_online.file = os_file_create_simple_no_error_handling(
+			innodb_log_file_key, log_online.name,
+			OS_FILE_CREATE, OS_FILE_READ_WRITE, false, &success);
+
+		if (!success) {
+			log_online.file = OS_FILE_CLOSED;
+			ib::error() << "Cannot create changed page bitmap "
+				<< log_online.name;
+			return false;
+		}
+
+		log_online.offset = 0;
+	}
+
+	if (os_file_write(IORequestWrite, log_online.name, log_online.file,
+			  buf, log_online.offset, len) != DB_SUCCESS
+	    || !os_file_flush(log_online.file)) {
+		return false;
+	}
+
+	log_online.offset += len;
+	return true;
+}
+
+/** Delete the bitmap files before the current one that were last
+written more than innodb_track_changed_pages_expire_sec seconds ago.
+An incremental backup that needs an LSN range of a deleted file will
+find it missing and fall back to a full scan. */
+static void log_online_purge()
+{
+	if (!srv_track_changed_pages_expire_sec) {
+		return;
+	}
+
+	os_file_dir_t	dir = os_file_opendir(log_online.dir, false);
+
+	if (!dir) {
+		return;
+	}
+
+	std::vector<std::string>	expired;
+	const time_t			now = time(NULL);
+	os_file_stat_t			info;
+
+	while (!os_file_readdir_next_file(log_online.dir, dir, &info)) {
+		char		stem[sizeof log_online_file_stem];
+		ulong		seq_num;
+		lsn_t		lsn;
+		os_file_stat_t	stat_info;
+		char		name[OS_FILE_MAX_PATH];
+
+		if (info.type != OS_FILE_TYPE_FILE
+		    || sscanf(info.name, "%16[a-z_]%lu_" LSN_PF ".xdb",
+			      stem, &seq_num, &lsn) != 3
+		    || strcmp(stem, log_online_file_stem)
+		    || seq_num >= log_online.seq_num) {
+			continue;
+		}
+
+		snprintf(name, sizeof name, "%s%c%s",
+			 log_online.dir, OS_PATH_SEPARATOR, info.name);
+
+		if (os_file_get_status(name, &stat_info, false, true)
+		    == DB_SUCCESS
+		    && difftime(now, stat_info.mtime)
+		    >= double(srv_track_changed_pages_expire_sec)) {
+			expired.push_back(name);
+		}
+	}
+
+	os_file_closedir(dir);
+
+	for (std::vector<std::string>::const_iterator it = expired.begin();
+	     it != expired.end(); ++it) {
+		os_file_delete_if_exists(innodb_log_file_key, it->c_str(),
+					 NULL);
+	}
+}
+
+/** Parse the redo log up to the latest log checkpoint, and write
+the changed page bitmaps as a run up to that LSN. */
+static void log_online_follow_redo()
+{
+	log_mutex_enter();
+	const lsn_t	end_lsn = log_sys.last_checkpoint_lsn;
+	log_mutex_exit();
+
+	const lsn_t	start_lsn = log_online.tracked_lsn;
+
+	if (end_lsn <= start_lsn) {
+		return;
+	}
+
+	if (!log_online_read(end_lsn)) {
+		/* The next run will start at end_lsn. mariabackup
+		--incremental will detect the missing LSN range and
+		fall back to a full scan. */
+		ib::warn() << "Cannot parse the redo log at LSN="
+			<< log_online.read_lsn
+			<< "; the changed page bitmaps will not cover"
+			" the LSN range " << start_lsn << " to " << end_lsn;
+		log_online_free_blocks();
+		log_online.parse_len = 0;
+		log_online.read_lsn = end_lsn;
+		log_online.tracked_lsn = end_lsn;
+		return;
+	}
+
+	/* An empty run still consists of one block, with no bits set,
+	so that the LSN range is covered. */
+	const ulint	n = std::max<ulint>(log_online.blocks.size(), 1);
+	byte*		buf = static_cast<byte*>(
+		ut_zalloc_nokey(n * MODIFIED_PAGE_BLOCK_SIZE));
+	byte*		b = buf;
+
+	for (log_online_blocks_t::const_iterator it
+		     = log_online.blocks.begin();
+	     it != log_online.blocks.end(); ++it) {
+		memcpy(b, it->second, MODIFIED_PAGE_BLOCK_SIZE);
+		b += MODIFIED_PAGE_BLOCK_SIZE;
+	}
+
+	log_online_free_blocks();
+
+	const byte*	end = buf + n * MODIFIED_PAGE_BLOCK_SIZE;
+
+	for (b = buf; b < end; b += MODIFIED_PAGE_BLOCK_SIZE) {
+		mach_write_to_4(b + MODIFIED_PAGE_IS_LAST_BLOCK,
+				b + MODIFIED_PAGE_BLOCK_SIZE == end);
+		mach_write_to_8(b + MODIFIED_PAGE_START_LSN, start_lsn);
+		mach_write_to_8(b + MODIFIED_PAGE_END_LSN, end_lsn);
+		mach_write_to_4(b + MODIFIED_PAGE_BLOCK_CHECKSUM,
+				log_online_calc_checksum(b));
+	}
+
+	const bool	success = log_online_write(
+		buf, n * MODIFIED_PAGE_BLOCK_SIZE, start_lsn);
+
+	ut_free(buf);
+
+	if (!success) {
+		/* The next run would not continue the previous one.
+		Stop tracking, so that incremental backups will detect
+		the missing LSN range and fall back to a full scan. */
+		ib::error() << "Stopped tracking changed pages at LSN="
+			<< start_lsn;
+		srv_track_changed_pages = FALSE;
+	}
+
+	log_online.tracked_lsn = end_lsn;
+}
+
+/** The changed page tracking thread. Writes a run of bitmap blocks
+every second, or when woken up by log_online_follow_wait(). */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(log_online_thread)(void*)
+{
+	my_thread_init();
+
+	while (srv_track_changed_pages) {
+		/* The final pass must start after the final
+		checkpoint was made. */
+		const bool	stop = log_online.stop;
+		const int64_t	sig = os_event_reset(log_online.event);
+
+		log_online_follow_redo();
+		os_event_set(log_online.tracked_event);
+		log_online_purge();
+
+		if (stop) {
+			break;
+		}
+
+		os_event_wait_time_low(log_online.event, 1000000, sig);
+	}
+
+	log_online.active = false;
+	os_event_set(log_online.tracked_event);
+
+	my_thread_end();
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Start the changed page tracking thread,
+if innodb_track_changed_pages is set. */
+void log_online_create_thread()
+{
+	if (srv_track_changed_pages) {
+		ut_ad(log_online.initialised);
+		log_online.active = true;
+		os_thread_create(log_online_thread, NULL, NULL);
+	}
+}
+
+/** Determine how far the changed page tracking is behind.
+@param[in]	lsn	the current LSN
+@return	the number of bytes of redo log that have not been tracked,
+or 0 if the changed page tracking is not active */
+lsn_t log_online_age(lsn_t lsn)
+{
+	return log_online.active ? lsn - log_online.tracked_lsn : 0;
+}
+
+/** Wake up the changed page tracking thread. */
+void log_online_wake()
+{
+	if (log_online.active) {
+		os_event_set(log_online.event);
+	}
+}
+
+/** Wait for the changed page bitmaps to be written up to
+the latest log checkpoint. */
+void log_online_follow_wait()
+{
+	log_mutex_enter();
+	const lsn_t	lsn = log_sys.last_checkpoint_lsn;
+	log_mutex_exit();
+
+	while (log_online.active && log_online.tracked_lsn < lsn) {
+		const int64_t	sig = os_event_reset(
+			log_online.tracked_event);
+
+		if (!log_online.active || log_online.tracked_lsn >= lsn) {
+			break;
+		}
+
+		os_event_set(log_online.event);
+		os_event_wait_low(log_online.tracked_event, sig);
+	}
+}
+
+/** Write the changed page bitmaps up to the latest log checkpoint,
+and stop the changed page tracking thread. */
+void log_online_shutdown()
+{
+	if (!log_online.active) {
+		return;
+	}
+
+	log_online.stop = true;
+	os_event_set(log_online.event);
+
+	while (log_online.active) {
+		const int64_t	sig = os_event_reset(
+			log_online.tracked_event);
+
+		if (!log_online.active) {
+			break;
+		}
+
+		os_event_wait_low(log_online.tracked_event, sig);
+	}
+}
+
+/** Close the changed page tracking at shutdown. */
+void log_online_close()
+{
+	if (!log_online.initialised) {
+		return;
+	}
+
+	log_online_shutdown();
+
+	if (log_online.file != OS_FILE_CLOSED) {
+		os_file_close(log_online.file);
+		log_online.file = OS_FILE_CLOSED;
+	}
+
+	log_online_free_blocks();
+	os_event_destroy(log_online.event);
+	os_event_destroy(log_online.tracked_event);
+	ut_free(log_online.read_buf_unaligned);
+	ut_free(log_online.parse_buf);
+	log_online.initialised = false;
+}
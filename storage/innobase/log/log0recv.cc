@@ -2278,6 +2278,96 @@ recv_parse_log_rec(
 	return ulint(new_ptr - ptr);
 }
 
+/** Parse the page identifier and the length of a redo log record, for
+the changed page tracking. Unlike recv_parse_log_rec(), this does not
+process any MLOG_FILE_ record.
+@param[in]	ptr	start of the record
+@param[in]	end_ptr	end of the buffer
+@param[out]	type	log record type
+@param[out]	space	tablespace identifier
+@param[out]	page_no	page number
+@return length of the record, or 0 if the record was not complete
+or it was corrupted */
+ulint
+recv_parse_log_rec_page_id(
+	byte*		ptr,
+	byte*		end_ptr,
+	mlog_id_t*	type,
+	ulint*		space,
+	ulint*		page_no)
+{
+	if (ptr == end_ptr) {
+		return(0);
+	}
+
+	switch (*ptr) {
+	case MLOG_MULTI_REC_END:
+	case MLOG_DUMMY_RECORD:
+		*type = static_cast<mlog_id_t>(*ptr);
+		return(1);
+	case MLOG_CHECKPOINT:
+		if (end_ptr < ptr + SIZE_OF_MLOG_CHECKPOINT) {
+			return(0);
+		}
+		*type = static_cast<mlog_id_t>(*ptr);
+		return(SIZE_OF_MLOG_CHECKPOINT);
+	case MLOG_MULTI_REC_END | MLOG_SINGLE_REC_FLAG:
+	case MLOG_DUMMY_RECORD | MLOG_SINGLE_REC_FLAG:
+	case MLOG_CHECKPOINT | MLOG_SINGLE_REC_FLAG:
+		return(0);
+	}
+
+	byte*	new_ptr = mlog_parse_initial_log_record(
+		ptr, end_ptr, type, space, page_no);
+
+	if (UNIV_UNLIKELY(!new_ptr)) {
+		return(0);
+	}
+
+	switch (*type) {
+#ifdef UNIV_LOG_LSN_DEBUG
+	case MLOG_LSN:
+		break;
+#endif /* UNIV_LOG_LSN_DEBUG */
+	case MLOG_FILE_CREATE2:
+		new_ptr += 4;
+		/* fall through */
+	case MLOG_FILE_NAME:
+	case MLOG_FILE_DELETE:
+	case MLOG_FILE_RENAME2:
+		for (ulint n = *type == MLOG_FILE_RENAME2 ? 2 : 1; n--; ) {
+			if (end_ptr < new_ptr + 2) {
+				return(0);
+			}
+			new_ptr += 2 + mach_read_from_2(new_ptr);
+		}
+		if (end_ptr < new_ptr) {
+			return(0);
+		}
+		break;
+	case MLOG_FILE_WRITE_CRYPT_DATA:
+		/* fil_parse_write_crypt_data() would replace the
+		crypt_data of the tablespace. */
+		if (end_ptr < new_ptr + 8) {
+			return(0);
+		}
+		new_ptr += 8 + 4 + 4 + 1 + mach_read_from_1(new_ptr + 7);
+		if (end_ptr < new_ptr) {
+			return(0);
+		}
+		break;
+	default:
+		new_ptr = recv_parse_or_apply_log_rec_body(
+			*type, new_ptr, end_ptr, *space, *page_no,
+			false, NULL, NULL);
+		if (UNIV_UNLIKELY(!new_ptr)) {
+			return(0);
+		}
+	}
+
+	return ulint(new_ptr - ptr);
+}
+
 /*******************************************************//**
 Calculates the new value for lsn when more data is added to the log. */
 static
@@ -1598,6 +1598,23 @@ page_cur_insert_rec_zip(
 			return(NULL);
 		}
 
+		if (!log_compressed && !recv_recovery_is_on()
+		    && page_zip_compress_is_futile(
+			    page_zip, page, index, rec_size)) {
+			/* Do not bother inserting the record and
+			compressing the page, only to restore the page
+			by decompressing it again. */
+			MONITOR_INC(MONITOR_PAGE_COMPRESS_SKIPPED);
+			if (srv_cmp_per_index_enabled) {
+				mutex_enter(&page_zip_stat_per_index_mutex);
+				page_zip_stat_per_index[index->id]
+					.compressed_skipped++;
+				mutex_exit(&page_zip_stat_per_index_mutex);
+			}
+			dict_index_zip_failure(index);
+			return(NULL);
+		}
+
 		/* Try compressing the whole page afterwards. */
 		insert_rec = page_cur_insert_rec_low(
 			cursor->rec, index, rec, offsets, NULL);
@@ -1592,6 +1592,57 @@ page_zip_compress(
 	return(TRUE);
 }
 
+/** Determine whether page_zip_compress() is bound to fail after
+inserting a record of the given size into a freshly compressed leaf
+page. The compressed stream is assumed to grow by the record size
+times the compression ratio of the page.
+@param[in]	page_zip	compressed page
+@param[in]	page		uncompressed page
+@param[in]	index		index of the B-tree node
+@param[in]	rec_size	size of the record that is to be inserted
+@return whether the compression should not be attempted */
+bool
+page_zip_compress_is_futile(
+	const page_zip_des_t*	page_zip,
+	const page_t*		page,
+	const dict_index_t*	index,
+	ulint			rec_size)
+{
+	if (!zip_failure_threshold_pct || !page_is_leaf(page)
+	    || page_get_n_recs(page) < 2) {
+		/* Keep the guess out of the way of page splits,
+		and let innodb_compression_failure_threshold_pct=0
+		disable it along with the adaptive padding. */
+		return false;
+	}
+
+	if (page_zip->m_nonempty) {
+		/* The stream size would include the modification log. */
+		return false;
+	}
+
+	const ulint n_dense = ulint(page_dir_get_n_heap(page))
+		- PAGE_HEAP_NO_USER_LOW + 1;
+	const ulint slot_size = dict_index_is_clust(index)
+		? PAGE_ZIP_DIR_SLOT_SIZE + DATA_TRX_ID_LEN + DATA_ROLL_PTR_LEN
+		: PAGE_ZIP_DIR_SLOT_SIZE;
+	const ulint reserved = PAGE_DATA + 1 + n_dense * slot_size
+		+ page_zip->n_blobs * BTR_EXTERN_FIELD_REF_SIZE;
+	const ulint zip_size = page_zip_get_size(page_zip);
+
+	if (reserved >= zip_size) {
+		return true;
+	}
+
+	const ulint payload = page_header_get_field(page, PAGE_HEAP_TOP)
+		- PAGE_ZIP_START;
+	const ulint stream = page_zip->m_end - PAGE_DATA;
+	const ulint growth = rec_size * stream / payload;
+
+	/* Allow for 1/4 of error in the estimated growth. */
+	return stream + growth * 3 / 4 > zip_size - reserved;
+}
+
 /**********************************************************************//**
 Deallocate the index information initialized by page_zip_fields_decode(). */
 static
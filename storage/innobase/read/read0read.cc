@@ -267,6 +267,34 @@ void ReadView::open(trx_t *trx)
 }
 
 
+/**
+  Opens a read view that sees exactly what another open view sees.
+
+  The other view belongs to a transaction whose thread waits for this
+  one, so it cannot change meanwhile.
+
+  @param[in] other  open view of another transaction
+*/
+void ReadView::open_as(const ReadView &other)
+{
+  ut_ad(&other != this);
+  ut_ad(state() == READ_VIEW_STATE_CLOSED);
+  ut_ad(other.get_state() == READ_VIEW_STATE_OPEN);
+
+  /* See ReadView::open() */
+  mutex_enter(&trx_sys.mutex);
+  mutex_exit(&trx_sys.mutex);
+  m_state.store(READ_VIEW_STATE_SNAPSHOT, std::memory_order_relaxed);
+
+  m_ids= other.m_ids;
+  m_low_limit_id= other.m_low_limit_id;
+  m_up_limit_id= other.m_up_limit_id;
+  m_low_limit_no= other.m_low_limit_no;
+  m_creator_trx_id= other.m_creator_trx_id;
+  m_state.store(READ_VIEW_STATE_OPEN, std::memory_order_release);
+}
+
+
 /**
   Clones the oldest view and stores it in view.
 
@@ -29,6 +29,7 @@ Completed by Sunny Bains and Marko Makela
 #include <sql_class.h>
 
 #include <math.h>
+#include <algorithm>
 
 #include "row0merge.h"
 #include "row0ext.h"
@@ -107,9 +108,82 @@ class index_tuple_info_t {
 
 		ut_ad(dtuple);
 
+		/* The fields may point to the clustered index page.
+		Copy them, so that the rows can be kept across pages
+		and inserted in a better order. */
+		dtuple = dtuple_copy(dtuple, m_heap);
+
+		for (ulint i = 0; i < dtuple_get_n_fields(dtuple); i++) {
+			dfield_dup(dtuple_get_nth_field(dtuple, i), m_heap);
+		}
+
 		m_dtuple_vec->push_back(dtuple);
 	}
 
+	/** Sort the cached rows in Sort-Tile-Recursive order: cut the
+	rows sorted by the x of the MBR center into vertical slabs of
+	about sqrt(leaf pages) leaf pages each, and sort each slab by y.
+	Inserting in this order fills each R-tree leaf with neighbouring
+	rows, instead of spreading overlapping MBRs over all leaves. */
+	void sort() UNIV_NOTHROW
+	{
+		const ulint	n = m_dtuple_vec->size();
+
+		if (n < 2) {
+			return;
+		}
+
+		struct str_key_t {
+			double		x;
+			double		y;
+			dtuple_t*	tuple;
+		};
+
+		std::vector<str_key_t, ut_allocator<str_key_t> >	keys;
+		keys.reserve(n);
+
+		for (idx_tuple_vec::const_iterator it = m_dtuple_vec->begin();
+		     it != m_dtuple_vec->end(); ++it) {
+			rtr_mbr_t	mbr;
+			rtr_get_mbr_from_tuple(*it, &mbr);
+			str_key_t	key = {
+				(mbr.xmin + mbr.xmax) / 2,
+				(mbr.ymin + mbr.ymax) / 2,
+				*it
+			};
+			keys.push_back(key);
+		}
+
+		/* R-tree pages are typically half full after splits. */
+		const ulint	per_leaf = std::max<ulint>(
+			1, srv_page_size / 2
+			/ (dtuple_get_data_size(keys[0].tuple, 0)
+			   + REC_N_NEW_EXTRA_BYTES + PAGE_DIR_SLOT_SIZE));
+		const ulint	n_slabs = ulint(ceil(sqrt(
+			double((n + per_leaf - 1) / per_leaf))));
+		const ulint	slab = (n + n_slabs - 1) / n_slabs;
+
+		std::sort(keys.begin(), keys.end(),
+			  [](const str_key_t& a, const str_key_t& b)
+			  { return a.x < b.x; });
+
+		for (ulint i = 0; i < n; i += slab) {
+			/* Walk every other slab downwards, so that the
+			last row of a slab is next to the first row of
+			the next one. */
+			const bool	down = (i / slab) & 1;
+			std::sort(keys.begin() + i,
+				  keys.begin() + std::min(n, i + slab),
+				  [down](const str_key_t& a,
+					 const str_key_t& b)
+				  { return down ? b.y < a.y : a.y < b.y; });
+		}
+
+		for (ulint i = 0; i < n; i++) {
+			(*m_dtuple_vec)[i] = keys[i].tuple;
+		}
+	}
+
 	/** Insert spatial index rows cached in vector into spatial index
 	@param[in]	trx_id		transaction id
 	@param[in,out]	row_heap	memory heap
@@ -137,6 +211,8 @@ class index_tuple_info_t {
 
 		ut_ad(dict_index_is_spatial(m_index));
 
+		sort();
+
 		DBUG_EXECUTE_IF("row_merge_instrument_log_check_flush",
 			log_sys.check_flush_or_checkpoint = true;
 		);
@@ -1586,6 +1662,9 @@ row_mtuple_cmp(
 @param[in,out]	sp_heap		heap for tuples
 @param[in,out]	pcur		cluster index cursor
 @param[in,out]	mtr		mini transaction
+@param[in]	flush_all	whether to insert the rows even if
+				fewer than innodb_sort_buffer_size
+				bytes of them have been cached
 @return DB_SUCCESS or error number */
 static
 dberr_t
@@ -1596,7 +1675,8 @@ row_merge_spatial_rows(
 	mem_heap_t*		row_heap,
 	mem_heap_t*		sp_heap,
 	btr_pcur_t*		pcur,
-	mtr_t*			mtr)
+	mtr_t*			mtr,
+	bool			flush_all)
 {
 	dberr_t			err = DB_SUCCESS;
 
@@ -1606,6 +1686,12 @@ row_merge_spatial_rows(
 
 	ut_ad(sp_heap != NULL);
 
+	if (!flush_all && mem_heap_get_size(sp_heap) < srv_sort_buf_size) {
+		/* Keep collecting rows, so that they can be sorted
+		into a better insert order. */
+		return(DB_SUCCESS);
+	}
+
 	for (ulint j = 0; j < num_spatial; j++) {
 		err = sp_tuples[j]->insert(trx_id, row_heap, pcur, mtr);
 
@@ -1966,7 +2052,7 @@ row_merge_read_clustered_index(
 			/* Insert the cached spatial index rows. */
 			err = row_merge_spatial_rows(
 				trx->id, sp_tuples, num_spatial,
-				row_heap, sp_heap, &pcur, &mtr);
+				row_heap, sp_heap, &pcur, &mtr, false);
 
 			if (err != DB_SUCCESS) {
 				goto func_exit;
@@ -2014,10 +2100,18 @@ row_merge_read_clustered_index(
 end_of_index:
 					row = NULL;
 					mtr_commit(&mtr);
+					err = row_merge_spatial_rows(
+						trx->id, sp_tuples,
+						num_spatial,
+						row_heap, sp_heap,
+						&pcur, &mtr, true);
 					mem_heap_free(row_heap);
 					row_heap = NULL;
 					ut_free(nonnull);
 					nonnull = NULL;
+					if (err != DB_SUCCESS) {
+						goto func_exit;
+					}
 					goto write_buffers;
 				}
 			} else {
@@ -2374,9 +2468,12 @@ row_merge_read_clustered_index(
 
 				/* Set the page flush observer for the
 				transaction when buffering the very first
-				record for a non-redo-logged operation. */
+				record for a non-redo-logged operation.
+				The changed page tracking only sees
+				pages that are written to the redo log. */
 				if (file->n_rec == 0 && i == 0
-				    && innodb_log_optimize_ddl) {
+				    && innodb_log_optimize_ddl
+				    && !srv_track_changed_pages) {
 					trx->set_flush_observer(
 						new_table->space, stage);
 				}
@@ -2473,22 +2570,6 @@ row_merge_read_clustered_index(
 					/* Temporary File is not used.
 					so insert sorted block to the index */
 					if (row != NULL) {
-						/* We have to do insert the
-						cached spatial index rows, since
-						after the mtr_commit, the cluster
-						index page could be updated, then
-						the data in cached rows become
-						invalid. */
-						err = row_merge_spatial_rows(
-							trx->id, sp_tuples,
-							num_spatial,
-							row_heap, sp_heap,
-							&pcur, &mtr);
-
-						if (err != DB_SUCCESS) {
-							goto func_exit;
-						}
-
 						/* We are not at the end of
 						the scan yet. We must
 						mtr_commit() in order to be
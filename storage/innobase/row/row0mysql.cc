@@ -1560,9 +1560,9 @@ row_insert_for_mysql(
 	que_thr_stop_for_mysql_no_error(thr, trx);
 
 	if (table->is_system_db) {
-		srv_stats.n_system_rows_inserted.inc(size_t(trx->id));
+		srv_stats.n_system_rows_inserted.inc();
 	} else {
-		srv_stats.n_rows_inserted.inc(size_t(trx->id));
+		srv_stats.n_rows_inserted.inc();
 	}
 
 	/* Not protected by dict_table_stats_lock() for performance
@@ -1942,17 +1942,17 @@ row_update_for_mysql(row_prebuilt_t* prebuilt)
 		dict_table_n_rows_dec(prebuilt->table);
 
 		if (table->is_system_db) {
-			srv_stats.n_system_rows_deleted.inc(size_t(trx->id));
+			srv_stats.n_system_rows_deleted.inc();
 		} else {
-			srv_stats.n_rows_deleted.inc(size_t(trx->id));
+			srv_stats.n_rows_deleted.inc();
 		}
 
 		update_statistics = !srv_stats_include_delete_marked;
 	} else {
 		if (table->is_system_db) {
-			srv_stats.n_system_rows_updated.inc(size_t(trx->id));
+			srv_stats.n_system_rows_updated.inc();
 		} else {
-			srv_stats.n_rows_updated.inc(size_t(trx->id));
+			srv_stats.n_rows_updated.inc();
 		}
 
 		update_statistics
@@ -2201,8 +2201,7 @@ static dberr_t row_update_vers_insert(que_thr_t* thr, upd_node_t* node)
 			goto exit;
 
 		case DB_SUCCESS:
-			srv_stats.n_rows_inserted.inc(
-				static_cast<size_t>(trx->id));
+			srv_stats.n_rows_inserted.inc();
 			dict_stats_update_if_needed(table, trx->mysql_thd);
 			goto exit;
 		}
@@ -2288,11 +2287,11 @@ row_update_cascade_for_mysql(
 				dict_table_n_rows_dec(node->table);
 
 				stats = !srv_stats_include_delete_marked;
-				srv_stats.n_rows_deleted.inc(size_t(trx->id));
+				srv_stats.n_rows_deleted.inc();
 			} else {
 				stats = !(node->cmpl_info
 					  & UPD_NODE_NO_ORD_CHANGE);
-				srv_stats.n_rows_updated.inc(size_t(trx->id));
+				srv_stats.n_rows_updated.inc();
 			}
 
 			if (stats) {
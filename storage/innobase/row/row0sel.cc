@@ -3686,6 +3686,39 @@ row_sel_dequeue_cached_row_for_mysql(
 	}
 }
 
+/** Pop the rows of a cursor from its prefetch cache, without searching
+the index.
+@param[out]	buf		buffer for at most n rows in MySQL format
+@param[in]	rec_len		distance of the rows in buf
+@param[in]	n		maximum number of rows to pop
+@param[in]	direction	ROW_SEL_NEXT or ROW_SEL_PREV
+@param[in,out]	prebuilt	prebuilt struct for the table handler
+@return number of rows copied to buf; 0 if the cache is empty or it
+was filled while moving in the other direction */
+ulint
+row_search_pop_cached(
+	byte*		buf,
+	ulint		rec_len,
+	ulint		n,
+	ulint		direction,
+	row_prebuilt_t*	prebuilt)
+{
+	ulint	n_popped = 0;
+
+	if (prebuilt->n_rows_fetched == 0
+	    || direction != prebuilt->fetch_direction) {
+		return(0);
+	}
+
+	for (; n_popped < n && prebuilt->n_fetch_cached > 0; n_popped++) {
+		row_sel_dequeue_cached_row_for_mysql(
+			buf + n_popped * rec_len, prebuilt);
+		prebuilt->n_rows_fetched++;
+	}
+
+	return(n_popped);
+}
+
 /********************************************************************//**
 Initialise the prefetch cache. */
 UNIV_INLINE
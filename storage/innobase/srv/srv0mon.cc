@@ -85,6 +85,21 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_TABLE_REFERENCE},
 
+	{"metadata_table_definitions_loaded", "metadata",
+	 "Number of table definitions loaded into the data dictionary cache",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_TABLE_LOAD},
+
+	{"metadata_tablespace_files_opened", "metadata",
+	 "Number of tablespace data files opened",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_TABLESPACE_OPEN},
+
+	{"metadata_tablespace_files_closed", "metadata",
+	 "Number of tablespace data files closed",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_TABLESPACE_CLOSE},
+
 	/* ========== Counters for Lock Module ========== */
 	{"module_lock", "lock", "Lock Module",
 	 MONITOR_MODULE,
@@ -960,6 +975,12 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_PAGE_DECOMPRESS},
 
+	{"compress_pages_skipped", "compression",
+	 "Number of page compressions skipped because they"
+	 " were predicted to fail",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_PAGE_COMPRESS_SKIPPED},
+
 	{"compression_pad_increments", "compression",
 	 "Number of times padding is incremented to avoid compression failures",
 	 MONITOR_NONE,
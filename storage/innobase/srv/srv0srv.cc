@@ -176,6 +176,18 @@ static os_event_t	srv_master_thread_disabled_event;
 
 /*------------------------- LOG FILES ------------------------ */
 char*	srv_log_group_home_dir;
+/** Directory where a copy of every redo log block is archived,
+or NULL if innodb_log_archive_dir is not set */
+char*	srv_log_archive_dir;
+/** Number of seconds after the last write of a redo log archive segment
+when it is deleted, or 0 to keep the segments */
+ulong	srv_log_archive_expire_sec;
+/** innodb_track_changed_pages: whether to write changed page bitmaps
+for incremental backups */
+my_bool	srv_track_changed_pages;
+/** Number of seconds after the last write of a changed page bitmap file
+when it is deleted, or 0 to keep the files */
+ulong	srv_track_changed_pages_expire_sec;
 
 ulong	srv_n_log_files;
 /** The InnoDB redo log file size, or 0 when changing the redo log format
@@ -2157,7 +2169,13 @@ srv_master_do_active_tasks(void)
 		return;
 	}
 
-	if (cur_time % SRV_MASTER_DICT_LRU_INTERVAL == 0) {
+	/* Besides the periodic check, enforce the dict cache limit as
+	soon as the LRU list has grown clearly beyond it, so that the
+	memory used by the cache stays bounded. The length is read
+	without holding dict_sys->mutex; it is only a hint. */
+	if (cur_time % SRV_MASTER_DICT_LRU_INTERVAL == 0
+	    || UT_LIST_GET_LEN(dict_sys->table_LRU)
+	    > innobase_get_table_cache_size() * 9 / 8) {
 		srv_main_thread_op_info = "enforcing dict cache limit";
 		ulint	n_evicted = srv_master_evict_from_table_cache(50);
 		if (n_evicted != 0) {
@@ -2521,6 +2539,7 @@ srv_do_purge(ulint* n_total_purged)
 	static ulint	count = 0;
 	static ulint	n_use_threads = 0;
 	static uint32_t	rseg_history_len = 0;
+	static bool	caught_up = false;
 	ulint		old_activity_count = srv_get_activity_count();
 	const ulint	n_threads = srv_n_purge_threads;
 
@@ -2571,11 +2590,23 @@ srv_do_purge(ulint* n_total_purged)
 			break;
 		}
 
+		/* Besides every innodb_purge_rseg_truncate_frequency
+		batches, free the purged undo log segments once purge has
+		caught up with the history. Their pages can then be reused
+		by new transactions right away, instead of the undo
+		tablespaces growing until the next periodic truncation,
+		which may be a long time away once purge has gone idle.
+		A batch stops after innodb_purge_batch_size undo log pages
+		unless it runs out of history first, so a shorter batch
+		means that purge caught up. The history list length counts
+		undo logs, not pages, and cannot tell that in advance. */
 		n_pages_purged = trx_purge(
 			n_use_threads,
 			!(++count % srv_purge_rseg_truncate_frequency)
-			|| purge_sys.truncate.current);
+			|| purge_sys.truncate.current
+			|| caught_up);
 
+		caught_up = n_pages_purged < srv_purge_batch_size;
 		*n_total_purged += n_pages_purged;
 	} while (n_pages_purged > 0 && !purge_sys.paused()
 		 && !srv_purge_should_exit());
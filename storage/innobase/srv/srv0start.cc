@@ -63,6 +63,8 @@ Created 2/16/1996 Heikki Tuuri
 #include "mtr0mtr.h"
 #include "log0crypt.h"
 #include "log0recv.h"
+#include "log0online.h"
+#include "log0arch.h"
 #include "page0page.h"
 #include "page0cur.h"
 #include "trx0trx.h"
@@ -1516,6 +1518,8 @@ dberr_t srv_start(bool create_new_db)
 
 	log_sys.create();
 	recv_sys_init();
+	log_online_init();
+	log_archive_init();
 	lock_sys.create(srv_lock_table_size);
 
 	/* Create i/o-handler threads: */
@@ -1836,6 +1840,8 @@ dberr_t srv_start(bool create_new_db)
 		if (err != DB_SUCCESS) {
 			return(srv_init_abort(err));
 		}
+
+		log_online_start(log_sys.last_checkpoint_lsn);
 	} else {
 		/* We always try to do a recovery, even if the database had
 		been shut down normally: this is the normal startup path */
@@ -1848,6 +1854,8 @@ dberr_t srv_start(bool create_new_db)
 			return(srv_init_abort(err));
 		}
 
+		log_online_start(log_sys.last_checkpoint_lsn);
+
 		switch (srv_operation) {
 		case SRV_OPERATION_NORMAL:
 		case SRV_OPERATION_RESTORE_EXPORT:
@@ -2151,6 +2159,10 @@ dberr_t srv_start(bool create_new_db)
 	ut_ad(err == DB_SUCCESS);
 	ut_a(sum_of_new_sizes != ULINT_UNDEFINED);
 
+	/* The redo log will not be rebuilt any more. */
+	log_online_create_thread();
+	log_archive_create_thread();
+
 	/* Create the doublewrite buffer to a new tablespace */
 	if (!srv_read_only_mode && srv_force_recovery < SRV_FORCE_NO_TRX_UNDO
 	    && !buf_dblwr_create()) {
@@ -2497,6 +2509,8 @@ void innodb_shutdown()
 	if (ibuf) {
 		ibuf_close();
 	}
+	log_online_close();
+	log_archive_close();
 	log_sys.close();
 	purge_sys.close();
 	trx_sys.close();
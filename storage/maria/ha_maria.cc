@@ -2532,6 +2532,32 @@ int ha_maria::rnd_next(uchar *buf)
 }
 
 
+/*
+  Read the next rows of a table scan with one call of maria_scan_batch()
+  per run of rows that are not deleted
+*/
+
+int ha_maria::rnd_next_batch(uchar *buf, uint max_rows, uint *rows)
+{
+  size_t reclength= table->s->reclength;
+  uint count;
+  int error;
+
+  *rows= 0;
+  while ((error= maria_scan_batch(file, buf + *rows * reclength, reclength,
+                                  max_rows - *rows, &count)) ==
+         HA_ERR_RECORD_DELETED)
+  {
+    *rows+= count;
+    status_var_increment(table->in_use->status_var.ha_read_rnd_deleted_count);
+    if (table->in_use->check_killed(1))
+      return HA_ERR_ABORTED_BY_USER;
+  }
+  *rows+= count;
+  return error;
+}
+
+
 int ha_maria::remember_rnd_pos()
 {
   return (*file->s->scan_remember_pos)(file, &remember_pos);
@@ -108,6 +108,7 @@ class ha_maria :public handler
   int rnd_init(bool scan);
   int rnd_end(void);
   int rnd_next(uchar * buf);
+  int rnd_next_batch(uchar *buf, uint max_rows, uint *rows);
   int rnd_pos(uchar * buf, uchar * pos);
   int remember_rnd_pos();
   int restart_rnd_next(uchar * buf);
@@ -55,6 +55,42 @@ int maria_scan(MARIA_HA *info, uchar *record)
 }
 
 
+/*
+  Read the next rows of a scan
+
+  SYNOPSIS
+    maria_scan_batch()
+    info		Maria handler
+    buf			Read the rows here, reclength bytes apart
+    reclength		Distance of the rows in buf
+    max_rows		Maximum number of rows to read
+    rows		OUT: Number of rows read
+
+  RETURN
+    0  			   max_rows rows were read
+    HA_ERR_END_OF_FILE     End of file
+    HA_ERR_RECORD_DELETED  Record was deleted (can only happen for static rec)
+    #			   Error code
+*/
+
+int maria_scan_batch(MARIA_HA *info, uchar *buf, size_t reclength,
+                     uint max_rows, uint *rows)
+{
+  int error= 0;
+  int (*scan)(MARIA_HA *, uchar *, MARIA_RECORD_POS, my_bool)= info->s->scan;
+  DBUG_ENTER("maria_scan_batch");
+
+  for (*rows= 0; *rows < max_rows; (*rows)++)
+  {
+    info->update&= (HA_STATE_CHANGED | HA_STATE_ROW_CHANGED);
+    if ((error= (*scan)(info, buf + *rows * reclength,
+                        info->cur_row.nextpos, 1)))
+      break;
+  }
+  DBUG_RETURN(error);
+}
+
+
 void maria_scan_end(MARIA_HA *info)
 {
   (*info->s->scan_end)(info);
@@ -0,0 +1,195 @@
+/* Copyright (C) 2019 MariaDB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <tap.h>
+#include "loser_tree.h"
+
+/*
+  A sorted stream of keys. The keys are numbers stored big endian, so
+  that they order as byte strings, followed by a byte that is compared
+  only by some of the tests and by the number of the stream.
+*/
+
+#define KEY_LENGTH 10
+#define MAX_STREAMS 20
+#define MAX_KEYS 50
+
+struct Stream
+{
+  uchar *key;
+  uchar *end;
+  uchar keys[MAX_KEYS * KEY_LENGTH];
+};
+
+static Stream streams[MAX_STREAMS];
+
+static int cmp_keys(void *arg, uchar *a, uchar *b)
+{
+  return memcmp(*(uchar**) a, *(uchar**) b, *(uint*) arg);
+}
+
+/* Fill the streams with keys that often share the first 8 bytes */
+
+static void fill_streams(uint count, bool descending)
+{
+  for (uint i= 0; i < count; i++)
+  {
+    Stream *stream= streams + i;
+    uint keys= (uint) (rand() % MAX_KEYS);
+    ulonglong nr= 0;
+    uchar *pos= stream->keys;
+    uchar next_byte= 0;
+    for (uint k= 0; k < keys; k++, pos+= KEY_LENGTH)
+    {
+      uint step= rand() % 3;
+      ulonglong value;
+      nr+= step;
+      value= descending ? ~nr : nr;
+      for (uint b= 0; b < 8; b++)
+        pos[b]= (uchar) (value >> ((7 - b) * 8));
+      /* Repeat the key if the number does not change */
+      if (step)
+        next_byte= (uchar) (rand() % 2);
+      pos[8]= next_byte;
+      pos[9]= (uchar) i;
+    }
+    stream->key= stream->keys;
+    stream->end= pos;
+  }
+}
+
+
+/*
+  Check that a key comes after the last one: in the order of the first
+  cmp_length bytes, and in the order of the streams for equal keys
+*/
+
+static bool in_order(const uchar *last, const uchar *key, uint cmp_length,
+                     bool max_at_top)
+{
+  int res= memcmp(last, key, cmp_length);
+  if (max_at_top)
+    res= -res;
+  return res < 0 ||
+         (res == 0 && last[KEY_LENGTH - 1] <= key[KEY_LENGTH - 1]);
+}
+
+
+/* Merge the streams and check the order of the keys */
+
+static void test_merge(uint count, uint cmp_length, bool use_prefix,
+                       bool max_at_top)
+{
+  Loser_tree tree;
+  uint total= 0, merged= 0;
+  bool sorted= TRUE;
+  uchar last[KEY_LENGTH];
+
+  fill_streams(count, max_at_top);
+  tree.init(count, offsetof(Stream, key), max_at_top, cmp_keys, &cmp_length,
+            use_prefix ? cmp_length : 0);
+  for (uint i= 0; i < count; i++)
+  {
+    total+= (uint) (streams[i].end - streams[i].keys) / KEY_LENGTH;
+    if (streams[i].key != streams[i].end)
+      tree.insert((uchar*) (streams + i));
+  }
+  while (tree.elements())
+  {
+    Stream *top= (Stream*) tree.top();
+    if (merged && !in_order(last, top->key, cmp_length, max_at_top))
+      sorted= FALSE;
+    memcpy(last, top->key, KEY_LENGTH);
+    merged++;
+    if ((top->key+= KEY_LENGTH) == top->end)
+      tree.remove_top();
+    else
+      tree.replace_top();
+  }
+  ok(sorted && merged == total,
+     "merge of %u streams, key %u, prefix %d, max_at_top %d", count,
+     cmp_length, (int) use_prefix, (int) max_at_top);
+}
+
+
+/* Streams are added while the merge goes on, reusing removed leaves */
+
+static void test_insert()
+{
+  Loser_tree tree;
+  uint cmp_length= KEY_LENGTH;
+  uint merged= 0, added= 0;
+  bool sorted= TRUE;
+  uchar last[KEY_LENGTH];
+
+  fill_streams(MAX_STREAMS, FALSE);
+  tree.init(4, offsetof(Stream, key), 0, cmp_keys, &cmp_length, KEY_LENGTH);
+  while (added < MAX_STREAMS && tree.elements() < 4)
+  {
+    Stream *stream= streams + added++;
+    if (stream->key != stream->end)
+      tree.insert((uchar*) stream);
+  }
+  while (tree.elements())
+  {
+    Stream *top= (Stream*) tree.top();
+    if (merged && !in_order(last, top->key, cmp_length, FALSE))
+      sorted= FALSE;
+    memcpy(last, top->key, KEY_LENGTH);
+    merged++;
+    if ((top->key+= KEY_LENGTH) != top->end)
+    {
+      tree.replace_top();
+      continue;
+    }
+    tree.remove_top();
+    /* Add a stream from the keys that are not less than the last one */
+    while (added < MAX_STREAMS)
+    {
+      Stream *stream= streams + added++;
+      while (stream->key != stream->end &&
+             memcmp(stream->key, last, KEY_LENGTH) < 0)
+        stream->key+= KEY_LENGTH;
+      if (stream->key != stream->end)
+      {
+        tree.insert((uchar*) stream);
+        break;
+      }
+    }
+  }
+  ok(sorted && added == MAX_STREAMS, "merge with streams added, %u keys",
+     merged);
+}
+
+
+int main(int argc __attribute__((unused)),char *argv[])
+{
+  MY_INIT(argv[0]);
+  plan(MAX_STREAMS * 4 + 1);
+
+  for (uint count= 1; count <= MAX_STREAMS; count++)
+  {
+    test_merge(count, KEY_LENGTH - 1, FALSE, FALSE);
+    test_merge(count, KEY_LENGTH - 1, TRUE, FALSE);
+    test_merge(count, 8, TRUE, FALSE);
+    test_merge(count, KEY_LENGTH - 1, TRUE, TRUE);
+  }
+  test_insert();
+
+  my_end(0);
+  return exit_status();
+}
@@ -445,10 +445,104 @@ void mdev10963()
   my_delete(file_name, MYF(MY_WME));
 }
 
+/* Byte i of the file written by async_io_cache() */
+static uchar pattern(my_off_t i, uchar round)
+{
+  return (uchar) (i % 251 + round);
+}
+
+static int pattern_bad(const uchar *buf, size_t len, my_off_t pos,
+                       uchar round)
+{
+  for (size_t i= 0; i < len; i++)
+    if (buf[i] != pattern(pos + i, round))
+      return 1;
+  return 0;
+}
+
+static int write_pattern(size_t total, uchar round)
+{
+  uchar buf[CACHE_SIZE];
+  size_t chunk= 1;
+  for (size_t done= 0; done < total; done+= chunk)
+  {
+    my_off_t pos= my_b_tell(&info);
+    chunk= MY_MIN(total - done, (chunk * 7 + 13) % sizeof(buf) + 1);
+    for (size_t i= 0; i < chunk; i++)
+      buf[i]= pattern(pos + i, round);
+    if (my_b_write(&info, buf, chunk))
+      return 1;
+  }
+  return 0;
+}
+
+static int read_pattern(size_t total, uchar round)
+{
+  uchar buf[CACHE_SIZE * 3];
+  size_t chunk= 1;
+  for (size_t done= 0; done < total; done+= chunk)
+  {
+    my_off_t pos= my_b_tell(&info);
+    chunk= MY_MIN(total - done, (chunk * 11 + 5) % sizeof(buf) + 1);
+    if (my_b_read(&info, buf, chunk) || pattern_bad(buf, chunk, pos, round))
+      return 1;
+  }
+  return 0;
+}
+
+/* Read ahead and write behind in a background thread */
+
+void async_io_cache()
+{
+  int res;
+  const size_t total= CACHE_SIZE * 9 + 123;
+  const my_off_t rewrite_pos= CACHE_SIZE * 2 + 5;
+  uchar buf[100];
+
+  diag("temp io_cache with MY_ASYNC_IO");
+
+  res= open_cached_file(&info, 0, 0, CACHE_SIZE, MYF(MY_ASYNC_IO));
+  ok(res == 0 && info.async, "open_cached_file" INFO_TAIL);
+
+  res= write_pattern(total, 0);
+  ok(res == 0 && my_b_tell(&info) == total, "writes" INFO_TAIL);
+
+  res= my_b_flush_io_cache(&info, 1);
+  ok(res == 0, "flush" INFO_TAIL);
+
+  res= (int) my_pread(info.file, buf, sizeof(buf), CACHE_SIZE * 8,
+                      MYF(MY_NABP)) ||
+       pattern_bad(buf, sizeof(buf), CACHE_SIZE * 8, 0);
+  ok(res == 0, "file is written after flush");
+
+  res= reinit_io_cache(&info, READ_CACHE, 0, 0, 0);
+  ok(res == 0, "reinit READ_CACHE" INFO_TAIL);
+
+  res= read_pattern(total, 0);
+  ok(res == 0, "reads" INFO_TAIL);
+
+  res= my_b_read(&info, buf, 1);
+  ok(res == 1 && info.error == 0, "read at end of file" INFO_TAIL);
+
+  res= reinit_io_cache(&info, WRITE_CACHE, rewrite_pos, 0, 0);
+  ok(res == 0, "reinit WRITE_CACHE" INFO_TAIL);
+
+  res= write_pattern(total - rewrite_pos, 1);
+  ok(res == 0, "rewrite" INFO_TAIL);
+
+  res= reinit_io_cache(&info, READ_CACHE, 0, 0, 0);
+  ok(res == 0, "reinit READ_CACHE" INFO_TAIL);
+
+  res= read_pattern(rewrite_pos, 0) || read_pattern(total - rewrite_pos, 1);
+  ok(res == 0, "reads after rewrite" INFO_TAIL);
+
+  close_cached_file(&info);
+}
+
 int main(int argc __attribute__((unused)),char *argv[])
 {
   MY_INIT(argv[0]);
-  plan(277);
+  plan(288);
 
   /* temp files with and without encryption */
   encrypt_tmp_files= 1;
@@ -468,6 +562,8 @@ int main(int argc __attribute__((unused)),char *argv[])
   mdev17133();
   mdev10963();
 
+  async_io_cache();
+
   my_end(0);
   return exit_status();
 }